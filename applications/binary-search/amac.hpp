@@ -0,0 +1,159 @@
+// amac.hpp
+// Interleaved binary search as a step machine.
+//
+// The search of state_machine.hpp, expressed as a step machine (see
+// libcoro/amac.hpp) such that the very same search may be executed
+// sequentially, by the AMAC engine of libcoro, or as coroutines on the
+// scheduler of coro_infra.hpp; the three executions then differ only
+// in the means by which the searches are interleaved, and so measure
+// the cost of that alone.
+
+#ifndef AMAC_BS_HPP
+#define AMAC_BS_HPP
+
+#include <vector>
+#include <cstddef>
+
+#include <libcoro/amac.hpp>
+
+#include "coro_infra.hpp"
+
+// Counts the keys of a sorted dataset found amongst the lookups.
+struct BinarySearchMachine
+{
+    struct state_type
+    {
+        int const* first  = nullptr;
+        int const* middle = nullptr;
+
+        std::size_t len  = 0;
+        std::size_t half = 0;
+
+        int  val   = 0;
+        bool found = false;
+    };
+
+    int const* const first;
+    int const* const last;
+
+    // the number of keys found amongst all lookups
+    std::size_t n_found = 0;
+
+    auto start(state_type& s, int const key) const -> void const*
+    {
+        s.val   = key;
+        s.first = first;
+        s.len   = static_cast<std::size_t>(last - first);
+        s.found = false;
+
+        if (0 == s.len)
+        {
+            return nullptr;
+        }
+
+        s.half   = s.len / 2;
+        s.middle = s.first + s.half;
+        return s.middle;
+    }
+
+    auto step(state_type& s) const -> void const*
+    {
+        auto const x = *s.middle;
+        if (x < s.val)
+        {
+            s.first = s.middle;
+            ++s.first;
+            s.len = s.len - s.half - 1;
+        }
+        else
+        {
+            s.len = s.half;
+        }
+
+        if (x == s.val)
+        {
+            s.found = true;
+            return nullptr;
+        }
+
+        if (s.len > 0)
+        {
+            s.half   = s.len / 2;
+            s.middle = s.first + s.half;
+            return s.middle;
+        }
+
+        return nullptr;
+    }
+
+    void finish(state_type const& s)
+    {
+        n_found += static_cast<std::size_t>(s.found);
+    }
+};
+
+// Perform the operation of `machine` on `input`, suspending on the
+// prefetch of each address that the operation touches; the input is
+// taken by value, such that it may be drawn from a temporary.
+template <typename Machine, typename Input>
+    requires coro::step_machine<Machine, Input const&>
+root_task coro_step(Machine& machine, Input const input)
+{
+    typename Machine::state_type state{};
+
+    auto const* next = static_cast<void const*>(machine.start(state, input));
+    while (next != nullptr)
+    {
+        co_await prefetch(*static_cast<char const*>(next));
+        next = machine.step(state);
+    }
+
+    machine.finish(state);
+}
+
+// Search for `lookups` in `dataset` one at a time, via the step machine;
+// returns the number found.
+std::size_t step_multi_lookup(
+    std::vector<int> const& dataset,
+    std::vector<int> const& lookups)
+{
+    BinarySearchMachine machine{dataset.data(), dataset.data() + dataset.size()};
+    coro::run_sequential(machine, lookups.begin(), lookups.end());
+    return machine.n_found;
+}
+
+// Search for `lookups` in `dataset` with up to `n_streams` searches in
+// flight at once in the ring of the AMAC engine; returns the number found.
+std::size_t amac_multi_lookup(
+    std::vector<int> const& dataset,
+    std::vector<int> const& lookups,
+    std::size_t const       n_streams)
+{
+    BinarySearchMachine machine{dataset.data(), dataset.data() + dataset.size()};
+    coro::run_amac(machine, lookups.begin(), lookups.end(), n_streams);
+    return machine.n_found;
+}
+
+// Search for `lookups` in `dataset` with up to `n_streams` searches in
+// flight at once, each a coroutine that steps the machine; returns the
+// number found.
+std::size_t coro_step_multi_lookup(
+    std::vector<int> const& dataset,
+    std::vector<int> const& lookups,
+    std::size_t const       n_streams)
+{
+    BinarySearchMachine machine{dataset.data(), dataset.data() + dataset.size()};
+
+    throttler t{n_streams};
+
+    for (auto const key : lookups)
+    {
+        t.spawn(coro_step(machine, key));
+    }
+
+    t.run();
+
+    return machine.n_found;
+}
+
+#endif // AMAC_BS_HPP
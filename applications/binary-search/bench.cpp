@@ -1,14 +1,21 @@
 // bench.cpp
 
 #include "benchmark/benchmark.h"
+#include "libbench/key_streams.hpp"
+#include "libbench/perf_counters.hpp"
 
 #include <chrono>
 #include <vector>
+#include <cstdint>
+#include <algorithm>
 
-#include "rng.hpp"
+#include "amac.hpp"
 #include "vanilla.hpp"
 #include "coroutine.hpp"
+#include "eytzinger.hpp"
 #include "state_machine.hpp"
+#include "static_bplus_tree.hpp"
+#include "interleaved_search.hpp"
 
 // seed for the random number generator
 constexpr static unsigned int const RNG_SEED = 1;
@@ -24,6 +31,11 @@ constexpr static auto const MAX_DATASET_SIZE =  16 * (1 << 20);  // 16MB (exceed
 constexpr static auto const MIN_N_STREAMS = 1;
 constexpr static auto const MAX_N_STREAMS = 32;
 
+// the bounds for the distribution of the lookup keys; keys that collide
+// in their low-order bits are of no consequence to a binary search
+constexpr static auto const MIN_DISTRIBUTION = static_cast<std::int64_t>(bench::key_distribution::sequential);
+constexpr static auto const MAX_DISTRIBUTION = static_cast<std::int64_t>(bench::key_distribution::hotspot);
+
 [[nodiscard]]
 static std::vector<int> generate_dataset(
     std::size_t const dataset_size)
@@ -40,13 +52,16 @@ static std::vector<int> generate_dataset(
 
 [[nodiscard]]
 static std::vector<int> generate_lookups(
-    std::size_t const  dataset_size, 
-    std::size_t const  n_lookups,
-    unsigned int const seed)
+    std::size_t const             dataset_size, 
+    std::size_t const             n_lookups,
+    unsigned int const            seed,
+    bench::key_distribution const distribution)
 {
+    // the dataset holds the even keys in [0, 2*dataset_size),
+    // such that half of the lookup keys are not found
     std::vector<int> lookups{};
     lookups.reserve(n_lookups);
-    for (auto i : rng<int>{seed, 0, static_cast<int>(dataset_size*2), n_lookups})
+    for (auto i : bench::lookup_keys<int>(distribution, n_lookups, dataset_size*2, seed))
     {
         lookups.push_back(i);
     }
@@ -54,6 +69,54 @@ static std::vector<int> generate_lookups(
     return lookups;
 }
 
+// Check the number of `lookups` found by a search against that found by
+// vanilla_binary_search() in `dataset` before the search is timed, such
+// that an error in the index arithmetic of a search fails the benchmark
+// rather than being measured; returns `false` if the benchmark is skipped.
+static bool verify_hits(
+    benchmark::State&       state,
+    std::size_t const       n_found,
+    std::vector<int> const& dataset,
+    std::vector<int> const& lookups)
+{
+    std::size_t expected = 0;
+    for (auto const key : lookups)
+    {
+        expected += static_cast<std::size_t>(
+            vanilla_binary_search(dataset.begin(), dataset.end(), key));
+    }
+
+    if (n_found != expected)
+    {
+        state.SkipWithError("search disagrees with vanilla_binary_search()");
+        return false;
+    }
+
+    return true;
+}
+
+// Check the positions computed by a lower bound search against those of
+// std::lower_bound(); returns `false` if the benchmark is skipped.
+template <typename T>
+static bool verify_positions(
+    benchmark::State&               state,
+    std::vector<std::size_t> const& positions,
+    std::vector<T> const&           dataset,
+    std::vector<T> const&           lookups)
+{
+    for (auto i = 0ul; i < lookups.size(); ++i)
+    {
+        auto const expected = std::lower_bound(dataset.begin(), dataset.end(), lookups[i]) - dataset.begin();
+        if (positions[i] != static_cast<std::size_t>(expected))
+        {
+            state.SkipWithError("search disagrees with std::lower_bound()");
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // a vanilla binary search, without multi-lookup support
 static void test_vanilla(
     std::vector<int> const& dataset, 
@@ -62,11 +125,15 @@ static void test_vanilla(
     auto const beg = dataset.begin();
     auto const end = dataset.end();
     
-    // perform a search on the dataset for each key in lookups
+    // perform a search on the dataset for each key in lookups;
+    // count the hits, such that the searches are not optimized away
+    std::size_t n_found = 0;
     for (int key : lookups)
     {
-        vanilla_binary_search(beg, end, key);
+        n_found += static_cast<std::size_t>(vanilla_binary_search(beg, end, key));
     }
+
+    benchmark::DoNotOptimize(n_found);
 }
 
 static void BM_vanilla(benchmark::State& state)
@@ -74,23 +141,30 @@ static void BM_vanilla(benchmark::State& state)
     using hr_clock = std::chrono::high_resolution_clock;
 
     auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(1));
 
     auto const dataset = generate_dataset(dataset_size);
-    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    bench::perf_counters counters{};
 
     for (auto _ : state)
     {
+        counters.start();
         auto const start = hr_clock::now();
 
         test_vanilla(dataset, lookups);
 
         auto const stop = hr_clock::now();
+        counters.stop();
         auto const elapsed = std::chrono::duration_cast<
             std::chrono::duration<double>>(stop - start);
 
         state.SetIterationTime(elapsed.count());
         state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
     }
+
+    counters.report(state, N_LOOKUPS);
 }
 
 // a multi-lookup test implemented via hand-crafted state machine
@@ -108,23 +182,35 @@ static void BM_state_machine(benchmark::State& state)
 
     auto const dataset_size = static_cast<std::size_t>(state.range(0));
     auto const n_streams    = static_cast<std::size_t>(state.range(1));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(2));
 
     auto const dataset = generate_dataset(dataset_size);
-    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    if (!verify_hits(state, state_machine_multi_lookup(dataset, lookups, n_streams), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
 
     for (auto _ : state)
     {
+        counters.start();
         auto const start = hr_clock::now();
 
         test_state_machine(dataset, lookups, n_streams);
 
         auto const stop = hr_clock::now();
+        counters.stop();
         auto const elapsed = std::chrono::duration_cast<
             std::chrono::duration<double>>(stop - start);
 
         state.SetIterationTime(elapsed.count());
         state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
     }
+
+    counters.report(state, N_LOOKUPS);
 }
 
 // a multi-lookup test implemented via coroutines
@@ -142,27 +228,487 @@ static void BM_coroutine(benchmark::State& state)
 
     auto const dataset_size = static_cast<std::size_t>(state.range(0));
     auto const n_streams    = static_cast<std::size_t>(state.range(1));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(2));
 
     auto const dataset = generate_dataset(dataset_size);
-    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    if (!verify_hits(state, coro_multi_lookup(dataset, lookups, n_streams), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
 
     for (auto _ : state)
     {
+        counters.start();
         auto const start = hr_clock::now();
 
         test_coroutine(dataset, lookups, n_streams);
 
         auto const stop = hr_clock::now();
+        counters.stop();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(elapsed.count());
+        state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
+    }
+
+    counters.report(state, N_LOOKUPS);
+}
+
+// a search of the Eytzinger layout, prefetching several levels ahead
+static void test_eytzinger(
+    EytzingerIndex<int> const& index, 
+    std::vector<int> const&    lookups) 
+{
+    benchmark::DoNotOptimize(eytzinger_multi_lookup(index, lookups));
+}
+
+static void BM_eytzinger(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(1));
+
+    auto const dataset = generate_dataset(dataset_size);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    EytzingerIndex<int> const index{dataset};
+
+    if (!verify_hits(state, eytzinger_multi_lookup(index, lookups), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
+
+    for (auto _ : state)
+    {
+        counters.start();
+        auto const start = hr_clock::now();
+
+        test_eytzinger(index, lookups);
+
+        auto const stop = hr_clock::now();
+        counters.stop();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(elapsed.count());
+        state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
+    }
+
+    counters.report(state, N_LOOKUPS);
+}
+
+// a multi-lookup of the Eytzinger layout via coroutines
+static void test_eytzinger_coroutine(
+    EytzingerIndex<int> const& index, 
+    std::vector<int> const&    lookups, 
+    std::size_t const          n_streams)
+{
+    benchmark::DoNotOptimize(coro_eytzinger_multi_lookup(index, lookups, n_streams));
+}
+
+static void BM_eytzinger_coroutine(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const n_streams    = static_cast<std::size_t>(state.range(1));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(2));
+
+    auto const dataset = generate_dataset(dataset_size);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    EytzingerIndex<int> const index{dataset};
+
+    if (!verify_hits(state, coro_eytzinger_multi_lookup(index, lookups, n_streams), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
+
+    for (auto _ : state)
+    {
+        counters.start();
+        auto const start = hr_clock::now();
+
+        test_eytzinger_coroutine(index, lookups, n_streams);
+
+        auto const stop = hr_clock::now();
+        counters.stop();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(elapsed.count());
+        state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
+    }
+
+    counters.report(state, N_LOOKUPS);
+}
+
+// a search of the static B+-tree, one cache line per level
+static void test_bplus_tree(
+    StaticBPlusTree<int> const& index, 
+    std::vector<int> const&     lookups) 
+{
+    benchmark::DoNotOptimize(bplus_tree_multi_lookup(index, lookups));
+}
+
+static void BM_bplus_tree(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(1));
+
+    auto const dataset = generate_dataset(dataset_size);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    StaticBPlusTree<int> const index{dataset};
+
+    if (!verify_hits(state, bplus_tree_multi_lookup(index, lookups), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
+
+    for (auto _ : state)
+    {
+        counters.start();
+        auto const start = hr_clock::now();
+
+        test_bplus_tree(index, lookups);
+
+        auto const stop = hr_clock::now();
+        counters.stop();
         auto const elapsed = std::chrono::duration_cast<
             std::chrono::duration<double>>(stop - start);
 
         state.SetIterationTime(elapsed.count());
         state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
     }
+
+    counters.report(state, N_LOOKUPS);
+}
+
+// a multi-lookup of the static B+-tree via coroutines
+static void test_bplus_tree_coroutine(
+    StaticBPlusTree<int> const& index, 
+    std::vector<int> const&     lookups, 
+    std::size_t const           n_streams)
+{
+    benchmark::DoNotOptimize(coro_bplus_tree_multi_lookup(index, lookups, n_streams));
+}
+
+static void BM_bplus_tree_coroutine(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const n_streams    = static_cast<std::size_t>(state.range(1));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(2));
+
+    auto const dataset = generate_dataset(dataset_size);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    StaticBPlusTree<int> const index{dataset};
+
+    if (!verify_hits(state, coro_bplus_tree_multi_lookup(index, lookups, n_streams), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
+
+    for (auto _ : state)
+    {
+        counters.start();
+        auto const start = hr_clock::now();
+
+        test_bplus_tree_coroutine(index, lookups, n_streams);
+
+        auto const stop = hr_clock::now();
+        counters.stop();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(elapsed.count());
+        state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
+    }
+
+    counters.report(state, N_LOOKUPS);
+}
+
+// the binary search step machine, one search at a time
+static void test_step_sequential(
+    std::vector<int> const& dataset, 
+    std::vector<int> const& lookups)
+{
+    benchmark::DoNotOptimize(step_multi_lookup(dataset, lookups));
+}
+
+static void BM_step_sequential(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(1));
+
+    auto const dataset = generate_dataset(dataset_size);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    if (!verify_hits(state, step_multi_lookup(dataset, lookups), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
+
+    for (auto _ : state)
+    {
+        counters.start();
+        auto const start = hr_clock::now();
+
+        test_step_sequential(dataset, lookups);
+
+        auto const stop = hr_clock::now();
+        counters.stop();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(elapsed.count());
+        state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
+    }
+
+    counters.report(state, N_LOOKUPS);
+}
+
+// the binary search step machine, interleaved by the AMAC engine
+static void test_amac(
+    std::vector<int> const& dataset, 
+    std::vector<int> const& lookups, 
+    std::size_t const       n_streams)
+{
+    benchmark::DoNotOptimize(amac_multi_lookup(dataset, lookups, n_streams));
+}
+
+static void BM_amac(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const n_streams    = static_cast<std::size_t>(state.range(1));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(2));
+
+    auto const dataset = generate_dataset(dataset_size);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    if (!verify_hits(state, amac_multi_lookup(dataset, lookups, n_streams), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
+
+    for (auto _ : state)
+    {
+        counters.start();
+        auto const start = hr_clock::now();
+
+        test_amac(dataset, lookups, n_streams);
+
+        auto const stop = hr_clock::now();
+        counters.stop();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(elapsed.count());
+        state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
+    }
+
+    counters.report(state, N_LOOKUPS);
+}
+
+// the binary search step machine, interleaved via coroutines
+static void test_step_coroutine(
+    std::vector<int> const& dataset, 
+    std::vector<int> const& lookups, 
+    std::size_t const       n_streams)
+{
+    benchmark::DoNotOptimize(coro_step_multi_lookup(dataset, lookups, n_streams));
+}
+
+static void BM_step_coroutine(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const n_streams    = static_cast<std::size_t>(state.range(1));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(2));
+
+    auto const dataset = generate_dataset(dataset_size);
+    auto const lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    if (!verify_hits(state, coro_step_multi_lookup(dataset, lookups, n_streams), dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
+
+    for (auto _ : state)
+    {
+        counters.start();
+        auto const start = hr_clock::now();
+
+        test_step_coroutine(dataset, lookups, n_streams);
+
+        auto const stop = hr_clock::now();
+        counters.stop();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(elapsed.count());
+        state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
+    }
+
+    counters.report(state, N_LOOKUPS);
+}
+
+// an interleaved lower bound search, generic over the key type
+template <typename T>
+static void test_interleaved_lower_bound(
+    std::vector<T> const&     dataset, 
+    std::vector<T> const&     lookups, 
+    std::vector<std::size_t>& positions,
+    std::size_t const         n_streams)
+{
+    interleaved_lower_bound(dataset, lookups, positions, n_streams);
+}
+
+template <typename T>
+static void BM_interleaved_lower_bound(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const dataset_size = static_cast<std::size_t>(state.range(0));
+    auto const n_streams    = static_cast<std::size_t>(state.range(1));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(2));
+
+    // the same keys as the other benchmarks, widened to the key type
+    auto const int_dataset = generate_dataset(dataset_size);
+    auto const int_lookups = generate_lookups(dataset_size, N_LOOKUPS, RNG_SEED, distribution);
+
+    std::vector<T> const dataset(int_dataset.begin(), int_dataset.end());
+    std::vector<T> const lookups(int_lookups.begin(), int_lookups.end());
+
+    std::vector<std::size_t> positions(lookups.size());
+
+    test_interleaved_lower_bound(dataset, lookups, positions, n_streams);
+    if (!verify_positions(state, positions, dataset, lookups))
+    {
+        return;
+    }
+
+    bench::perf_counters counters{};
+
+    for (auto _ : state)
+    {
+        counters.start();
+        auto const start = hr_clock::now();
+
+        test_interleaved_lower_bound(dataset, lookups, positions, n_streams);
+
+        auto const stop = hr_clock::now();
+        counters.stop();
+        auto const elapsed = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        benchmark::DoNotOptimize(positions.data());
+
+        state.SetIterationTime(elapsed.count());
+        state.SetItemsProcessed(static_cast<int64_t>(N_LOOKUPS));
+    }
+
+    counters.report(state, N_LOOKUPS);
 }
 
-BENCHMARK(BM_vanilla)->Range(MIN_DATASET_SIZE, MAX_DATASET_SIZE)->UseManualTime();
-BENCHMARK(BM_state_machine)->Ranges({{MIN_DATASET_SIZE, MAX_DATASET_SIZE}, {MIN_N_STREAMS, MAX_N_STREAMS}})->UseManualTime();
-BENCHMARK(BM_coroutine)->Ranges({{MIN_DATASET_SIZE, MAX_DATASET_SIZE}, {MIN_N_STREAMS, MAX_N_STREAMS}})->UseManualTime();
+BENCHMARK(BM_vanilla)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK(BM_state_machine)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateRange(MIN_N_STREAMS, MAX_N_STREAMS, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK(BM_coroutine)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateRange(MIN_N_STREAMS, MAX_N_STREAMS, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+
+BENCHMARK(BM_eytzinger)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK(BM_eytzinger_coroutine)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateRange(MIN_N_STREAMS, MAX_N_STREAMS, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK(BM_bplus_tree)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK(BM_bplus_tree_coroutine)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateRange(MIN_N_STREAMS, MAX_N_STREAMS, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK(BM_step_sequential)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK(BM_amac)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateRange(MIN_N_STREAMS, MAX_N_STREAMS, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK(BM_step_coroutine)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateRange(MIN_N_STREAMS, MAX_N_STREAMS, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK_TEMPLATE(BM_interleaved_lower_bound, int)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateRange(MIN_N_STREAMS, MAX_N_STREAMS, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
+BENCHMARK_TEMPLATE(BM_interleaved_lower_bound, std::uint64_t)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_DATASET_SIZE, MAX_DATASET_SIZE, 8), 
+        benchmark::CreateRange(MIN_N_STREAMS, MAX_N_STREAMS, 8), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->UseManualTime();
 
 BENCHMARK_MAIN();
\ No newline at end of file
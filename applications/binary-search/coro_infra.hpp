@@ -12,6 +12,8 @@
 #include <exception>
 #include <coroutine>
 
+#include <libcoro/recycling_allocator.hpp>
+
 #include <xmmintrin.h>
 
 struct scheduler_queue
@@ -52,7 +54,8 @@ struct scheduler_queue
     }
 };
 
-inline scheduler_queue scheduler;
+// each thread interleaves its own searches
+inline thread_local scheduler_queue scheduler;
 
 template <typename T>
 struct prefetch_awaitable
@@ -98,67 +101,6 @@ auto prefetch(T& value)
     return prefetch_awaitable<T>{value};
 }
 
-// thread-caching allocator
-struct tcalloc
-{
-    struct header
-    {
-        header* next;
-        size_t size;
-    };
-
-    header* root = nullptr;
-
-    size_t last_size_allocated = 0;
-    size_t total               = 0;
-    size_t alloc_count         = 0;
-
-    ~tcalloc()
-    {
-        auto current = root;
-        while (current)
-        {
-            auto next = current->next;
-            ::free(current);
-            current = next;
-        }
-    }
-
-    void* alloc(size_t sz)
-    {
-        if (root && root->size <= sz)
-        {
-            void* mem = root;
-            root = root->next;
-            return mem;
-        }
-
-        ++alloc_count;
-        total += sz;
-        last_size_allocated = sz;
-
-        return ::malloc(sz);
-    }
-
-    void free(void* p, size_t sz)
-    {
-        auto new_entry = static_cast<header*>(p);
-        new_entry->size = sz;
-        new_entry->next = root;
-        root = new_entry;
-    }
-
-    void stats()
-    {
-        printf("allocs: %zu total: %zu last size: %zu\n", 
-            alloc_count, 
-            total, 
-            last_size_allocated);
-    }
-};
-
-inline tcalloc allocator;
-
 struct throttler;
 
 struct root_task
@@ -170,16 +112,16 @@ struct root_task
     {
         throttler* owner = nullptr;
 
-        // utilize the custom tcalloc allocator
+        // utilize the thread-caching frame allocator
         void* operator new(size_t sz)
         {
-            return allocator.alloc(sz);
+            return coro::recycling_allocator::allocate(sz);
         }
 
-        // utilize the custom tcalloc allocator
+        // utilize the thread-caching frame allocator
         void operator delete(void* p, size_t sz)
         {
-            allocator.free(p, sz);
+            coro::recycling_allocator::deallocate(p, sz);
         }
 
         root_task get_return_object()
@@ -13,10 +13,6 @@
 
 #include "coro_infra.hpp"
 
-// hacky way to do this...
-static std::size_t found_count     = 0;
-static std::size_t not_found_count = 0;
-
 template <typename Iter, typename Found, typename NotFound>
 root_task coro_binary_search(
     Iter      first, 
@@ -53,21 +49,28 @@ root_task coro_binary_search(
     on_not_found();
 }
 
-static void on_found()
+// counts the searches that complete with a given result
+struct search_counter
 {
-    found_count++;
-}
+    std::size_t& count;
 
-static void on_not_found()
-{
-    not_found_count++;
-}
+    void operator()() const
+    {
+        ++count;
+    }
+};
 
 std::size_t coro_multi_lookup(
     std::vector<int> const& dataset,
     std::vector<int> const& lookups,
     std::size_t const       n_streams)
 {
+    std::size_t found_count     = 0;
+    std::size_t not_found_count = 0;
+
+    search_counter on_found{found_count};
+    search_counter on_not_found{not_found_count};
+
     throttler t{n_streams};
 
     for (auto key : lookups)
@@ -85,13 +88,7 @@ std::size_t coro_multi_lookup(
 
     assert((found_count + not_found_count) == lookups.size());
 
-    auto const tmp = found_count;
-
-    // reset counters for next iteration (if applicable)
-    found_count     = 0;
-    not_found_count = 0;
-
-    return tmp;
+    return found_count;
 }
 
 #endif // COROUTINE_BS_HPP
\ No newline at end of file
@@ -0,0 +1,206 @@
+// eytzinger.hpp
+// Search over a sorted dataset in the Eytzinger (BFS) layout.
+//
+// The Eytzinger layout stores the implicit binary search tree of the
+// sorted dataset in breadth-first order: the children of the node at
+// index k are at 2k and 2k + 1 (the root is at index 1). The nodes on
+// the first levels of every search are then packed into a handful of
+// cache lines, and the 2^d descendants of a node d levels below it are
+// contiguous, such that one prefetch fetches several levels ahead.
+//
+// See Khuong and Morin, "Array Layouts for Comparison-Based Searching"
+// (ACM JEA, 2017).
+
+#ifndef EYTZINGER_BS_HPP
+#define EYTZINGER_BS_HPP
+
+#include <bit>
+#include <new>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <xmmintrin.h>
+
+#include "coro_infra.hpp"
+
+template <typename T>
+class EytzingerIndex
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    // The size of a cache line; the layout is aligned to it.
+    constexpr static std::size_t const CACHE_LINE_SIZE = 64;
+
+    static_assert(CACHE_LINE_SIZE % sizeof(T) == 0);
+
+    // The number of nodes in a cache line; the BLOCK_SIZE descendants of
+    // node k that lie log2(BLOCK_SIZE) levels below it fill the line that
+    // begins at node k * BLOCK_SIZE.
+    constexpr static std::size_t const BLOCK_SIZE = CACHE_LINE_SIZE / sizeof(T);
+
+    struct AlignedDelete
+    {
+        void operator()(T* ptr) const
+        {
+            ::operator delete(ptr, std::align_val_t{CACHE_LINE_SIZE});
+        }
+    };
+
+    // the number of items in the index
+    std::size_t n;
+
+    // the nodes of the tree; index 0 is unused
+    std::unique_ptr<T[], AlignedDelete> nodes;
+
+public:
+    explicit EytzingerIndex(std::vector<T> const& sorted)
+        : n{sorted.size()}
+        , nodes{static_cast<T*>(::operator new(
+            (sorted.size() + 1) * sizeof(T), std::align_val_t{CACHE_LINE_SIZE}))}
+    {
+        std::size_t i = 0;
+        build(sorted, i, 1);
+    }
+
+    // non-copyable
+    EytzingerIndex(EytzingerIndex const&)            = delete;
+    EytzingerIndex& operator=(EytzingerIndex const&) = delete;
+
+    // non-movable
+    EytzingerIndex(EytzingerIndex&&)            = delete;
+    EytzingerIndex& operator=(EytzingerIndex&&) = delete;
+
+    // The index of the node that holds the first item not less than
+    // `key`, or 0 if there is no such item.
+    auto search(T const& key) const -> std::size_t
+    {
+        std::size_t k = 1;
+        while (k <= n)
+        {
+            prefetch_descendants(k);
+            k = 2 * k + static_cast<std::size_t>(nodes[k] < key);
+        }
+
+        return resolve(k);
+    }
+
+    // Determine if `key` is present in the index.
+    auto contains(T const& key) const -> bool
+    {
+        auto const k = search(key);
+        return (k != 0) && !(key < nodes[k]);
+    }
+
+    // The number of items in the index.
+    auto size() const noexcept -> std::size_t
+    {
+        return n;
+    }
+
+    // The node at index `k`, for 1 <= k <= size().
+    auto node(std::size_t const k) const noexcept -> T const&
+    {
+        return nodes[k];
+    }
+
+    // Prefetch the line that holds the descendants of node `k`, 
+    // log2(BLOCK_SIZE) levels below it (4 levels for 4-byte keys); the line
+    // may lie beyond the end of the layout (the prefetch of an unmapped
+    // address is dropped rather than faulting).
+    void prefetch_descendants(std::size_t const k) const noexcept
+    {
+        auto const address = reinterpret_cast<std::uintptr_t>(nodes.get()) + k * CACHE_LINE_SIZE;
+        _mm_prefetch(reinterpret_cast<char const*>(address), _MM_HINT_T0);
+    }
+
+    // Recover the node at which a search terminated from the index `k`
+    // beyond the leaves at which it fell off the tree: the search last
+    // went left at the node that holds the result, after which it went
+    // right at every node, so strip the trailing 1 bits and then one more.
+    static auto resolve(std::size_t const k) noexcept -> std::size_t
+    {
+        return k >> (std::countr_one(k) + 1);
+    }
+
+private:
+    // Fill the subtree rooted at node `k` by an in-order traversal.
+    void build(std::vector<T> const& sorted, std::size_t& i, std::size_t const k)
+    {
+        if (k <= n)
+        {
+            build(sorted, i, 2 * k);
+            nodes[k] = sorted[i++];
+            build(sorted, i, 2 * k + 1);
+        }
+    }
+};
+
+// Search for `key` in `index`, suspending on the prefetch of each node as
+// coro_binary_search() does; each node also prefetches the line of its
+// descendants several levels below, such that the nodes beneath a search
+// are already in flight by the time that it is resumed.
+template <typename T>
+root_task coro_eytzinger_search(
+    EytzingerIndex<T> const& index,
+    T const                  key,
+    std::size_t&             n_found)
+{
+    auto const n = index.size();
+
+    std::size_t k = 1;
+    while (k <= n)
+    {
+        index.prefetch_descendants(k);
+
+        auto const& x = co_await prefetch(index.node(k));
+        k = 2 * k + static_cast<std::size_t>(x < key);
+    }
+
+    k = EytzingerIndex<T>::resolve(k);
+    if ((k != 0) && !(key < index.node(k)))
+    {
+        ++n_found;
+    }
+}
+
+// Search for each of `lookups` in `index` in turn; returns the number found.
+template <typename T>
+std::size_t eytzinger_multi_lookup(
+    EytzingerIndex<T> const& index,
+    std::vector<T> const&    lookups)
+{
+    std::size_t n_found = 0;
+    for (auto const& key : lookups)
+    {
+        n_found += static_cast<std::size_t>(index.contains(key));
+    }
+
+    return n_found;
+}
+
+// Search for `lookups` in `index` with up to `n_streams` searches in
+// flight at once; returns the number found.
+template <typename T>
+std::size_t coro_eytzinger_multi_lookup(
+    EytzingerIndex<T> const& index,
+    std::vector<T> const&    lookups,
+    std::size_t const        n_streams)
+{
+    std::size_t n_found = 0;
+
+    throttler t{n_streams};
+
+    for (auto const& key : lookups)
+    {
+        t.spawn(coro_eytzinger_search(index, key, n_found));
+    }
+
+    t.run();
+
+    return n_found;
+}
+
+#endif // EYTZINGER_BS_HPP
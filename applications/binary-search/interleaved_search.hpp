@@ -0,0 +1,93 @@
+// interleaved_search.hpp
+// Interleaved lower-bound search over arbitrary sorted ranges.
+//
+// The generalization of coro_binary_search() (coroutine.hpp) to any
+// random-access range, key type, and comparator: each search suspends
+// upon the prefetch of each of its probes, exactly as in the original,
+// but writes the position of its result to an output range rather than
+// reporting a hit or miss to a callback.
+
+#ifndef INTERLEAVED_SEARCH_HPP
+#define INTERLEAVED_SEARCH_HPP
+
+#include <ranges>
+#include <cstddef>
+#include <iterator>
+#include <functional>
+
+#include "coro_infra.hpp"
+
+// Compute the lower bound of `key` in [first, last) under `comp`, and
+// write its offset from `first` to `*out`; the key is taken by value,
+// such that it may be drawn from a range that does not outlive the call.
+template <typename Iter, typename Key, typename Compare, typename OutIter>
+root_task coro_lower_bound(
+    Iter       first,
+    Iter const last,
+    Key const  key,
+    Compare    comp,
+    OutIter    out)
+{
+    auto const begin = first;
+
+    auto len = last - first;
+    while (len > 0)
+    {
+        auto const half   = len / 2;
+        auto const middle = first + half;
+
+        auto const& x = co_await prefetch(*middle);
+
+        if (comp(x, key))
+        {
+            first = middle + 1;
+            len   = len - half - 1;
+        }
+        else
+        {
+            len = half;
+        }
+    }
+
+    *out = static_cast<std::iter_value_t<OutIter>>(first - begin);
+}
+
+// For each key in `keys`, write to the corresponding element of `out`
+// the position in `range` of the first element that is not ordered
+// before the key under `comp` (i.e. that of std::lower_bound()), with
+// up to `n_streams` searches in flight at once.
+//
+// `range` must be sorted under `comp` and yield lvalues; `out` must hold
+// at least as many elements as there are keys. The searches complete out
+// of order, so each writes its position directly to its own element.
+// `n_streams` must be nonzero, and less than the capacity of the queue
+// of the scheduler (scheduler_queue::N).
+template <
+    std::ranges::random_access_range Range,
+    std::ranges::input_range         Keys,
+    std::ranges::random_access_range Out,
+    typename Compare = std::less<>>
+void interleaved_lower_bound(
+    Range const&      range,
+    Keys&&            keys,
+    Out&&             out,
+    std::size_t const n_streams,
+    Compare           comp = {})
+{
+    auto const first = std::ranges::begin(range);
+    auto const last  = std::ranges::next(first, std::ranges::end(range));
+
+    auto slot = std::ranges::begin(out);
+
+    throttler t{n_streams};
+
+    for (auto&& key : keys)
+    {
+        t.spawn(coro_lower_bound(first, last, key, comp, slot));
+        ++slot;
+    }
+
+    t.run();
+}
+
+#endif // INTERLEAVED_SEARCH_HPP
@@ -0,0 +1,285 @@
+// static_bplus_tree.hpp
+// Search over a sorted dataset in a static B+-tree of cache-line nodes.
+//
+// Each node of the tree is a single (aligned) cache line of keys, such
+// that a search incurs one miss per level rather than one per comparison,
+// and the keys of a node are ranked against the search key with SIMD
+// compares. The tree is implicit (an "S+-tree"): its layers are stored
+// contiguously, leaves first, and child i of node k in the layer above
+// is node k * FANOUT + i, such that the nodes hold no pointers. The leaf
+// layer is the sorted dataset itself, padded to a whole node; each key
+// of an internal node is the smallest key in the subtree to the right of
+// it, such that a search descends into the child to the left of the
+// first key that is not less than the search key.
+//
+// See "Static B-Trees" in Algorithms for Modern Hardware (Slotin).
+
+#ifndef STATIC_BPLUS_TREE_BS_HPP
+#define STATIC_BPLUS_TREE_BS_HPP
+
+#include <bit>
+#include <new>
+#include <limits>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include <emmintrin.h>
+
+#include "coro_infra.hpp"
+
+template <typename T>
+class StaticBPlusTree
+{
+    static_assert(std::is_integral_v<T>);
+
+    // The size of a cache line; each node fills one.
+    constexpr static std::size_t const CACHE_LINE_SIZE = 64;
+
+public:
+    // The number of keys in a node.
+    constexpr static std::size_t const NODE_SIZE = CACHE_LINE_SIZE / sizeof(T);
+
+    // The number of children of an internal node.
+    constexpr static std::size_t const FANOUT = NODE_SIZE + 1;
+
+private:
+    // The key that pads the leaf layer and stands in for absent children.
+    constexpr static T const PADDING = std::numeric_limits<T>::max();
+
+    struct AlignedDelete
+    {
+        void operator()(T* ptr) const
+        {
+            ::operator delete(ptr, std::align_val_t{CACHE_LINE_SIZE});
+        }
+    };
+
+    // the number of items in the tree
+    std::size_t n;
+
+    // the offset of the first node of each layer, leaves first
+    std::vector<std::size_t> layer_offsets;
+
+    // the number of nodes in each layer, leaves first
+    std::vector<std::size_t> layer_sizes;
+
+    // the nodes of all layers
+    std::unique_ptr<T[], AlignedDelete> keys;
+
+public:
+    explicit StaticBPlusTree(std::vector<T> const& sorted)
+        : n{sorted.size()}
+        , layer_offsets{}
+        , layer_sizes{}
+        , keys{}
+    {
+        // the leaf layer holds at least one node, such that
+        // a search of an empty tree terminates at a leaf
+        auto n_nodes = std::max((n + NODE_SIZE - 1) / NODE_SIZE, static_cast<std::size_t>(1));
+
+        std::size_t total = 0;
+        for (;;)
+        {
+            layer_offsets.push_back(total);
+            layer_sizes.push_back(n_nodes);
+            total += n_nodes;
+
+            if (1 == n_nodes)
+            {
+                break;
+            }
+
+            n_nodes = (n_nodes + FANOUT - 1) / FANOUT;
+        }
+
+        keys.reset(static_cast<T*>(::operator new(
+            total * CACHE_LINE_SIZE, std::align_val_t{CACHE_LINE_SIZE})));
+
+        // the leaf layer is the dataset, padded to a whole node
+        std::copy(sorted.begin(), sorted.end(), keys.get());
+        std::fill(keys.get() + n, keys.get() + layer_sizes[0] * NODE_SIZE, PADDING);
+
+        for (auto h = 1ul; h < layer_sizes.size(); ++h)
+        {
+            for (auto k = 0ul; k < layer_sizes[h]; ++k)
+            {
+                auto* const node = keys.get() + (layer_offsets[h] + k) * NODE_SIZE;
+                for (auto i = 0ul; i < NODE_SIZE; ++i)
+                {
+                    node[i] = smallest_key(h - 1, k * FANOUT + i + 1);
+                }
+            }
+        }
+    }
+
+    // non-copyable
+    StaticBPlusTree(StaticBPlusTree const&)            = delete;
+    StaticBPlusTree& operator=(StaticBPlusTree const&) = delete;
+
+    // non-movable
+    StaticBPlusTree(StaticBPlusTree&&)            = delete;
+    StaticBPlusTree& operator=(StaticBPlusTree&&) = delete;
+
+    // The position in the sorted dataset of the first item not less
+    // than `key`, or size() if there is no such item.
+    auto lower_bound(T const key) const -> std::size_t
+    {
+        std::size_t k = 0;
+        for (auto h = height() - 1; h > 0; --h)
+        {
+            k = k * FANOUT + rank(node(h, k), key);
+        }
+
+        return std::min(k * NODE_SIZE + rank(node(0, k), key), n);
+    }
+
+    // Determine if `key` is present in the tree.
+    auto contains(T const key) const -> bool
+    {
+        auto const i = lower_bound(key);
+        return (i < n) && (keys[i] == key);
+    }
+
+    // The number of items in the tree.
+    auto size() const noexcept -> std::size_t
+    {
+        return n;
+    }
+
+    // The number of layers in the tree, including the leaves.
+    auto height() const noexcept -> std::size_t
+    {
+        return layer_sizes.size();
+    }
+
+    // The item at position `i` of the sorted dataset, for i < size().
+    auto operator[](std::size_t const i) const noexcept -> T const&
+    {
+        return keys[i];
+    }
+
+    // The keys of node `k` of layer `h`, where layer 0 is the leaves.
+    auto node(std::size_t const h, std::size_t const k) const noexcept -> T const*
+    {
+        return keys.get() + (layer_offsets[h] + k) * NODE_SIZE;
+    }
+
+    // The number of the keys of `node` that are less than `key`; as the
+    // keys of a node are sorted, the position of the first key that is not.
+    static auto rank(T const* node, T const key) noexcept -> std::size_t
+    {
+        if constexpr (std::is_same_v<T, std::int32_t>)
+        {
+            // four 4-wide signed compares, one bit per key in the mask
+            auto const x = _mm_set1_epi32(key);
+
+            unsigned int mask = 0;
+            for (auto i = 0u; i < NODE_SIZE / 4; ++i)
+            {
+                auto const y = _mm_load_si128(reinterpret_cast<__m128i const*>(node) + i);
+                auto const lt = _mm_castsi128_ps(_mm_cmpgt_epi32(x, y));
+                mask |= static_cast<unsigned int>(_mm_movemask_ps(lt)) << (4 * i);
+            }
+
+            return static_cast<std::size_t>(std::popcount(mask));
+        }
+        else
+        {
+            // branch-free, such that the compiler may vectorize it
+            std::size_t count = 0;
+            for (auto i = 0ul; i < NODE_SIZE; ++i)
+            {
+                count += static_cast<std::size_t>(node[i] < key);
+            }
+
+            return count;
+        }
+    }
+
+private:
+    // The smallest key in the subtree rooted at node `k` of layer `h`,
+    // or the padding key if layer `h` holds no such node.
+    auto smallest_key(std::size_t h, std::size_t k) const -> T
+    {
+        if (k >= layer_sizes[h])
+        {
+            return PADDING;
+        }
+
+        for (; h > 0; --h)
+        {
+            k *= FANOUT;
+        }
+
+        return keys[k * NODE_SIZE];
+    }
+};
+
+// Search for `key` in `tree`, suspending on the prefetch of each node
+// on the path from the root to a leaf.
+template <typename T>
+root_task coro_bplus_tree_search(
+    StaticBPlusTree<T> const& tree,
+    T const                   key,
+    std::size_t&              n_found)
+{
+    using Tree = StaticBPlusTree<T>;
+
+    std::size_t k = 0;
+    for (auto h = tree.height() - 1; h > 0; --h)
+    {
+        auto const& node = co_await prefetch(*tree.node(h, k));
+        k = k * Tree::FANOUT + Tree::rank(&node, key);
+    }
+
+    auto const& leaf = co_await prefetch(*tree.node(0, k));
+
+    auto const i = k * Tree::NODE_SIZE + Tree::rank(&leaf, key);
+    if ((i < tree.size()) && (tree[i] == key))
+    {
+        ++n_found;
+    }
+}
+
+// Search for each of `lookups` in `tree` in turn; returns the number found.
+template <typename T>
+std::size_t bplus_tree_multi_lookup(
+    StaticBPlusTree<T> const& tree,
+    std::vector<T> const&     lookups)
+{
+    std::size_t n_found = 0;
+    for (auto const key : lookups)
+    {
+        n_found += static_cast<std::size_t>(tree.contains(key));
+    }
+
+    return n_found;
+}
+
+// Search for `lookups` in `tree` with up to `n_streams` searches in
+// flight at once; returns the number found.
+template <typename T>
+std::size_t coro_bplus_tree_multi_lookup(
+    StaticBPlusTree<T> const& tree,
+    std::vector<T> const&     lookups,
+    std::size_t const         n_streams)
+{
+    std::size_t n_found = 0;
+
+    throttler t{n_streams};
+
+    for (auto const key : lookups)
+    {
+        t.spawn(coro_bplus_tree_search(tree, key, n_found));
+    }
+
+    t.run();
+
+    return n_found;
+}
+
+#endif // STATIC_BPLUS_TREE_BS_HPP
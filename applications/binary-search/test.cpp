@@ -0,0 +1,124 @@
+// test.cpp
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+
+#include "interleaved_search.hpp"
+
+// The positions of std::lower_bound() for each of `keys` in `dataset`.
+template <typename T, typename Compare = std::less<>>
+static auto expected_positions(
+    std::vector<T> const& dataset,
+    std::vector<T> const& keys,
+    Compare               comp = {}) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> positions{};
+    for (auto const& key : keys)
+    {
+        auto const it = std::lower_bound(dataset.begin(), dataset.end(), key, comp);
+        positions.push_back(static_cast<std::size_t>(it - dataset.begin()));
+    }
+
+    return positions;
+}
+
+// The positions of interleaved_lower_bound() for each of `keys` in `dataset`.
+template <typename T, typename Compare = std::less<>>
+static auto interleaved_positions(
+    std::vector<T> const& dataset,
+    std::vector<T> const& keys,
+    std::size_t const     n_streams,
+    Compare               comp = {}) -> std::vector<std::size_t>
+{
+    std::vector<std::size_t> positions(keys.size());
+    interleaved_lower_bound(dataset, keys, positions, n_streams, comp);
+    return positions;
+}
+
+TEST_CASE("interleaved lower bound handles empty ranges")
+{
+    auto const n_streams = GENERATE(1ul, 8ul);
+
+    SECTION("an empty dataset places every key at its start")
+    {
+        std::vector<int> const dataset{};
+        std::vector<int> const keys{-1, 0, 1};
+        REQUIRE(interleaved_positions(dataset, keys, n_streams) == std::vector<std::size_t>{0, 0, 0});
+    }
+
+    SECTION("no keys writes no positions")
+    {
+        std::vector<int> const dataset{1, 2, 3};
+        std::vector<int> const keys{};
+        REQUIRE(interleaved_positions(dataset, keys, n_streams).empty());
+    }
+}
+
+TEST_CASE("interleaved lower bound finds the first of duplicate elements")
+{
+    auto const n_streams = GENERATE(1ul, 3ul, 16ul);
+
+    std::vector<int> const dataset{1, 1, 1, 3, 3, 5, 7, 7, 7, 7, 9};
+    std::vector<int> const keys{1, 3, 5, 7, 9, 2, 4, 6, 8, 7, 1};
+
+    auto const positions = interleaved_positions(dataset, keys, n_streams);
+    REQUIRE(positions == expected_positions(dataset, keys));
+    REQUIRE(positions == std::vector<std::size_t>{0, 3, 5, 6, 10, 3, 5, 6, 10, 6, 0});
+}
+
+TEST_CASE("interleaved lower bound handles keys beyond either end")
+{
+    auto const n_streams = GENERATE(1ul, 8ul);
+
+    std::vector<int> const dataset{10, 20, 30, 40};
+    std::vector<int> const keys{-100, 9, 10, 40, 41, 1000};
+
+    auto const positions = interleaved_positions(dataset, keys, n_streams);
+    REQUIRE(positions == std::vector<std::size_t>{0, 0, 0, 3, 4, 4});
+}
+
+TEST_CASE("interleaved lower bound agrees with std::lower_bound")
+{
+    auto const n_streams = GENERATE(1ul, 7ul, 64ul);
+    auto const size      = GENERATE(1ul, 2ul, 1000ul, 4096ul);
+
+    std::mt19937_64 gen{size};
+    std::uniform_int_distribution<int> draw{0, static_cast<int>(2 * size)};
+
+    std::vector<int> dataset(size);
+    std::generate(dataset.begin(), dataset.end(), [&]() { return draw(gen); });
+    std::sort(dataset.begin(), dataset.end());
+
+    std::vector<int> keys(1000);
+    std::generate(keys.begin(), keys.end(), [&]() { return draw(gen) - 1; });
+
+    REQUIRE(interleaved_positions(dataset, keys, n_streams) == expected_positions(dataset, keys));
+}
+
+TEST_CASE("interleaved lower bound supports other key types and comparators")
+{
+    auto const n_streams = GENERATE(1ul, 8ul);
+
+    SECTION("floating-point keys")
+    {
+        std::vector<double> const dataset{-1.5, 0.0, 0.25, 0.25, 3.75};
+        std::vector<double> const keys{-2.0, 0.0, 0.1, 0.25, 3.75, 4.0};
+        REQUIRE(interleaved_positions(dataset, keys, n_streams)
+            == expected_positions(dataset, keys));
+    }
+
+    SECTION("string keys in descending order")
+    {
+        std::vector<std::string> const dataset{"pear", "kiwi", "kiwi", "fig", "apple"};
+        std::vector<std::string> const keys{"zucchini", "pear", "lime", "kiwi", "date", "apple", "a"};
+        REQUIRE(interleaved_positions(dataset, keys, n_streams, std::greater<>{})
+            == expected_positions(dataset, keys, std::greater<>{}));
+    }
+}
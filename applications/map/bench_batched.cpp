@@ -0,0 +1,184 @@
+// bench_batched.cpp
+// Sequential, interleaved, and batched multilookup against the same maps.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <stdcoro/coroutine.hpp>
+#include <libbench/key_streams.hpp>
+
+#include "map.hpp"
+#include "scheduler.hpp"
+#include "dev_null_iterator.hpp"
+
+// the maximum capacity of the capped map instance, as in bench_sequential
+// and bench_interleaved; every bucket holds a long chain at larger sizes
+constexpr static std::size_t const MAP_MAX_CAPACITY = 1 << 16;
+
+// the maximum capacity of the uncapped map instance; the bucket array
+// grows with the number of items and eventually outgrows the cache
+constexpr static std::size_t const MAP_UNCAPPED_CAPACITY
+    = std::numeric_limits<std::size_t>::max();
+
+// the number of concurrent instruction streams used in multilookup
+constexpr static std::size_t const N_STREAMS = 10;
+
+// the upper and lower bound on the number of items in the map;
+// also the number of lookups that we perform in this test iteration
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 25;  // ~32 million keys
+
+// the size of the temporary buffer for generating messages
+constexpr static std::size_t MSG_BUFFER_SIZE = 64;
+
+template <typename Lookup>
+static void run_multilookup(
+    benchmark::State& state,
+    std::size_t const max_capacity,
+    Lookup            lookup)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        // construct the map and insert `n_items` elements
+        Map<int, int> map{max_capacity};
+        for (auto i : bench::sequential_keys<int>(n_items))
+        {
+            map.insert(i, i);
+        }
+
+        // the uncapped map is probed in scattered order, as the input
+        // order otherwise already coincides with the bucket order
+        auto make_lookup_range = [max_capacity, n_items]() {
+            return (max_capacity == MAP_MAX_CAPACITY)
+                ? bench::sequential_keys<int>(n_items)
+                : bench::strided_keys<int>(n_items, n_items);
+        };
+
+        // output iterator is a no-op;
+        // we don't pay for e.g. a std::vector::push_back() on each iteration
+        DevNullIterator output_iter{};
+
+        // one untimed pass, such that each mode is measured in steady
+        // state (e.g. with the scratch space of batched_multilookup()
+        // already faulted in) rather than on its first use of the map
+        auto warmup_range = make_lookup_range();
+        lookup(map, warmup_range, output_iter);
+
+        auto lookup_range = make_lookup_range();
+
+        auto const start = hr_clock::now();
+
+        lookup(map, lookup_range, output_iter);
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+
+        auto const as_ns = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(stop - start);
+
+        auto const ns_per_lookup = as_ns.count() / static_cast<long int>(n_items);
+
+        char message[MSG_BUFFER_SIZE];
+        ::snprintf(message, sizeof(message),
+            "%zu items: %zu ns per lookup", n_items, ns_per_lookup);
+
+        state.SetLabel(message);
+    }
+}
+
+static auto sequential_multilookup = [](auto& map, auto& lookup_range, auto output_iter) {
+    map.sequential_multilookup(
+        lookup_range.begin(),
+        lookup_range.end(),
+        output_iter);
+};
+
+static auto interleaved_multilookup = [](auto& map, auto& lookup_range, auto output_iter) {
+    // construct the scheduler for scheduling coroutines; depth is immaterial
+    StaticQueueScheduler<32> scheduler{};
+
+    map.interleaved_multilookup(
+        lookup_range.begin(),
+        lookup_range.end(),
+        output_iter,
+        scheduler,
+        N_STREAMS);
+};
+
+static auto batched_multilookup = [](auto& map, auto& lookup_range, auto output_iter) {
+    map.batched_multilookup(
+        lookup_range.begin(),
+        lookup_range.end(),
+        output_iter);
+};
+
+static void BM_sequential_multilookup(benchmark::State& state)
+{
+    run_multilookup(state, MAP_MAX_CAPACITY, sequential_multilookup);
+}
+
+static void BM_interleaved_multilookup(benchmark::State& state)
+{
+    run_multilookup(state, MAP_MAX_CAPACITY, interleaved_multilookup);
+}
+
+static void BM_batched_multilookup(benchmark::State& state)
+{
+    run_multilookup(state, MAP_MAX_CAPACITY, batched_multilookup);
+}
+
+static void BM_sequential_multilookup_uncapped(benchmark::State& state)
+{
+    run_multilookup(state, MAP_UNCAPPED_CAPACITY, sequential_multilookup);
+}
+
+static void BM_interleaved_multilookup_uncapped(benchmark::State& state)
+{
+    run_multilookup(state, MAP_UNCAPPED_CAPACITY, interleaved_multilookup);
+}
+
+static void BM_batched_multilookup_uncapped(benchmark::State& state)
+{
+    run_multilookup(state, MAP_UNCAPPED_CAPACITY, batched_multilookup);
+}
+
+BENCHMARK(BM_sequential_multilookup)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_interleaved_multilookup)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_batched_multilookup)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_sequential_multilookup_uncapped)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_interleaved_multilookup_uncapped)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_batched_multilookup_uncapped)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,212 @@
+// bench_concurrent.cpp
+// Multi-threaded throughput of a shared map under a read-mostly workload.
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdcoro/coroutine.hpp>
+
+#include "map.hpp"
+#include "scheduler.hpp"
+#include "concurrent_map.hpp"
+#include "dev_null_iterator.hpp"
+
+// the number of items in the shared map
+constexpr static std::size_t const N_ITEMS = 1 << 22;  // ~4 million keys
+
+// the number of operations performed by each thread per iteration
+constexpr static std::size_t const OPS_PER_BATCH = 1 << 12;
+
+// one in every UPDATE_INTERVAL operations is an update, the rest are lookups
+constexpr static std::size_t const UPDATE_INTERVAL = 10;
+
+// the number of concurrent instruction streams used in multilookup
+constexpr static std::size_t const N_STREAMS = 10;
+
+// the maximum number of threads sharing the map
+static int const MAX_THREADS = static_cast<int>(
+    std::max(1u, std::thread::hardware_concurrency()));
+
+// A Map shared by wrapping it in a single global mutex.
+struct GlobalMutexMap
+{
+    Map<int, int> map;
+    std::mutex    mutex;
+};
+
+// A per-thread source of (uniformly-distributed) random keys.
+class KeyGenerator
+{
+    // xorshift64 state; never zero
+    std::uint64_t state;
+
+public:
+    explicit KeyGenerator(int const thread_index)
+        : state{0x9E3779B97F4A7C15ul * static_cast<std::uint64_t>(thread_index + 1)} {}
+
+    int next()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<int>(state % N_ITEMS);
+    }
+};
+
+template <typename MapType>
+static void populate(MapType& map)
+{
+    for (auto i = 0; i < static_cast<int>(N_ITEMS); ++i)
+    {
+        map.insert(i, i);
+    }
+}
+
+// the instance shared by all threads of the current benchmark
+static std::unique_ptr<GlobalMutexMap>          shared_mutex_map{};
+static std::unique_ptr<ConcurrentMap<int, int>> shared_concurrent_map{};
+
+static void BM_global_mutex_map(benchmark::State& state)
+{
+    // all threads wait at the start of the benchmark loop
+    // until the first thread completes this setup
+    if (0 == state.thread_index())
+    {
+        shared_mutex_map = std::make_unique<GlobalMutexMap>();
+        populate(shared_mutex_map->map);
+    }
+
+    KeyGenerator keys{state.thread_index()};
+
+    for (auto _ : state)
+    {
+        auto& shared = *shared_mutex_map;
+        for (auto i = 0ul; i < OPS_PER_BATCH; ++i)
+        {
+            auto const key = keys.next();
+
+            std::lock_guard lock{shared.mutex};
+            if (0 == i % UPDATE_INTERVAL)
+            {
+                shared.map.update(key, key);
+            }
+            else
+            {
+                auto const result = shared.map.lookup(key);
+                benchmark::DoNotOptimize(result);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(OPS_PER_BATCH));
+
+    if (0 == state.thread_index())
+    {
+        shared_mutex_map.reset();
+    }
+}
+
+static void BM_concurrent_map(benchmark::State& state)
+{
+    if (0 == state.thread_index())
+    {
+        shared_concurrent_map = std::make_unique<ConcurrentMap<int, int>>();
+        populate(*shared_concurrent_map);
+    }
+
+    KeyGenerator keys{state.thread_index()};
+
+    for (auto _ : state)
+    {
+        auto& shared = *shared_concurrent_map;
+        for (auto i = 0ul; i < OPS_PER_BATCH; ++i)
+        {
+            auto const key = keys.next();
+            if (0 == i % UPDATE_INTERVAL)
+            {
+                shared.update(key, key);
+            }
+            else
+            {
+                auto const result = shared.lookup(key);
+                benchmark::DoNotOptimize(result);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(OPS_PER_BATCH));
+
+    if (0 == state.thread_index())
+    {
+        shared_concurrent_map.reset();
+    }
+}
+
+static void BM_concurrent_map_interleaved(benchmark::State& state)
+{
+    if (0 == state.thread_index())
+    {
+        shared_concurrent_map = std::make_unique<ConcurrentMap<int, int>>();
+        populate(*shared_concurrent_map);
+    }
+
+    KeyGenerator keys{state.thread_index()};
+
+    // each thread drives its own interleaved lookups with its own scheduler
+    StaticQueueScheduler<32> scheduler{};
+
+    std::vector<int> lookup_keys{};
+    lookup_keys.reserve(OPS_PER_BATCH);
+
+    for (auto _ : state)
+    {
+        auto& shared = *shared_concurrent_map;
+
+        lookup_keys.clear();
+        for (auto i = 0ul; i < OPS_PER_BATCH; ++i)
+        {
+            auto const key = keys.next();
+            if (0 == i % UPDATE_INTERVAL)
+            {
+                shared.update(key, key);
+            }
+            else
+            {
+                lookup_keys.push_back(key);
+            }
+        }
+
+        shared.interleaved_multilookup(
+            lookup_keys.begin(),
+            lookup_keys.end(),
+            DevNullIterator{},
+            scheduler,
+            N_STREAMS);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(OPS_PER_BATCH));
+
+    if (0 == state.thread_index())
+    {
+        shared_concurrent_map.reset();
+    }
+}
+
+BENCHMARK(BM_global_mutex_map)
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+BENCHMARK(BM_concurrent_map)
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+BENCHMARK(BM_concurrent_map_interleaved)
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
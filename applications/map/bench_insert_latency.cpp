@@ -0,0 +1,92 @@
+// bench_insert_latency.cpp
+// Tail latency of individual insertions under each resize mode.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <stdcoro/coroutine.hpp>
+#include <libbench/key_streams.hpp>
+
+#include "map.hpp"
+
+// the upper and lower bound on the number of items in the map;
+// also the number of insertions that we perform in this test iteration
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 20;  // ~1 million keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 25;  // ~32 million keys
+
+// Compute the latency at quantile `q` of the given samples;
+// the samples are partially reordered in the process.
+static double quantile(std::vector<std::chrono::nanoseconds>& samples, double const q)
+{
+    auto const rank = static_cast<std::size_t>(
+        q * static_cast<double>(samples.size() - 1));
+
+    std::nth_element(samples.begin(), samples.begin() + static_cast<long int>(rank), samples.end());
+    return static_cast<double>(samples[rank].count());
+}
+
+static void run_insert_latency(benchmark::State& state, ResizeMode const resize_mode)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    // the latency of each individual insertion in the last iteration;
+    // allocated up front so that recording a sample never allocates
+    std::vector<std::chrono::nanoseconds> samples(n_items);
+
+    for (auto _ : state)
+    {
+        Map<int, int> map{std::numeric_limits<std::size_t>::max(), resize_mode};
+
+        auto const start = hr_clock::now();
+
+        auto sample = samples.begin();
+        for (auto i : bench::sequential_keys<int>(n_items))
+        {
+            auto const before = hr_clock::now();
+            map.insert(i, i);
+            auto const after = hr_clock::now();
+
+            *sample++ = std::chrono::duration_cast<std::chrono::nanoseconds>(after - before);
+        }
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+    }
+
+    // a single stop-the-world resize is one sample among millions,
+    // so it is only visible in the maximum, not in the percentiles
+    state.counters["p50_ns"]  = quantile(samples, 0.5);
+    state.counters["p99_ns"]  = quantile(samples, 0.99);
+    state.counters["p999_ns"] = quantile(samples, 0.999);
+    state.counters["max_ns"]  = static_cast<double>(
+        std::max_element(samples.begin(), samples.end())->count());
+}
+
+static void BM_insert_latency_immediate_resize(benchmark::State& state)
+{
+    run_insert_latency(state, ResizeMode::Immediate);
+}
+
+static void BM_insert_latency_incremental_resize(benchmark::State& state)
+{
+    run_insert_latency(state, ResizeMode::Incremental);
+}
+
+BENCHMARK(BM_insert_latency_immediate_resize)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_insert_latency_incremental_resize)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -3,17 +3,26 @@
 #include <benchmark/benchmark.h>
 
 #include <chrono>
+#include <limits>
 #include <string>
+#include <vector>
 #include <stdcoro/coroutine.hpp>
-#include <libcoro/generator.hpp>
+#include <libbench/key_streams.hpp>
+#include <libbench/perf_counters.hpp>
 
 #include "map.hpp"
 #include "scheduler.hpp"
 #include "dev_null_iterator.hpp"
 
-// the maximum capacity of the map instance 
+// the maximum capacity of the capped map instance; with the capacity
+// capped, the bucket array remains small enough to reside in cache
 constexpr static std::size_t const MAP_MAX_CAPACITY = 1 << 16;
 
+// the maximum capacity of the uncapped map instance; the bucket array
+// grows with the number of items and eventually outgrows the cache
+constexpr static std::size_t const MAP_UNCAPPED_CAPACITY 
+    = std::numeric_limits<std::size_t>::max();
+
 // the number of concurrent instruction streams used in multilookup;
 // after running this benchmark varying the number of streams, I saw 
 // very little difference between runs depedendent on the stream count, 
@@ -25,59 +34,101 @@ constexpr static std::size_t const N_STREAMS = 10;
 constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
 constexpr static std::size_t const MAX_N_ITEMS = 1 << 25;  // ~32 million keys
 
+// the upper and lower bound on the number of items in the small maps,
+// which fit in cache such that suspending on a prefetch is pure overhead
+constexpr static std::size_t const MIN_N_SMALL_ITEMS = 1 << 10;  // ~1,000 keys
+constexpr static std::size_t const MAX_N_SMALL_ITEMS = 1 << 15;  // ~32,000 keys
+
 // the upper and lower bound on the number of simultaneous
 // instruction streams to maintain for ISI with coroutines
 constexpr static std::size_t const MIN_N_STREAMS =  8;
 constexpr static std::size_t const MAX_N_STREAMS = 32;
 
+// the key distributions under which lookups are compared
+constexpr static std::int64_t const MIN_DISTRIBUTION 
+    = static_cast<std::int64_t>(bench::key_distribution::sequential);
+constexpr static std::int64_t const MAX_DISTRIBUTION 
+    = static_cast<std::int64_t>(bench::key_distribution::colliding);
+
 // the size of the temporary buffer for generating messages
 constexpr static std::size_t MSG_BUFFER_SIZE = 64;
 
-template <typename T>
-coro::generator<T> make_range(T begin, T end)
-{
-    for (auto i = begin; i < end; ++i)
-    {
-        co_yield i;
-    }
-}
+// the scheduler used for all benchmarks; depth is immaterial for a
+// fixed stream count, but bounds the adaptive stream count from above
+using Scheduler = StaticQueueScheduler<32>;
 
-static void BM_interleaved_multilookup(benchmark::State& state)
+// the capped map is probed in order, as in bench_sequential; the uncapped
+// map is probed in strided order so that consecutive lookups do not share
+// lines of the bucket array
+constexpr static bench::key_distribution const SEQUENTIAL = bench::key_distribution::sequential;
+constexpr static bench::key_distribution const STRIDED    = bench::key_distribution::strided;
+
+static void run_interleaved_multilookup(
+    benchmark::State&             state, 
+    std::size_t const             max_capacity,
+    bool const                    adaptive,
+    bench::key_distribution const distribution,
+    PrefetchPolicy const          policy    = PrefetchPolicy::SizeHeuristic,
+    PageSize const                page_size = PageSize::Base,
+    Interleaving const            interleaving = Interleaving::Coroutine)
 {
     using hr_clock = std::chrono::high_resolution_clock;
 
     auto const n_items   = static_cast<std::size_t>(state.range(0));
 
+    // draw the lookup keys ahead of time; drawing a key from a skewed
+    // distribution costs as much as the lookup itself, and would otherwise
+    // be measured along with it
+    std::vector<int> lookup_range{};
+    lookup_range.reserve(n_items);
+    for (auto key : bench::lookup_keys<int>(distribution, n_items, n_items, n_items))
+    {
+        lookup_range.push_back(key);
+    }
+
+    bench::perf_counters counters{};
+
     for (auto _ : state)
     {
-        // construct the scheduler for scheduling coroutines; depth is immaterial
-        StaticQueueScheduler<32> scheduler{};
+        // construct the scheduler for scheduling coroutines
+        Scheduler scheduler{};
 
         // construct the map and insert `n_items` elements
-        Map<int, int> map{MAP_MAX_CAPACITY};
-        for (auto i : make_range<int>(0, static_cast<int>(n_items)))
+        Map<int, int> map{max_capacity, ResizeMode::Immediate, page_size};
+        map.set_prefetch_policy(policy);
+        for (auto i : bench::key_set<int>(distribution, n_items))
         {
             map.insert(i, i);
         }
 
-        // create a lazy lookup range; 
-        // we don't pay memory cost of a massive e.g. vector with all of the lookup keys
-        auto lookup_range = make_range<int>(0, static_cast<int>(n_items));
-
         // output iterator is a no-op;
         // we don't pay for e.g. a std::vector::push_back() on each iteration
         DevNullIterator output_iter{};
 
+        counters.start();
         auto const start = hr_clock::now();
 
-        map.interleaved_multilookup(
-            lookup_range.begin(), 
-            lookup_range.end(), 
-            output_iter,
-            scheduler, 
-            N_STREAMS);
+        if (adaptive)
+        {
+            map.adaptive_interleaved_multilookup(
+                lookup_range.begin(), 
+                lookup_range.end(), 
+                output_iter,
+                scheduler);
+        }
+        else
+        {
+            map.multilookup(
+                lookup_range.begin(), 
+                lookup_range.end(), 
+                output_iter,
+                interleaving,
+                scheduler, 
+                N_STREAMS);
+        }
 
         auto const stop = hr_clock::now();
+        counters.stop();
         auto const as_double = std::chrono::duration_cast<
             std::chrono::duration<double>>(stop - start);
 
@@ -90,10 +141,73 @@ static void BM_interleaved_multilookup(benchmark::State& state)
 
         char message[MSG_BUFFER_SIZE];
         ::snprintf(message, sizeof(message), 
-            "%zu items: %zu ns per lookup", n_items, ns_per_lookup);
+            "%zu items, %s: %zu ns per lookup", 
+            n_items, bench::key_distribution_name(distribution), ns_per_lookup);
 
         state.SetLabel(message);
+
+        // the stream count on which the tuner settled by the end of the run
+        state.counters["n_streams"] = static_cast<double>(adaptive
+            ? map.tuned_n_streams<Scheduler>()
+            : N_STREAMS);
     }
+
+    counters.report(state, n_items);
+}
+
+static void BM_interleaved_multilookup(benchmark::State& state)
+{
+    run_interleaved_multilookup(state, MAP_MAX_CAPACITY, false, SEQUENTIAL);
+}
+
+static void BM_interleaved_multilookup_uncapped(benchmark::State& state)
+{
+    run_interleaved_multilookup(state, MAP_UNCAPPED_CAPACITY, false, STRIDED);
+}
+
+static void BM_interleaved_multilookup_uncapped_huge_pages(benchmark::State& state)
+{
+    run_interleaved_multilookup(
+        state, MAP_UNCAPPED_CAPACITY, false, STRIDED, PrefetchPolicy::SizeHeuristic, PageSize::Huge);
+}
+
+static void BM_interleaved_multilookup_small(benchmark::State& state)
+{
+    run_interleaved_multilookup(state, MAP_UNCAPPED_CAPACITY, false, STRIDED);
+}
+
+static void BM_interleaved_multilookup_small_always_suspend(benchmark::State& state)
+{
+    run_interleaved_multilookup(
+        state, MAP_UNCAPPED_CAPACITY, false, STRIDED, PrefetchPolicy::AlwaysSuspend);
+}
+
+static void BM_interleaved_multilookup_by_distribution(benchmark::State& state)
+{
+    run_interleaved_multilookup(
+        state, MAP_UNCAPPED_CAPACITY, false, static_cast<bench::key_distribution>(state.range(1)));
+}
+
+static void BM_multilookup_by_interleaving(benchmark::State& state)
+{
+    run_interleaved_multilookup(
+        state, 
+        MAP_UNCAPPED_CAPACITY, 
+        false, 
+        STRIDED, 
+        PrefetchPolicy::SizeHeuristic, 
+        PageSize::Base, 
+        static_cast<Interleaving>(state.range(1)));
+}
+
+static void BM_adaptive_interleaved_multilookup(benchmark::State& state)
+{
+    run_interleaved_multilookup(state, MAP_MAX_CAPACITY, true, SEQUENTIAL);
+}
+
+static void BM_adaptive_interleaved_multilookup_uncapped(benchmark::State& state)
+{
+    run_interleaved_multilookup(state, MAP_UNCAPPED_CAPACITY, true, STRIDED);
 }
 
 BENCHMARK(BM_interleaved_multilookup)
@@ -101,4 +215,51 @@ BENCHMARK(BM_interleaved_multilookup)
     ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
     ->UseManualTime();
 
+BENCHMARK(BM_interleaved_multilookup_uncapped)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_interleaved_multilookup_uncapped_huge_pages)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_interleaved_multilookup_small)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_SMALL_ITEMS, MAX_N_SMALL_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_interleaved_multilookup_small_always_suspend)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_SMALL_ITEMS, MAX_N_SMALL_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_interleaved_multilookup_by_distribution)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_N_ITEMS, MAX_N_ITEMS, 4), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->ArgNames({"items", "distribution"})
+    ->UseManualTime();
+
+// compares sequential, coroutine, and AMAC execution of the same lookups
+BENCHMARK(BM_multilookup_by_interleaving)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_N_SMALL_ITEMS, MAX_N_ITEMS, 4), 
+        benchmark::CreateDenseRange(
+            static_cast<std::int64_t>(Interleaving::Sequential), 
+            static_cast<std::int64_t>(Interleaving::Amac), 1)})
+    ->ArgNames({"items", "interleaving"})
+    ->UseManualTime();
+
+BENCHMARK(BM_adaptive_interleaved_multilookup)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_adaptive_interleaved_multilookup_uncapped)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
 BENCHMARK_MAIN();
\ No newline at end of file
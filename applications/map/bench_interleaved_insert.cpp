@@ -0,0 +1,214 @@
+// bench_interleaved_insert.cpp
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <stdcoro/coroutine.hpp>
+#include <libcoro/generator.hpp>
+#include <libbench/key_streams.hpp>
+
+#include "map.hpp"
+#include "scheduler.hpp"
+#include "dev_null_iterator.hpp"
+
+// the number of concurrent instruction streams used in multi-operations
+constexpr static std::size_t const N_STREAMS = 10;
+
+// the upper and lower bound on the number of items in the map;
+// also the number of operations that we perform in this test iteration
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 25;  // ~32 million keys
+
+// the size of the temporary buffer for generating messages
+constexpr static std::size_t MSG_BUFFER_SIZE = 64;
+
+template <typename T>
+coro::generator<std::pair<T, T>> make_kv_range(T begin, T end)
+{
+    for (auto i = begin; i < end; ++i)
+    {
+        co_yield std::pair{i, i};
+    }
+}
+
+static void set_label(
+    benchmark::State& state, 
+    std::size_t const n_items, 
+    std::chrono::nanoseconds const elapsed)
+{
+    auto const ns_per_op = elapsed.count() / static_cast<long int>(n_items);
+
+    char message[MSG_BUFFER_SIZE];
+    ::snprintf(message, sizeof(message), 
+        "%zu items: %zu ns per op", n_items, ns_per_op);
+
+    state.SetLabel(message);
+}
+
+// NOTE: unlike the lookup benchmarks, the map here is not constrained
+// to a maximum capacity; with capped capacity every insert walks a
+// chain of hundreds of entries, which would dominate the measurement
+
+static void BM_sequential_insert(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        Map<int, int> map{};
+
+        auto items = make_kv_range<int>(0, static_cast<int>(n_items));
+
+        auto const start = hr_clock::now();
+
+        for (auto const& [k, v] : items)
+        {
+            map.insert(k, v);
+        }
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+        set_label(state, n_items, 
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start));
+    }
+}
+
+static void BM_interleaved_multiinsert(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        // construct the scheduler for scheduling coroutines; depth is immaterial
+        StaticQueueScheduler<32> scheduler{};
+
+        Map<int, int> map{};
+
+        auto items = make_kv_range<int>(0, static_cast<int>(n_items));
+
+        // output iterator is a no-op;
+        // we don't pay for e.g. a std::vector::push_back() on each iteration
+        DevNullIterator output_iter{};
+
+        auto const start = hr_clock::now();
+
+        map.interleaved_multiinsert(
+            items.begin(), 
+            items.end(), 
+            output_iter,
+            scheduler, 
+            N_STREAMS);
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+        set_label(state, n_items, 
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start));
+    }
+}
+
+static void BM_sequential_remove(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        Map<int, int> map{};
+        for (auto i : bench::sequential_keys<int>(n_items))
+        {
+            map.insert(i, i);
+        }
+
+        auto keys = bench::sequential_keys<int>(n_items);
+
+        auto const start = hr_clock::now();
+
+        for (auto k : keys)
+        {
+            map.remove(k);
+        }
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+        set_label(state, n_items, 
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start));
+    }
+}
+
+static void BM_interleaved_multiremove(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        // construct the scheduler for scheduling coroutines; depth is immaterial
+        StaticQueueScheduler<32> scheduler{};
+
+        Map<int, int> map{};
+        for (auto i : bench::sequential_keys<int>(n_items))
+        {
+            map.insert(i, i);
+        }
+
+        auto keys = bench::sequential_keys<int>(n_items);
+
+        DevNullIterator output_iter{};
+
+        auto const start = hr_clock::now();
+
+        map.interleaved_multiremove(
+            keys.begin(), 
+            keys.end(), 
+            output_iter,
+            scheduler, 
+            N_STREAMS);
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+        set_label(state, n_items, 
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start));
+    }
+}
+
+BENCHMARK(BM_sequential_insert)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_interleaved_multiinsert)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_sequential_remove)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_interleaved_multiremove)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,124 @@
+// bench_lookup_filter.cpp
+// Interleaved multilookup with and without a lookup filter, by hit ratio.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <cstdint>
+#include <stdcoro/coroutine.hpp>
+
+#include "map.hpp"
+#include "scheduler.hpp"
+#include "dev_null_iterator.hpp"
+
+// the number of concurrent instruction streams used in multilookup
+constexpr static std::size_t const N_STREAMS = 10;
+
+// the upper and lower bound on the number of items in the map;
+// also the number of lookups that we perform in this test iteration
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 24;  // ~16 million keys
+
+// the size of the temporary buffer for generating messages
+constexpr static std::size_t MSG_BUFFER_SIZE = 64;
+
+// The i-th key of the key space; keys are scattered across the range of
+// int such that present and absent keys share the buckets of the table
+// (with the identity hash, consecutive keys would fill distinct buckets).
+static auto nth_key(std::size_t const i) -> int
+{
+    // multiplication by an odd constant is a bijection modulo 2^k
+    constexpr std::uint32_t const multiplier = 0x9E3779B1;
+    return static_cast<int>(static_cast<std::uint32_t>(i) * multiplier);
+}
+
+// Generate `n` lookup keys for a map holding the first `n` keys of the
+// key space, in scattered order, of which `hit_percent` are present;
+// `n` must be a power of 2.
+static auto make_lookups(std::size_t const n, std::size_t const hit_percent) -> std::vector<int>
+{
+    constexpr std::size_t const multiplier = 0x9E3779B1;
+
+    std::vector<int> lookups{};
+    lookups.reserve(n);
+    for (auto i = 0ul; i < n; ++i)
+    {
+        auto const index = (i * multiplier) & (n - 1);
+        lookups.push_back(nth_key((i % 100 < hit_percent) ? index : n + index));
+    }
+
+    return lookups;
+}
+
+static void run_filtered_multilookup(benchmark::State& state, bool const filtered)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items     = static_cast<std::size_t>(state.range(0));
+    auto const hit_percent = static_cast<std::size_t>(state.range(1));
+
+    Map<int, int> map{};
+    for (auto i = 0ul; i < n_items; ++i)
+    {
+        map.insert(nth_key(i), static_cast<int>(i));
+    }
+
+    map.set_lookup_filter(filtered);
+
+    auto const lookups = make_lookups(n_items, hit_percent);
+
+    for (auto _ : state)
+    {
+        StaticQueueScheduler<32> scheduler{};
+
+        auto const start = hr_clock::now();
+
+        map.interleaved_multilookup(
+            lookups.begin(),
+            lookups.end(),
+            DevNullIterator{},
+            scheduler,
+            N_STREAMS);
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+
+        auto const as_ns = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(stop - start);
+
+        auto const ns_per_lookup = as_ns.count() / static_cast<long int>(n_items);
+
+        char message[MSG_BUFFER_SIZE];
+        ::snprintf(message, sizeof(message),
+            "%zu items: %ld ns per lookup", n_items, ns_per_lookup);
+
+        state.SetLabel(message);
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n_items));
+}
+
+static void BM_unfiltered_multilookup(benchmark::State& state)
+{
+    run_filtered_multilookup(state, false);
+}
+
+static void BM_filtered_multilookup(benchmark::State& state)
+{
+    run_filtered_multilookup(state, true);
+}
+
+BENCHMARK(BM_unfiltered_multilookup)
+    ->ArgsProduct({benchmark::CreateRange(MIN_N_ITEMS, MAX_N_ITEMS, 4), {0, 50, 70, 100}})
+    ->UseManualTime();
+
+BENCHMARK(BM_filtered_multilookup)
+    ->ArgsProduct({benchmark::CreateRange(MIN_N_ITEMS, MAX_N_ITEMS, 4), {0, 50, 70, 100}})
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,245 @@
+// bench_mixed.cpp
+// Mixed lookup / insert / update / remove workloads, by key distribution.
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+
+#include <libbench/peak_rss.hpp>
+#include <libbench/key_streams.hpp>
+
+#include "map.hpp"
+
+// the upper and lower bound on the number of items preloaded into the map;
+// also the number of operations that we perform in this test iteration
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 25;  // ~32 million keys
+
+// the number of operations generated at once for a workload; larger
+// workloads generate theirs in chunks (outside of the timed region), 
+// such that the operations fit in memory without being replayed
+constexpr static std::size_t const MAX_N_OPS = 1 << 20;
+
+// the size of the temporary buffer for generating messages
+constexpr static std::size_t MSG_BUFFER_SIZE = 64;
+
+// The kinds of operation in a workload.
+enum class OpKind : std::uint8_t
+{
+    Lookup,
+    Insert,
+    Update,
+    Remove
+};
+
+// An individual operation in a workload.
+struct Op
+{
+    int    key;
+    OpKind kind;
+};
+
+// The percentage of the operations in a workload of each kind;
+// the remaining operations are removals.
+struct Mix
+{
+    std::size_t lookup_percent;
+    std::size_t insert_percent;
+    std::size_t update_percent;
+};
+
+// The workloads, selected by the second benchmark argument:
+// 90/10 read-mostly, 50/50 balanced, and insert-heavy loading.
+constexpr static std::array<Mix, 3> const MIXES = {{
+    {90,  4,  4},
+    {50, 20, 20},
+    {10, 80,  5}
+}};
+
+// The distributions of keys, selected by the third benchmark argument.
+static auto const DISTRIBUTIONS = std::vector<std::int64_t>{
+    static_cast<std::int64_t>(bench::key_distribution::uniform),
+    static_cast<std::int64_t>(bench::key_distribution::zipfian),
+    static_cast<std::int64_t>(bench::key_distribution::hotspot),
+    static_cast<std::int64_t>(bench::key_distribution::colliding)
+};
+
+// Generate the next `n_ops` operations of a workload into `ops`, with
+// keys drawn from `key_iter` (see run_mixed()) and kinds from `gen`.
+template <typename KeyIter>
+static auto next_ops(
+    KeyIter&          key_iter,
+    std::mt19937_64&  gen,
+    Mix const&        mix,
+    std::size_t const n_ops,
+    std::vector<Op>&  ops) -> void
+{
+    std::uniform_int_distribution<std::size_t> percent{0, 99};
+
+    ops.clear();
+    for (auto i = 0ul; i < n_ops; ++i, ++key_iter)
+    {
+        auto const key = *key_iter;
+        auto const p   = percent(gen);
+
+        auto kind = OpKind::Remove;
+        if (p < mix.lookup_percent)
+        {
+            kind = OpKind::Lookup;
+        }
+        else if (p < mix.lookup_percent + mix.insert_percent)
+        {
+            kind = OpKind::Insert;
+        }
+        else if (p < mix.lookup_percent + mix.insert_percent + mix.update_percent)
+        {
+            kind = OpKind::Update;
+        }
+
+        ops.push_back(Op{key, kind});
+    }
+}
+
+static void set_label(
+    benchmark::State& state,
+    std::size_t const n_items,
+    std::chrono::nanoseconds const elapsed)
+{
+    auto const ns_per_op = elapsed.count() / static_cast<long int>(n_items);
+
+    char message[MSG_BUFFER_SIZE];
+    ::snprintf(message, sizeof(message),
+        "%zu items: %ld ns per op", n_items, ns_per_op);
+
+    state.SetLabel(message);
+}
+
+// NOTE: as in the insertion benchmarks, the map here is not constrained
+// to a maximum capacity, such that the workload exercises its resizes
+
+static void run_mixed(benchmark::State& state, ResizeMode const resize_mode)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items      = static_cast<std::size_t>(state.range(0));
+    auto const& mix         = MIXES.at(static_cast<std::size_t>(state.range(1)));
+    auto const distribution = static_cast<bench::key_distribution>(state.range(2));
+
+    std::vector<Op> ops{};
+    ops.reserve(std::min(n_items, MAX_N_OPS));
+
+    double      total_seconds = 0.0;
+    std::size_t total_resizes = 0;
+    std::size_t max_peak_rss  = 0;
+    std::size_t n_iterations  = 0;
+    std::size_t total_success = 0;
+
+    for (auto _ : state)
+    {
+        bench::reset_peak_rss();
+
+        Map<int, int> map{std::numeric_limits<std::size_t>::max(), resize_mode};
+        for (auto key : bench::key_set<int>(distribution, n_items))
+        {
+            map.insert(key, key);
+        }
+
+        auto const resizes_before = map.stats().resizes;
+
+        // the number of operations that found (or inserted) their key
+        std::size_t n_succeeded = 0;
+
+        // the operations act on a map that holds the first `n_items` keys
+        // of a key space of twice that size; lookups, updates and removals
+        // of the remaining keys miss, and inserts of them succeed; each
+        // iteration draws the same sequence of operations
+        auto keys     = bench::lookup_keys<int>(distribution, n_items, 2 * n_items, n_items);
+        auto key_iter = keys.begin();
+
+        std::mt19937_64 gen{n_items};
+
+        auto elapsed = hr_clock::duration::zero();
+        for (auto n_done = 0ul; n_done < n_items; n_done += ops.size())
+        {
+            next_ops(key_iter, gen, mix, std::min(n_items - n_done, MAX_N_OPS), ops);
+
+            auto const start = hr_clock::now();
+
+            for (auto const& op : ops)
+            {
+                switch (op.kind)
+                {
+                case OpKind::Lookup:
+                    n_succeeded += static_cast<bool>(map.lookup(op.key));
+                    break;
+                case OpKind::Insert:
+                    n_succeeded += static_cast<bool>(map.insert(op.key, op.key));
+                    break;
+                case OpKind::Update:
+                    n_succeeded += static_cast<bool>(map.update(op.key, op.key));
+                    break;
+                case OpKind::Remove:
+                default:
+                    n_succeeded += static_cast<bool>(map.remove(op.key));
+                    break;
+                }
+            }
+
+            benchmark::DoNotOptimize(n_succeeded);
+
+            elapsed += hr_clock::now() - start;
+        }
+
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(elapsed);
+
+        state.SetIterationTime(as_double.count());
+        set_label(state, n_items,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+
+        total_seconds += as_double.count();
+        total_resizes += map.stats().resizes - resizes_before;
+        total_success += n_succeeded;
+        max_peak_rss   = std::max(max_peak_rss, bench::peak_rss());
+        ++n_iterations;
+    }
+
+    if (n_iterations > 0 && total_seconds > 0.0)
+    {
+        auto const n = static_cast<double>(n_iterations);
+
+        state.counters["ops_per_sec"] = static_cast<double>(n_items) * n / total_seconds;
+        state.counters["resizes"]     = static_cast<double>(total_resizes) / n;
+        state.counters["peak_rss_mb"] = static_cast<double>(max_peak_rss) / (1 << 20);
+        state.counters["hit_ratio"]   = static_cast<double>(total_success) / (static_cast<double>(n_items) * n);
+    }
+}
+
+static void BM_mixed_immediate_resize(benchmark::State& state)
+{
+    run_mixed(state, ResizeMode::Immediate);
+}
+
+static void BM_mixed_incremental_resize(benchmark::State& state)
+{
+    run_mixed(state, ResizeMode::Incremental);
+}
+
+BENCHMARK(BM_mixed_immediate_resize)
+    ->ArgsProduct({benchmark::CreateRange(MIN_N_ITEMS, MAX_N_ITEMS, 2), {0, 1, 2}, DISTRIBUTIONS})
+    ->ArgNames({"items", "mix", "distribution"})
+    ->UseManualTime();
+
+BENCHMARK(BM_mixed_incremental_resize)
+    ->ArgsProduct({benchmark::CreateRange(MIN_N_ITEMS, MAX_N_ITEMS, 2), {0, 1, 2}, DISTRIBUTIONS})
+    ->ArgNames({"items", "mix", "distribution"})
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,109 @@
+// bench_robin_hood.cpp
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string>
+#include <stdcoro/coroutine.hpp>
+#include <libbench/key_streams.hpp>
+
+#include "robin_hood_map.hpp"
+#include "scheduler.hpp"
+#include "dev_null_iterator.hpp"
+
+// the number of concurrent instruction streams used in multilookup
+constexpr static std::size_t const N_STREAMS = 10;
+
+// the upper and lower bound on the number of items in the map;
+// also the number of lookups that we perform in this test iteration
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 25;  // ~32 million keys
+
+// the size of the temporary buffer for generating messages
+constexpr static std::size_t MSG_BUFFER_SIZE = 64;
+
+template <typename Lookup>
+static void run_robin_hood_multilookup(benchmark::State& state, Lookup lookup)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        // construct the map and insert `n_items` elements;
+        // open addressing requires at least one slot per item,
+        // so the map is not constrained to a maximum capacity
+        RobinHoodMap<int, int> map{};
+        for (auto i : bench::sequential_keys<int>(n_items))
+        {
+            map.insert(i, i);
+        }
+
+        // create a lazy lookup range; 
+        // we don't pay memory cost of a massive e.g. vector with all of the lookup keys
+        auto lookup_range = bench::sequential_keys<int>(n_items);
+
+        // output iterator is a no-op;
+        // we don't pay for e.g. a std::vector::push_back() on each iteration
+        DevNullIterator output_iter{};
+
+        auto const start = hr_clock::now();
+
+        lookup(map, lookup_range, output_iter);
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+
+        auto const as_ns = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(stop - start);
+
+        auto const ns_per_lookup = as_ns.count() / static_cast<long int>(n_items);
+
+        char message[MSG_BUFFER_SIZE];
+        ::snprintf(message, sizeof(message), 
+            "%zu items: %zu ns per lookup", n_items, ns_per_lookup);
+
+        state.SetLabel(message);
+    }
+}
+
+static void BM_robin_hood_sequential_multilookup(benchmark::State& state)
+{
+    run_robin_hood_multilookup(state, [](auto& map, auto& lookup_range, auto output_iter) {
+        map.sequential_multilookup(
+            lookup_range.begin(), 
+            lookup_range.end(), 
+            output_iter);
+    });
+}
+
+static void BM_robin_hood_interleaved_multilookup(benchmark::State& state)
+{
+    run_robin_hood_multilookup(state, [](auto& map, auto& lookup_range, auto output_iter) {
+        // construct the scheduler for scheduling coroutines; depth is immaterial
+        StaticQueueScheduler<32> scheduler{};
+
+        map.interleaved_multilookup(
+            lookup_range.begin(), 
+            lookup_range.end(), 
+            output_iter,
+            scheduler, 
+            N_STREAMS);
+    });
+}
+
+BENCHMARK(BM_robin_hood_sequential_multilookup)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_robin_hood_interleaved_multilookup)
+    ->RangeMultiplier(2)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
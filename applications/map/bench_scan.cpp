@@ -0,0 +1,143 @@
+// bench_scan.cpp
+// Full-table scans of a map: iterator, prefetching generator, and parallel.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <algorithm>
+#include <stdcoro/coroutine.hpp>
+
+#include "map.hpp"
+
+// the upper and lower bound on the number of items in the map
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 24;  // ~16 million keys
+
+// the size of the temporary buffer for generating messages
+constexpr static std::size_t MSG_BUFFER_SIZE = 64;
+
+// Insert each of the integers in [0, n) in an order that scatters
+// consecutive insertions across the table, such that entries adjacent
+// in memory are not adjacent in bucket order; `n` must be a power of 2.
+static auto populate(Map<int, long>& map, std::size_t const n) -> void
+{
+    // multiplication by an odd constant is a bijection modulo 2^k
+    constexpr std::size_t const multiplier = 0x9E3779B1;
+    for (auto i = 0ul; i < n; ++i)
+    {
+        auto const key = static_cast<int>((i * multiplier) & (n - 1));
+        map.insert(key, key);
+    }
+}
+
+// Time `scan`, which sums the values in the map, over a fresh map.
+template <typename Scan>
+static void run_scan(benchmark::State& state, Scan scan)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    Map<int, long> map{};
+    populate(map, n_items);
+
+    auto const expected = static_cast<long>(n_items * (n_items - 1) / 2);
+
+    for (auto _ : state)
+    {
+        auto const start = hr_clock::now();
+        auto const sum   = scan(map);
+        auto const stop  = hr_clock::now();
+
+        if (sum != expected)
+        {
+            state.SkipWithError("scan produced an incorrect sum");
+            break;
+        }
+
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+
+        auto const as_ns = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(stop - start);
+
+        auto const ns_per_item = as_ns.count() / static_cast<long int>(n_items);
+
+        char message[MSG_BUFFER_SIZE];
+        ::snprintf(message, sizeof(message),
+            "%zu items: %zu ns per item", n_items, ns_per_item);
+
+        state.SetLabel(message);
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(n_items * sizeof(long)));
+}
+
+static void BM_scan_iterator(benchmark::State& state)
+{
+    run_scan(state, [](Map<int, long>& map) {
+        auto sum = 0l;
+        for (auto [key, value] : map)
+        {
+            sum += value;
+        }
+        return sum;
+    });
+}
+
+static void BM_scan_generator(benchmark::State& state)
+{
+    run_scan(state, [](Map<int, long>& map) {
+        auto sum = 0l;
+        for (auto [key, value] : map.scan())
+        {
+            sum += value;
+        }
+        return sum;
+    });
+}
+
+static void BM_scan_reduce_serial(benchmark::State& state)
+{
+    run_scan(state, [](Map<int, long>& map) {
+        return map.reduce(1, 0l,
+            [](long acc, int const&, long const& value) { return acc + value; },
+            std::plus<long>{});
+    });
+}
+
+static void BM_scan_reduce_parallel(benchmark::State& state)
+{
+    auto const n_threads = std::max(1u, std::thread::hardware_concurrency());
+    run_scan(state, [n_threads](Map<int, long>& map) {
+        return map.reduce(n_threads, 0l,
+            [](long acc, int const&, long const& value) { return acc + value; },
+            std::plus<long>{});
+    });
+}
+
+BENCHMARK(BM_scan_iterator)
+    ->RangeMultiplier(4)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_scan_generator)
+    ->RangeMultiplier(4)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_scan_reduce_serial)
+    ->RangeMultiplier(4)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_scan_reduce_parallel)
+    ->RangeMultiplier(4)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -3,10 +3,13 @@
 #include <benchmark/benchmark.h>
 
 #include <chrono>
+#include <limits>
 #include <string>
+#include <vector>
 #include <cstdlib>
 #include <stdcoro/coroutine.hpp>
-#include <libcoro/generator.hpp>
+#include <libbench/key_streams.hpp>
+#include <libbench/perf_counters.hpp>
 
 #include "map.hpp"
 #include "dev_null_iterator.hpp"
@@ -14,46 +17,61 @@
 // the maximum capacity of the map instance 
 constexpr static std::size_t const MAP_MAX_CAPACITY = 1 << 16;
 
+// the maximum capacity of the uncapped map instance, against which the
+// key distributions are compared; with capped capacity the colliding
+// keys would produce chains of thousands of entries
+constexpr static std::size_t const MAP_UNCAPPED_CAPACITY 
+    = std::numeric_limits<std::size_t>::max();
+
 // the upper and lower bound on the number of items in the map;
 // also the number of lookups that we perform in this test iteration
 constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
 constexpr static std::size_t const MAX_N_ITEMS = 1 << 25;  // ~32 million keys
 
+// the key distributions under which lookups are compared
+constexpr static std::int64_t const MIN_DISTRIBUTION 
+    = static_cast<std::int64_t>(bench::key_distribution::sequential);
+constexpr static std::int64_t const MAX_DISTRIBUTION 
+    = static_cast<std::int64_t>(bench::key_distribution::colliding);
+
 // the size of the temporary buffer for generating messages
 constexpr static std::size_t MSG_BUFFER_SIZE = 64;
 
-template <typename T>
-coro::generator<T> make_range(T begin, T end)
-{
-    for (auto i = begin; i < end; ++i)
-    {
-        co_yield i;
-    }
-}
-
-static void BM_sequential_multilookup(benchmark::State& state)
+static void run_sequential_multilookup(
+    benchmark::State&             state,
+    std::size_t const             max_capacity,
+    bench::key_distribution const distribution)
 {
     using hr_clock = std::chrono::high_resolution_clock;
 
     auto const n_items = static_cast<std::size_t>(state.range(0));
 
+    // draw the lookup keys ahead of time; drawing a key from a skewed
+    // distribution costs as much as the lookup itself, and would otherwise
+    // be measured along with it
+    std::vector<int> lookup_range{};
+    lookup_range.reserve(n_items);
+    for (auto key : bench::lookup_keys<int>(distribution, n_items, n_items, n_items))
+    {
+        lookup_range.push_back(key);
+    }
+
+    bench::perf_counters counters{};
+
     for (auto _ : state)
     {
         // construct the map and insert `n_items` elements
-        Map<int, int> map{MAP_MAX_CAPACITY};
-        for (auto i : make_range<int>(0, static_cast<int>(n_items)))
+        Map<int, int> map{max_capacity};
+        for (auto i : bench::key_set<int>(distribution, n_items))
         {
             map.insert(i, i);
         }
 
-        // create a lazy lookup range; 
-        // we don't pay memory cost of a massive e.g. vector with all of the lookup keys
-        auto lookup_range = make_range<int>(0, static_cast<int>(n_items));
-
         // output iterator is a no-op;
         // we don't pay for e.g. a std::vector::push_back() on each iteration
         DevNullIterator output_iter{};
 
+        counters.start();
         auto const start = hr_clock::now();
 
         map.sequential_multilookup(
@@ -62,6 +80,7 @@ static void BM_sequential_multilookup(benchmark::State& state)
             output_iter);
 
         auto const stop = hr_clock::now();
+        counters.stop();
         auto const as_double = std::chrono::duration_cast<
             std::chrono::duration<double>>(stop - start);
 
@@ -74,10 +93,24 @@ static void BM_sequential_multilookup(benchmark::State& state)
 
         char message[MSG_BUFFER_SIZE];
         ::snprintf(message, sizeof(message), 
-            "%zu items: %zu ns per lookup", n_items, ns_per_lookup);
+            "%zu items, %s: %zu ns per lookup", 
+            n_items, bench::key_distribution_name(distribution), ns_per_lookup);
 
         state.SetLabel(message);
     }
+
+    counters.report(state, n_items);
+}
+
+static void BM_sequential_multilookup(benchmark::State& state)
+{
+    run_sequential_multilookup(state, MAP_MAX_CAPACITY, bench::key_distribution::sequential);
+}
+
+static void BM_sequential_multilookup_by_distribution(benchmark::State& state)
+{
+    run_sequential_multilookup(
+        state, MAP_UNCAPPED_CAPACITY, static_cast<bench::key_distribution>(state.range(1)));
 }
 
 BENCHMARK(BM_sequential_multilookup)
@@ -85,4 +118,11 @@ BENCHMARK(BM_sequential_multilookup)
     ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
     ->UseManualTime();
 
+BENCHMARK(BM_sequential_multilookup_by_distribution)
+    ->ArgsProduct({
+        benchmark::CreateRange(MIN_N_ITEMS, MAX_N_ITEMS, 4), 
+        benchmark::CreateDenseRange(MIN_DISTRIBUTION, MAX_DISTRIBUTION, 1)})
+    ->ArgNames({"items", "distribution"})
+    ->UseManualTime();
+
 BENCHMARK_MAIN();
\ No newline at end of file
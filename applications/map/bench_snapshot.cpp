@@ -0,0 +1,111 @@
+// bench_snapshot.cpp
+// Warm restart of a map: rebuilding it by insertion versus loading a snapshot.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <filesystem>
+#include <stdcoro/coroutine.hpp>
+#include <libbench/key_streams.hpp>
+
+#include "map.hpp"
+#include "dev_null_iterator.hpp"
+
+// the upper and lower bound on the number of items in the map
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 20;  // ~1 million keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 25;  // ~32 million keys
+
+static auto snapshot_path() -> std::string
+{
+    return (std::filesystem::temp_directory_path() / "bench_snapshot.bin").string();
+}
+
+// Time restoring the map with `restore`, followed by a lookup of every
+// key such that the cost of faulting in a mapped snapshot is included.
+template <typename Restore>
+static void run_restart(benchmark::State& state, Restore restore)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    {
+        Map<int, int> map{};
+        for (auto i : bench::sequential_keys<int>(n_items))
+        {
+            map.insert(i, i);
+        }
+
+        map.save(snapshot_path());
+    }
+
+    auto restore_ns = 0.0;
+    auto lookup_ns  = 0.0;
+
+    for (auto _ : state)
+    {
+        auto const start = hr_clock::now();
+
+        restore(n_items, [&](auto& map) {
+            auto const restored = hr_clock::now();
+
+            auto lookup_range = bench::strided_keys<int>(n_items, n_items);
+            map.sequential_multilookup(
+                lookup_range.begin(),
+                lookup_range.end(),
+                DevNullIterator{});
+
+            auto const stop = hr_clock::now();
+
+            state.SetIterationTime(
+                std::chrono::duration_cast<std::chrono::duration<double>>(stop - start).count());
+
+            restore_ns = static_cast<double>(std::chrono::duration_cast<
+                std::chrono::nanoseconds>(restored - start).count());
+            lookup_ns = static_cast<double>(std::chrono::duration_cast<
+                std::chrono::nanoseconds>(stop - restored).count());
+        });
+    }
+
+    state.counters["restore_ms"]    = restore_ns / 1e6;
+    state.counters["ns_per_lookup"] = lookup_ns / static_cast<double>(n_items);
+
+    std::remove(snapshot_path().c_str());
+}
+
+static void BM_restart_by_insertion(benchmark::State& state)
+{
+    run_restart(state, [](std::size_t const n_items, auto serve) {
+        Map<int, int> map{};
+        for (auto i : bench::sequential_keys<int>(n_items))
+        {
+            map.insert(i, i);
+        }
+
+        serve(map);
+    });
+}
+
+static void BM_restart_by_load_mapped(benchmark::State& state)
+{
+    run_restart(state, [](std::size_t const, auto serve) {
+        auto map = Map<int, int>::load_mapped(snapshot_path());
+        serve(map);
+    });
+}
+
+BENCHMARK(BM_restart_by_insertion)
+    ->RangeMultiplier(4)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_restart_by_load_mapped)
+    ->RangeMultiplier(4)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,122 @@
+// bench_string_keys.cpp
+// Interleaved multilookup with heap-allocated versus inline string keys.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <string_view>
+#include <stdcoro/coroutine.hpp>
+
+#include "map.hpp"
+#include "scheduler.hpp"
+#include "inline_string.hpp"
+#include "dev_null_iterator.hpp"
+
+// the number of concurrent instruction streams used in multilookup
+constexpr static std::size_t const N_STREAMS = 10;
+
+// the upper and lower bound on the number of items in the map;
+// also the number of lookups that we perform in this test iteration
+constexpr static std::size_t const MIN_N_ITEMS = 1 << 16;  // ~65,000 keys
+constexpr static std::size_t const MAX_N_ITEMS = 1 << 22;  // ~4 million keys
+
+// the size of the temporary buffer for generating messages
+constexpr static std::size_t MSG_BUFFER_SIZE = 64;
+
+// Generate the i-th key; 20 characters, which exceeds the small-string
+// buffer of std::string (15 characters for libstdc++) but fits inline.
+static auto make_key(std::size_t const i) -> std::string
+{
+    char buffer[32];
+    ::snprintf(buffer, sizeof(buffer), "key-%016zx", i);
+    return std::string{buffer};
+}
+
+template <typename MapType>
+static void run_string_multilookup(benchmark::State& state)
+{
+    using hr_clock = std::chrono::high_resolution_clock;
+
+    auto const n_items = static_cast<std::size_t>(state.range(0));
+
+    std::vector<std::string> keys{};
+    keys.reserve(n_items);
+    for (auto i = 0ul; i < n_items; ++i)
+    {
+        keys.push_back(make_key(i));
+    }
+
+    // probe in an order unrelated to the order of insertion; the probe
+    // strings are copies laid out in probe order, such that reading 
+    // the key for each lookup is not itself a cache miss
+    std::vector<std::string> probes{};
+    probes.reserve(n_items);
+    for (auto i = 0ul; i < n_items; ++i)
+    {
+        probes.push_back(keys[(i * 0x9E3779B1ul) & (n_items - 1)]);
+    }
+
+    std::vector<std::string_view> lookup_keys(probes.begin(), probes.end());
+
+    for (auto _ : state)
+    {
+        StaticQueueScheduler<32> scheduler{};
+
+        MapType map{};
+        for (auto i = 0ul; i < n_items; ++i)
+        {
+            map.insert(keys[i], static_cast<int>(i));
+        }
+
+        auto const start = hr_clock::now();
+
+        map.interleaved_multilookup(
+            lookup_keys.begin(),
+            lookup_keys.end(),
+            DevNullIterator{},
+            scheduler,
+            N_STREAMS);
+
+        auto const stop = hr_clock::now();
+        auto const as_double = std::chrono::duration_cast<
+            std::chrono::duration<double>>(stop - start);
+
+        state.SetIterationTime(as_double.count());
+
+        auto const as_ns = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(stop - start);
+
+        auto const ns_per_lookup = as_ns.count() / static_cast<long int>(n_items);
+
+        char message[MSG_BUFFER_SIZE];
+        ::snprintf(message, sizeof(message),
+            "%zu items: %zu ns per lookup", n_items, ns_per_lookup);
+
+        state.SetLabel(message);
+    }
+}
+
+static void BM_std_string_multilookup(benchmark::State& state)
+{
+    run_string_multilookup<Map<std::string, int, StringHash>>(state);
+}
+
+static void BM_inline_string_multilookup(benchmark::State& state)
+{
+    run_string_multilookup<Map<InlineString<23>, int>>(state);
+}
+
+BENCHMARK(BM_std_string_multilookup)
+    ->RangeMultiplier(4)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK(BM_inline_string_multilookup)
+    ->RangeMultiplier(4)
+    ->Range(MIN_N_ITEMS, MAX_N_ITEMS)
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,170 @@
+// bloom_filter.hpp
+// A blocked Bloom filter over precomputed hashes.
+
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <bit>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+// A Bloom filter in which all of the bits for a key lie within a single
+// cache-line-sized block, such that a query touches exactly one line.
+//
+// Keys are never removed from the filter itself: a key that is removed
+// from the owning structure merely becomes a false positive. The filter
+// instead counts such stale keys, and reports that it should be rebuilt
+// (from the keys that remain) once they make up a large enough fraction
+// of its contents, or once it holds more keys than it was sized for.
+class BlockedBloomFilter
+{
+    // The size (in bytes) of each block; a single cache line.
+    constexpr static std::size_t const BLOCK_SIZE = 64;
+
+    // The number of bits set for (and tested for) each key.
+    constexpr static std::size_t const N_PROBES = 6;
+
+    // The number of bits of the hash that selects each probed bit.
+    constexpr static std::size_t const PROBE_BITS = 9;
+
+    // The maximum number of keys per block before the filter must be
+    // rebuilt; 16 bits per key (with six probes) yields a false positive
+    // rate of roughly 0.1%, while blocks are sized to hold between half
+    // of and all of this number of keys when the filter is built.
+    constexpr static std::size_t const MAX_KEYS_PER_BLOCK = 32;
+
+    // The multipliers used to derive the block and the bits for a key
+    // from its hash; a hash may vary only in its low bits (e.g. that of
+    // std::hash<int>) so each is mixed before its bits are consumed.
+    constexpr static std::uint64_t const BLOCK_MULTIPLIER = 0x9E3779B97F4A7C15ul;
+    constexpr static std::uint64_t const PROBE_MULTIPLIER = 0xBF58476D1CE4E5B9ul;
+
+    struct alignas(BLOCK_SIZE) Block
+    {
+        std::uint64_t words[BLOCK_SIZE / sizeof(std::uint64_t)];
+    };
+
+    static_assert(N_PROBES * PROBE_BITS <= 64, "probes must be drawn from a single word");
+    static_assert((1ul << PROBE_BITS) == BLOCK_SIZE * 8, "a probe must address any bit of a block");
+
+    // the blocks of the filter; empty if the filter is disabled
+    std::vector<Block> blocks;
+
+    // the number of keys added since the filter was last built
+    std::size_t n_keys;
+
+    // the number of those keys that have since been removed
+    std::size_t n_stale;
+
+public:
+    BlockedBloomFilter()
+        : blocks{}, n_keys{0}, n_stale{0} {}
+
+    // non-copyable
+    BlockedBloomFilter(BlockedBloomFilter const&)            = delete;
+    BlockedBloomFilter& operator=(BlockedBloomFilter const&) = delete;
+
+    // non-movable
+    BlockedBloomFilter(BlockedBloomFilter&&)            = delete;
+    BlockedBloomFilter& operator=(BlockedBloomFilter&&) = delete;
+
+    // Determine whether the filter is in use; a disabled
+    // filter reports that it may contain every key.
+    auto enabled() const -> bool
+    {
+        return !blocks.empty();
+    }
+
+    // Clear the filter and size it for `n_expected` keys.
+    auto reset(std::size_t const n_expected) -> void
+    {
+        auto const n_blocks = std::bit_ceil(
+            std::max<std::size_t>(1, (n_expected + MAX_KEYS_PER_BLOCK - 1) / MAX_KEYS_PER_BLOCK));
+
+        blocks.assign(n_blocks, Block{});
+        n_keys  = 0;
+        n_stale = 0;
+    }
+
+    // Release the filter, disabling it.
+    auto disable() -> void
+    {
+        blocks = std::vector<Block>{};
+        n_keys  = 0;
+        n_stale = 0;
+    }
+
+    // Add the key with `hash` to the filter.
+    auto insert(std::size_t const hash) -> void
+    {
+        auto& block = block_at(hash);
+        auto probes = probe_bits(hash);
+        for (auto i = 0ul; i < N_PROBES; ++i, probes >>= PROBE_BITS)
+        {
+            auto const bit = probes & ((1ul << PROBE_BITS) - 1);
+            block.words[bit / 64] |= (1ul << (bit % 64));
+        }
+
+        ++n_keys;
+    }
+
+    // Record that a key previously added to the filter has been removed.
+    auto remove() -> void
+    {
+        ++n_stale;
+    }
+
+    // Determine whether the key with `hash` may have been added to the
+    // filter; if not, the key is definitely absent from the structure.
+    auto may_contain(std::size_t const hash) const -> bool
+    {
+        auto const& block = block_for(hash);
+        auto probes = probe_bits(hash);
+        for (auto i = 0ul; i < N_PROBES; ++i, probes >>= PROBE_BITS)
+        {
+            auto const bit = probes & ((1ul << PROBE_BITS) - 1);
+            if (0 == (block.words[bit / 64] & (1ul << (bit % 64))))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Determine whether the filter should be rebuilt, either because it
+    // holds more keys than it was sized for, or because at least half
+    // of the keys it holds are stale (and so are false positives).
+    auto rebuild_required() const -> bool
+    {
+        return n_keys > blocks.size() * MAX_KEYS_PER_BLOCK || n_stale * 2 > n_keys;
+    }
+
+    // The block queried for the key with `hash`; for prefetching.
+    auto block_for(std::size_t const hash) const -> Block const&
+    {
+        return blocks[((hash * BLOCK_MULTIPLIER) >> 32) & (blocks.size() - 1)];
+    }
+
+    // The total number of bytes occupied by the filter.
+    auto footprint() const -> std::size_t
+    {
+        return blocks.size() * sizeof(Block);
+    }
+
+private:
+    auto block_at(std::size_t const hash) -> Block&
+    {
+        return blocks[((hash * BLOCK_MULTIPLIER) >> 32) & (blocks.size() - 1)];
+    }
+
+    static auto probe_bits(std::size_t const hash) -> std::uint64_t
+    {
+        auto mixed = (hash ^ (hash >> 31)) * PROBE_MULTIPLIER;
+        return mixed ^ (mixed >> 29);
+    }
+};
+
+#endif // BLOOM_FILTER_HPP
@@ -0,0 +1,768 @@
+// concurrent_map.hpp
+// A sharded chaining hashmap implementation that supports concurrent access.
+//
+// The table is striped into a power-of-2 number of shards, selected by the
+// (mixed) high bits of each key's hash. Each shard is an independent chaining
+// table; writers serialize on a per-shard mutex, while readers never block
+// and never write to shared memory: a lookup reads the shard optimistically
+// under a sequence lock and retries if a writer modified the shard meanwhile.
+//
+// Optimistic readers may observe entries that are concurrently unlinked and
+// recycled, so three rules keep every such read harmless:
+//
+//  - entries are allocated from a per-shard slab and recycled only as entries,
+//    and bucket arrays are retired (not freed) on resize, so any pointer a
+//    reader may hold refers to an entry or bucket until the map is destroyed
+//  - every field that a reader may race with is written atomically, 
+//    including the fields of a recycled entry
+//  - keys and values must be trivially copyable, so a torn copy of one is
+//    merely a wrong value, which the failed validation then discards
+
+#ifndef CONCURRENT_MAP_HPP
+#define CONCURRENT_MAP_HPP
+
+#include <bit>
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <stdcoro/coroutine.hpp>
+
+#include <xmmintrin.h>
+
+#include "results.hpp"
+#include "prefetch.hpp"
+#include "throttler.hpp"
+#include "lookup_task.hpp"
+#include "slab_allocator.hpp"
+
+// ----------------------------------------------------------------------------
+// Interface
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher = std::hash<KeyT>>
+class ConcurrentMap
+{
+    static_assert(std::is_trivially_copyable_v<KeyT>,
+        "ConcurrentMap requires trivially copyable keys");
+    static_assert(std::is_trivially_copyable_v<ValueT>,
+        "ConcurrentMap requires trivially copyable values");
+
+    // The default number of shards into which the table is striped.
+    constexpr static auto const DEFAULT_N_SHARDS = 64ul;
+
+    // The maximum number of shards; the shard is selected by 32 bits of the hash.
+    constexpr static auto const MAX_N_SHARDS = 1ul << 32;
+
+    // The initial number of buckets allocated to each shard.
+    constexpr static auto const SHARD_INIT_CAPACITY = 16ul;
+
+    // The maximum load factor for each shard; once exceeded,
+    // the table for the shard is doubled in size.
+    constexpr static auto const MAX_LOAD_FACTOR = 0.5;
+
+    // Multiplier used to mix the bits of the user-provided hash before
+    // selecting a shard; the bucket within the shard is selected by the
+    // low bits of the unmixed hash, so the two selections are independent.
+    constexpr static std::size_t const SHARD_MULTIPLIER = 0x9E3779B97F4A7C15ul;
+
+    struct Entry;
+    struct Bucket;
+    struct Table;
+    struct Shard;
+
+    // The number of shards in the table.
+    std::size_t const n_shards;
+
+    // the shards that compose the table
+    std::unique_ptr<Shard[]> shards;
+
+    // the hash functor used to hash keys
+    Hasher hasher;
+
+public:
+    using LookupKVResult = ::LookupKVCopyResult<KeyT, ValueT>;
+    using RemoveKVResult = ::RemoveKVResult<KeyT, ValueT>;
+
+    using LookupResultType = LookupKVResult;
+    using RemoveResultType = RemoveKVResult;
+
+    ConcurrentMap();
+
+    explicit ConcurrentMap(std::size_t const n_shards_);
+
+    ~ConcurrentMap() = default;
+
+    // non-copyable
+    ConcurrentMap(ConcurrentMap const&)            = delete;
+    ConcurrentMap& operator=(ConcurrentMap const&) = delete;
+
+    // non-movable
+    ConcurrentMap(ConcurrentMap&&)            = delete;
+    ConcurrentMap& operator=(ConcurrentMap&&) = delete;
+
+    // Lookup an item in the map by key; returns a copy of the item.
+    auto lookup(KeyT const& key) const -> LookupKVResult;
+
+    // Insert a new key / value pair into the map;
+    // does not insert if key is already present.
+    // Returns `true` if the pair was inserted.
+    auto insert(KeyT const& key, ValueT value) -> bool;
+
+    // Update the value associated with `key` in the map;
+    // if `key` is not present, key / value pair is inserted.
+    auto update(KeyT const& key, ValueT value) -> void;
+
+    // Remove a key / value pair from the map.
+    auto remove(KeyT const& key) -> RemoveKVResult;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), inserting the result
+    // of each lookup operation into the range `begin_results`.
+    // Each lookup operation is performed sequentially.
+    template <
+        typename BeginInputIter,
+        typename EndInputIter,
+        typename OutputIter>
+    auto sequential_multilookup(
+        BeginInputIter begin_keys,
+        EndInputIter   end_keys,
+        OutputIter     begin_results) const -> void;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), inserting the result
+    // of each lookup operation into the range `begin_results`.
+    // Lookup operations are interleaved on the calling thread
+    // exactly as in Map::interleaved_multilookup(); any number
+    // of threads may do so concurrently, each with its own scheduler.
+    template <
+        typename BeginInputIter,
+        typename EndInputIter,
+        typename OutputIter,
+        typename Scheduler>
+    auto interleaved_multilookup(
+        BeginInputIter    begin_keys,
+        EndInputIter      end_keys,
+        OutputIter        begin_results,
+        Scheduler const&  scheduler,
+        std::size_t const n_streams) const -> void;
+
+    // Query the current number of items in the map;
+    // the count is only exact in the absence of concurrent writers.
+    auto count() const -> std::size_t;
+
+private:
+    template <
+        typename Scheduler,
+        typename OnComplete>
+    auto lookup_task(
+        KeyT const       key,
+        Scheduler const& scheduler,
+        OnComplete       on_complete) const -> LookupKVTask<Scheduler>;
+
+    auto shard_for_hash(std::size_t const hash) const -> Shard&;
+
+    auto resize_if_required(Shard& shard) -> void;
+
+    static auto validate_n_shards(std::size_t const n_shards) -> std::size_t;
+
+    static auto make_entry(Shard& shard, KeyT const& key, ValueT const& value) -> Entry*;
+    static auto recycle_entry(Shard& shard, Entry* entry) -> void;
+
+    static auto bucket_for_hash(Table const& table, std::size_t const hash) -> Bucket&;
+
+    template <typename T>
+    static auto load_relaxed(T& source) -> T;
+};
+
+// ----------------------------------------------------------------------------
+// Auxiliary Types (Internal)
+
+// An individual entry in a shard.
+//
+// The key and value are accessed by optimistic readers through
+// std::atomic_ref, which imposes its own alignment requirements.
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+struct ConcurrentMap<KeyT, ValueT, Hasher>::Entry
+{
+    std::atomic<Entry*> next;
+
+    alignas(std::atomic_ref<KeyT>::required_alignment)   KeyT   key;
+    alignas(std::atomic_ref<ValueT>::required_alignment) ValueT value;
+
+    Entry(KeyT const& key_, ValueT const& value_)
+        : next{nullptr}, key{key_}, value{value_} {}
+};
+
+// The head of a bucket chain in a shard.
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+struct ConcurrentMap<KeyT, ValueT, Hasher>::Bucket
+{
+    // pointer to the first entry in the bucket chain, if any
+    std::atomic<Entry*> first;
+
+    Bucket()
+        : first{nullptr} {}
+};
+
+// The bucket array for a shard, along with its capacity;
+// the two are published to readers together as a single pointer.
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+struct ConcurrentMap<KeyT, ValueT, Hasher>::Table
+{
+    // the number of buckets in this table
+    std::size_t const capacity;
+
+    // the array of buckets that composes the table
+    std::unique_ptr<Bucket[]> buckets;
+
+    explicit Table(std::size_t const capacity_)
+        : capacity{capacity_}
+        , buckets{std::make_unique<Bucket[]>(capacity_)} {}
+};
+
+// An independently-synchronized stripe of the table.
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+struct alignas(64) ConcurrentMap<KeyT, ValueT, Hasher>::Shard
+{
+    // The sequence number for optimistic readers;
+    // odd while a write to the shard is in progress.
+    std::atomic<std::uint64_t> sequence;
+
+    // the table currently in use by this shard
+    std::atomic<Table*> table;
+
+    // the current number of items in this shard
+    std::atomic<std::size_t> n_items;
+
+    // serializes writers to this shard
+    std::mutex mutex;
+
+    // the allocator from which all entries in this shard are allocated
+    SlabAllocator<Entry> allocator;
+
+    // Entries removed from this shard, linked through `next`; entries are
+    // reused from here rather than returned to the allocator, whose own
+    // free list would overwrite a removed entry non-atomically.
+    Entry* free_entries;
+
+    // Every table ever used by this shard; superseded tables are
+    // retained because readers may still be traversing them.
+    std::vector<std::unique_ptr<Table>> tables;
+
+    Shard()
+        : sequence{0}
+        , table{nullptr}
+        , n_items{0}
+        , mutex{}
+        , allocator{}
+        , free_entries{nullptr}
+        , tables{}
+    {
+        tables.push_back(std::make_unique<Table>(SHARD_INIT_CAPACITY));
+        table.store(tables.back().get(), std::memory_order_release);
+    }
+
+    // Begin an optimistic read of the shard;
+    // returns the sequence number to validate against.
+    auto begin_read() const -> std::uint64_t
+    {
+        for (;;)
+        {
+            auto const current = sequence.load(std::memory_order_acquire);
+            if (0 == (current & 1))
+            {
+                return current;
+            }
+
+            // a writer is active; wait for it to complete
+            _mm_pause();
+        }
+    }
+
+    // Determine if the read that began at `begun` observed a consistent shard.
+    auto validate_read(std::uint64_t const begun) const -> bool
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == begun;
+    }
+
+    // Begin a write to the shard; the mutex must be held.
+    auto begin_write() -> void
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    // Complete a write to the shard; the mutex must be held.
+    auto end_write() -> void
+    {
+        sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Exported Definitions
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+ConcurrentMap<KeyT, ValueT, Hasher>::ConcurrentMap()
+    : ConcurrentMap{DEFAULT_N_SHARDS} {}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+ConcurrentMap<KeyT, ValueT, Hasher>::ConcurrentMap(std::size_t const n_shards_)
+    : n_shards{validate_n_shards(n_shards_)}
+    , shards{nullptr}
+    , hasher{}
+{
+    shards = std::make_unique<Shard[]>(n_shards);
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::lookup(KeyT const& key) const -> LookupKVResult
+{
+    auto const hash = hasher(key);
+    auto& shard = shard_for_hash(hash);
+
+    for (;;)
+    {
+        auto const begun = shard.begin_read();
+
+        // a chain longer than the shard itself is one that was
+        // modified under us (and may even be cyclic); stop walking
+        auto const max_steps = shard.n_items.load(std::memory_order_relaxed);
+
+        auto const* table = shard.table.load(std::memory_order_acquire);
+        auto* entry = bucket_for_hash(*table, hash).first.load(std::memory_order_acquire);
+
+        LookupKVResult result{};
+        for (auto steps = 0ul; entry != nullptr && steps <= max_steps; ++steps)
+        {
+            if (key == load_relaxed(entry->key))
+            {
+                result = LookupKVResult{key, load_relaxed(entry->value)};
+                break;
+            }
+
+            entry = entry->next.load(std::memory_order_acquire);
+        }
+
+        if (shard.validate_read(begun))
+        {
+            return result;
+        }
+    }
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::insert(
+    KeyT const& key,
+    ValueT      value) -> bool
+{
+    auto const hash = hasher(key);
+    auto& shard = shard_for_hash(hash);
+
+    std::lock_guard lock{shard.mutex};
+
+    // no other writer may modify the shard, so the chain is read directly
+    auto& bucket = bucket_for_hash(*shard.table.load(std::memory_order_relaxed), hash);
+    for (auto* entry = bucket.first.load(std::memory_order_relaxed);
+         entry != nullptr;
+         entry = entry->next.load(std::memory_order_relaxed))
+    {
+        if (key == entry->key)
+        {
+            // collision; do not insert
+            return false;
+        }
+    }
+
+    auto* new_entry = make_entry(shard, key, value);
+    new_entry->next.store(bucket.first.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    // the new entry is published with release semantics such
+    // that readers that observe it also observe its contents
+    shard.begin_write();
+    bucket.first.store(new_entry, std::memory_order_release);
+    shard.n_items.store(shard.n_items.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    shard.end_write();
+
+    resize_if_required(shard);
+
+    return true;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::update(
+    KeyT const& key,
+    ValueT      value) -> void
+{
+    auto const hash = hasher(key);
+    auto& shard = shard_for_hash(hash);
+
+    std::lock_guard lock{shard.mutex};
+
+    auto& bucket = bucket_for_hash(*shard.table.load(std::memory_order_relaxed), hash);
+    for (auto* entry = bucket.first.load(std::memory_order_relaxed);
+         entry != nullptr;
+         entry = entry->next.load(std::memory_order_relaxed))
+    {
+        if (key == entry->key)
+        {
+            // found a matching key; update the associated value
+            shard.begin_write();
+            std::atomic_ref<ValueT>{entry->value}.store(value, std::memory_order_relaxed);
+            shard.end_write();
+            return;
+        }
+    }
+
+    auto* new_entry = make_entry(shard, key, value);
+    new_entry->next.store(bucket.first.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    // the new entry is published with release semantics such
+    // that readers that observe it also observe its contents
+    shard.begin_write();
+    bucket.first.store(new_entry, std::memory_order_release);
+    shard.n_items.store(shard.n_items.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    shard.end_write();
+
+    resize_if_required(shard);
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::remove(KeyT const& key) -> RemoveKVResult
+{
+    auto const hash = hasher(key);
+    auto& shard = shard_for_hash(hash);
+
+    std::lock_guard lock{shard.mutex};
+
+    auto& bucket = bucket_for_hash(*shard.table.load(std::memory_order_relaxed), hash);
+
+    Entry* prev = nullptr;
+    for (auto* entry = bucket.first.load(std::memory_order_relaxed);
+         entry != nullptr;
+         entry = entry->next.load(std::memory_order_relaxed))
+    {
+        if (key == entry->key)
+        {
+            auto* next = entry->next.load(std::memory_order_relaxed);
+
+            shard.begin_write();
+            if (prev != nullptr)
+            {
+                prev->next.store(next, std::memory_order_relaxed);
+            }
+            else
+            {
+                bucket.first.store(next, std::memory_order_relaxed);
+            }
+            shard.n_items.store(shard.n_items.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+            shard.end_write();
+
+            // readers that reached the entry before it was unlinked fail
+            // validation, so the entry may be recycled immediately
+            auto result = RemoveKVResult{KeyT{entry->key}, ValueT{entry->value}};
+            recycle_entry(shard, entry);
+
+            return result;
+        }
+
+        prev = entry;
+    }
+
+    // key not present
+    return RemoveKVResult{};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename BeginInputIter,
+    typename EndInputIter,
+    typename OutputIter>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::sequential_multilookup(
+    BeginInputIter begin_keys,
+    EndInputIter   end_keys,
+    OutputIter     begin_results) const -> void
+{
+    for (auto iter = begin_keys; iter != end_keys; ++iter)
+    {
+        *begin_results = lookup(*iter);
+        ++begin_results;
+    }
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename BeginInputIter,
+    typename EndInputIter,
+    typename OutputIter,
+    typename Scheduler>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::interleaved_multilookup(
+    BeginInputIter    begin_keys,
+    EndInputIter      end_keys,
+    OutputIter        begin_results,
+    Scheduler const&  scheduler,
+    std::size_t const n_streams) const -> void
+{
+    // instantiate a throttler for this multilookup
+    Throttler throttler{scheduler, n_streams};
+
+    for (auto key_iter = begin_keys; key_iter != end_keys; ++key_iter)
+    {
+        throttler.spawn(
+            lookup_task(
+                *key_iter,
+                scheduler,
+                [&begin_results](LookupKVResult&& result) mutable {
+                    *begin_results = std::move(result);
+                    ++begin_results;
+                }));
+    }
+
+    // run until all lookup tasks complete
+    throttler.run();
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::count() const -> std::size_t
+{
+    std::size_t total = 0;
+    for (auto i = 0ul; i < n_shards; ++i)
+    {
+        total += shards[i].n_items.load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+// ----------------------------------------------------------------------------
+// Internal Definitions
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename Scheduler,
+    typename OnComplete>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::lookup_task(
+    KeyT const       key,
+    Scheduler const& scheduler,
+    OnComplete       on_complete) const -> LookupKVTask<Scheduler>
+{
+    auto const hash = hasher(key);
+    auto& shard = shard_for_hash(hash);
+
+    // identical to lookup(), but the read of the shard now spans several
+    // suspension points; a write to the shard by another thread during
+    // any of them simply causes the entire walk to be retried
+    for (;;)
+    {
+        auto const begun     = shard.begin_read();
+        auto const max_steps = shard.n_items.load(std::memory_order_relaxed);
+
+        auto const* table = shard.table.load(std::memory_order_acquire);
+        auto* bucket = co_await prefetch_and_schedule_on(&bucket_for_hash(*table, hash), scheduler);
+        auto* entry  = bucket->first.load(std::memory_order_acquire);
+
+        LookupKVResult result{};
+        for (auto steps = 0ul; entry != nullptr && steps <= max_steps; ++steps)
+        {
+            entry = co_await prefetch_and_schedule_on(entry, scheduler);
+            if (key == load_relaxed(entry->key))
+            {
+                result = LookupKVResult{key, load_relaxed(entry->value)};
+                break;
+            }
+
+            entry = entry->next.load(std::memory_order_acquire);
+        }
+
+        if (shard.validate_read(begun))
+        {
+            co_return on_complete(std::move(result));
+        }
+    }
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::shard_for_hash(std::size_t const hash) const -> Shard&
+{
+    // NOTE: we rely on the fact that the number of shards is always a power of 2 here
+    return shards[((hash * SHARD_MULTIPLIER) >> 32) & (n_shards - 1)];
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::resize_if_required(Shard& shard) -> void
+{
+    auto const& table = *shard.table.load(std::memory_order_relaxed);
+
+    auto const load_factor = static_cast<double>(shard.n_items.load(std::memory_order_relaxed))
+        / static_cast<double>(table.capacity);
+    if (load_factor <= MAX_LOAD_FACTOR) [[likely]]
+    {
+        return;
+    }
+
+    // double the size of the table on resize
+    auto new_table = std::make_unique<Table>(table.capacity << 1);
+
+    // relinking the entries rewrites the chains of the current table,
+    // which readers may be traversing, so the whole rehash is a write
+    shard.begin_write();
+
+    for (auto i = 0ul; i < table.capacity; ++i)
+    {
+        auto* entry = table.buckets[i].first.load(std::memory_order_relaxed);
+        while (entry != nullptr)
+        {
+            auto* next = entry->next.load(std::memory_order_relaxed);
+
+            auto& new_bucket = bucket_for_hash(*new_table, hasher(entry->key));
+            entry->next.store(new_bucket.first.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            new_bucket.first.store(entry, std::memory_order_relaxed);
+
+            entry = next;
+        }
+    }
+
+    shard.table.store(new_table.get(), std::memory_order_release);
+    shard.tables.push_back(std::move(new_table));
+
+    shard.end_write();
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::validate_n_shards(
+    std::size_t const n_shards) -> std::size_t
+{
+    if (0 == n_shards || n_shards > MAX_N_SHARDS)
+    {
+        throw std::runtime_error{"invalid number of shards"};
+    }
+
+    // validated first, as std::bit_ceil() is undefined beyond 2^63
+    return std::bit_ceil(n_shards);
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::make_entry(
+    Shard&        shard,
+    KeyT const&   key,
+    ValueT const& value) -> Entry*
+{
+    auto* entry = shard.free_entries;
+    if (nullptr == entry)
+    {
+        // storage fresh from the allocator has never been visible to readers
+        return ::new (static_cast<void*>(shard.allocator.allocate())) Entry{key, value};
+    }
+
+    // a recycled entry may still be read by readers that reached it before
+    // it was removed; it is overwritten in place rather than reconstructed
+    shard.free_entries = entry->next.load(std::memory_order_relaxed);
+
+    std::atomic_ref<KeyT>{entry->key}.store(key, std::memory_order_relaxed);
+    std::atomic_ref<ValueT>{entry->value}.store(value, std::memory_order_relaxed);
+    entry->next.store(nullptr, std::memory_order_relaxed);
+
+    return entry;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::recycle_entry(
+    Shard& shard,
+    Entry* entry) -> void
+{
+    entry->next.store(shard.free_entries, std::memory_order_relaxed);
+    shard.free_entries = entry;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::bucket_for_hash(
+    Table const&      table,
+    std::size_t const hash) -> Bucket&
+{
+    // NOTE: we rely on the fact that the number of buckets
+    // in each table is always a power of 2 here
+    return table.buckets[hash & (table.capacity - 1)];
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <typename T>
+auto ConcurrentMap<KeyT, ValueT, Hasher>::load_relaxed(T& source) -> T
+{
+    // the source may be written concurrently (in which case the copy
+    // is discarded by the reader), so it must be read atomically
+    return std::atomic_ref<T>{source}.load(std::memory_order_relaxed);
+}
+
+#endif // CONCURRENT_MAP_HPP
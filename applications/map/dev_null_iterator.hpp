@@ -8,7 +8,9 @@
 #ifndef DEV_NULL_ITERATOR_HPP
 #define DEV_NULL_ITERATOR_HPP
 
+#include <cstddef>
 #include <iterator>
+#include <benchmark/benchmark.h>
 
 // an output iterator that consumes its input
 class DevNullIterator
@@ -19,11 +21,18 @@ public:
     DevNullIterator& operator++() { return *this; }
     DevNullIterator& operator*() { return *this; }
 
+    // supports output to an arbitrary position, e.g. Map::batched_multilookup()
+    DevNullIterator& operator[](std::ptrdiff_t) { return *this; }
+
     template <typename T>
-    DevNullIterator& operator=(T const&)
+    DevNullIterator& operator=(T const& value)
     {
+        // the value is discarded, but the compiler must assume otherwise;
+        // if it could see through the iterator it would elide the work 
+        // that produced the value (e.g. an entire sequential multilookup)
+        benchmark::DoNotOptimize(value);
         return *this;
-    } 
+    }
 };
 
 #endif // DEV_NULL_ITERATOR_HPP
\ No newline at end of file
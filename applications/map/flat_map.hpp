@@ -0,0 +1,838 @@
+// flat_map.hpp
+// An open-addressing hashmap implementation with coroutine support for bulk lookups.
+//
+// The table layout follows that of the "Swiss Tables" described by
+// Matt Kulukundis in his CppCon 2017 talk "Designing a Fast, Efficient,
+// Cache-friendly Hash Table, Step by Step":
+// https://www.youtube.com/watch?v=ncHmEUmJZf4
+//
+// Each slot in the table is accompanied by a single byte of metadata in
+// a separate control array; the control bytes are grouped into aligned
+// groups of 16 that are probed in parallel with SSE2 instructions. Keys
+// and values are stored inline in the slot array, so a hit costs (at most)
+// one cache miss on the control array and one cache miss on the slot.
+
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <bit>
+#include <new>
+#include <limits>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <stdcoro/coroutine.hpp>
+
+#include <emmintrin.h>
+
+#include "results.hpp"
+#include "prefetch.hpp"
+#include "throttler.hpp"
+#include "lookup_task.hpp"
+
+// ----------------------------------------------------------------------------
+// Interface
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher = std::hash<KeyT>>
+class FlatMap
+{
+    // The number of control bytes probed in parallel.
+    constexpr static auto const GROUP_WIDTH = 16ul;
+
+    // The default initial number of slots allocated to internal table.
+    constexpr static auto const DEFAULT_INIT_CAPACITY = GROUP_WIDTH;
+
+    // The default maximum capacity for the map.
+    constexpr static auto const DEFAULT_MAX_CAPACITY = std::numeric_limits<std::size_t>::max();
+
+    // The maximum load factor; once exceeded, a resize operation is
+    // triggered, unless the maximum capacity has already been reached.
+    // Tombstones left behind by removals count toward the load.
+    constexpr static auto const MAX_LOAD_FACTOR = 0.875;
+
+    // Control byte values; a full slot stores the 7-bit tag of its hash.
+    constexpr static std::int8_t const CTRL_EMPTY   = -128;
+    constexpr static std::int8_t const CTRL_DELETED = -2;
+
+    // Multiplier used to mix the bits of the user-provided hash;
+    // std::hash is the identity for integral types on common
+    // implementations, which would leave the tag bits all-zero.
+    constexpr static auto const HASH_MULTIPLIER
+        = static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+
+    struct Slot;
+    struct Group;
+
+    // The current number of items in the map.
+    std::size_t n_items;
+
+    // The current number of tombstones (deleted slots) in the table.
+    std::size_t n_tombstones;
+
+    // The current number of slots in the table.
+    std::size_t capacity;
+
+    // The maximum number of slots beyond which further
+    // insertions will no longer trigger a resize.
+    std::size_t const max_capacity;
+
+    // the array of control bytes, one per slot
+    std::int8_t* control;
+
+    // the array of slots that composes the table
+    Slot* slots;
+
+    // the hash functor used to hash keys
+    Hasher hasher;
+
+public:
+    using LookupKVResult = ::LookupKVResult<KeyT, ValueT>;
+    using InsertKVResult = ::InsertKVResult<KeyT, ValueT>;
+    using RemoveKVResult = ::RemoveKVResult<KeyT, ValueT>;
+
+    struct StatsResult;
+
+    using LookupResultType = LookupKVResult;
+    using InsertResultType = InsertKVResult;
+    using UpdateResultType = InsertKVResult;
+    using RemoveResultType = RemoveKVResult;
+
+    FlatMap();
+
+    explicit FlatMap(std::size_t const max_capacity_);
+
+    ~FlatMap();
+
+    // non-copyable
+    FlatMap(FlatMap const&)            = delete;
+    FlatMap& operator=(FlatMap const&) = delete;
+
+    // non-movable
+    FlatMap(FlatMap&&)            = delete;
+    FlatMap& operator=(FlatMap&&) = delete;
+
+    // Lookup an item in the map by key.
+    auto lookup(KeyT const& key) -> LookupKVResult;
+
+    // Insert a new key / value pair into the map;
+    // does not insert if key is already present.
+    auto insert(KeyT const& key, ValueT value) -> InsertKVResult;
+
+    // Update the value associated with `key` in the map;
+    // if `key` is not present, key / value pair is inserted.
+    auto update(KeyT const& key, ValueT value) -> InsertKVResult;
+
+    // Remove a key / value pair from the map.
+    auto remove(KeyT const& key) -> RemoveKVResult;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), inserting the result
+    // of each lookup operation into the range `begin_results`.
+    // Each lookup operation is performed sequentially.
+    template <
+        typename BeginInputIter,
+        typename EndInputIter,
+        typename OutputIter>
+    auto sequential_multilookup(
+        BeginInputIter begin_keys,
+        EndInputIter   end_keys,
+        OutputIter     begin_results) -> void;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), inserting the result
+    // of each lookup operation into the range `begin_results`.
+    // Lookup operations are spawned as independent coroutines
+    // such that their instruction streams may be interleaved
+    // in order to hide memory stall latency for large maps.
+    template <
+        typename BeginInputIter,
+        typename EndInputIter,
+        typename OutputIter,
+        typename Scheduler>
+    auto interleaved_multilookup(
+        BeginInputIter    begin_keys,
+        EndInputIter      end_keys,
+        OutputIter        begin_results,
+        Scheduler const&  scheduler,
+        std::size_t const n_streams) -> void;
+
+    // Query the current number of items in the map.
+    auto count() const -> std::size_t;
+
+    // Compute some instance-specific statistics and return to the caller.
+    auto stats() const -> StatsResult;
+
+private:
+    template <
+        typename Scheduler,
+        typename OnFound,
+        typename OnNotFound>
+    auto lookup_task(
+        KeyT const       key,
+        Scheduler const& scheduler,
+        OnFound          on_found,
+        OnNotFound       on_not_found) -> LookupKVTask<Scheduler>;
+
+    auto find_slot(KeyT const& key, std::size_t const hash) const -> Slot*;
+    auto find_insert_index(std::size_t const hash) const -> std::size_t;
+
+    auto emplace_at(
+        std::size_t const index,
+        std::size_t const hash,
+        KeyT const&       key,
+        ValueT&           value) -> Slot*;
+
+    auto hash_for_key(KeyT const& key) const -> std::size_t;
+    auto group_count() const -> std::size_t;
+
+    auto perform_resize_if_required() -> void;
+    auto resize_required() const -> bool;
+
+    auto rehash(std::size_t const new_capacity) -> void;
+
+    static auto tag_for_hash(std::size_t const hash) -> std::int8_t;
+
+    static auto allocate_control(std::size_t const n) -> std::int8_t*;
+    static auto free_control(std::int8_t* ctrl) -> void;
+};
+
+// ----------------------------------------------------------------------------
+// Auxiliary Types (Internal)
+
+// An individual slot in the internal hashtable.
+//
+// Slots are left uninitialized until a key / value pair
+// is inserted; the control byte for a slot determines
+// whether or not the slot holds a live key / value pair.
+template <typename KeyT, typename ValueT, typename Hasher>
+struct FlatMap<KeyT, ValueT, Hasher>::Slot
+{
+    KeyT   key;
+    ValueT value;
+
+    Slot(KeyT const& key_, ValueT& value_)
+        : key{key_}, value{value_} {}
+};
+
+// A group of GROUP_WIDTH control bytes, loaded into a single SSE2 register.
+template <typename KeyT, typename ValueT, typename Hasher>
+struct FlatMap<KeyT, ValueT, Hasher>::Group
+{
+    __m128i ctrl;
+
+    explicit Group(std::int8_t const* group_start)
+        : ctrl{_mm_load_si128(reinterpret_cast<__m128i const*>(group_start))} {}
+
+    // A bitmask of the slots in the group with the given tag.
+    std::uint32_t match(std::int8_t const tag) const
+    {
+        auto const matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(tag)), ctrl);
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(matches));
+    }
+
+    // A bitmask of the empty slots in the group.
+    std::uint32_t match_empty() const
+    {
+        return match(CTRL_EMPTY);
+    }
+
+    // A bitmask of the slots in the group that may be (re)used for insertion;
+    // both CTRL_EMPTY and CTRL_DELETED are less than -1, full slots are not.
+    std::uint32_t match_empty_or_deleted() const
+    {
+        auto const matches = _mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl);
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(matches));
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Auxiliary Types (Exported)
+
+// The type returned by FlatMap::stats() operations.
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+struct FlatMap<KeyT, ValueT, Hasher>::StatsResult
+{
+    // The current count of items in the map.
+    std::size_t count;
+
+    // The current capacity of the map (number of slots).
+    std::size_t capacity;
+
+    // The maximum capacity of the map (number of slots).
+    std::size_t max_capacity;
+
+    // The current map load factor.
+    double load_factor;
+
+    // The current number of tombstones in the map.
+    std::size_t tombstones;
+
+    // The maximum number of groups probed to locate an item in the map.
+    std::size_t max_probe_length;
+
+    // The average number of groups probed to locate an item in the map.
+    double avg_probe_length;
+};
+
+// ----------------------------------------------------------------------------
+// Exported Definitions
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+FlatMap<KeyT, ValueT, Hasher>::FlatMap()
+    : FlatMap{DEFAULT_MAX_CAPACITY} {}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+FlatMap<KeyT, ValueT, Hasher>::FlatMap(
+    std::size_t const max_capacity_)
+    : n_items{0}
+    , n_tombstones{0}
+    , capacity{0}
+    , max_capacity{std::max(GROUP_WIDTH, std::bit_floor(max_capacity_))}
+    , control{nullptr}
+    , slots{nullptr}
+    , hasher{}
+{
+    if (0 == max_capacity_)
+    {
+        throw std::runtime_error{"maximum capacity must be nonzero"};
+    }
+
+    // the table always contains at least one full group,
+    // and the number of groups is always a power of 2
+    capacity = std::min(DEFAULT_INIT_CAPACITY, max_capacity);
+    control  = allocate_control(capacity);
+    slots    = std::allocator<Slot>{}.allocate(capacity);
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+FlatMap<KeyT, ValueT, Hasher>::~FlatMap()
+{
+    if constexpr (!std::is_trivially_destructible_v<Slot>)
+    {
+        for (auto i = 0ul; i < capacity; ++i)
+        {
+            if (control[i] >= 0)
+            {
+                slots[i].~Slot();
+            }
+        }
+    }
+
+    std::allocator<Slot>{}.deallocate(slots, capacity);
+    free_control(control);
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::lookup(KeyT const& key) -> LookupKVResult
+{
+    auto* slot = find_slot(key, hash_for_key(key));
+    if (nullptr == slot)
+    {
+        // not found
+        return LookupKVResult{};
+    }
+
+    return LookupKVResult{slot->key, slot->value};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::insert(
+    KeyT const& key,
+    ValueT      value) -> InsertKVResult
+{
+    auto const hash = hash_for_key(key);
+
+    auto* slot = find_slot(key, hash);
+    if (slot != nullptr)
+    {
+        // collision; do not insert
+        return InsertKVResult{slot->key, slot->value, false};
+    }
+
+    // NOTE: unlike the chaining map, a resize moves all items
+    // in the table, so it must occur before we hand out a
+    // reference to the newly-inserted key / value pair
+    perform_resize_if_required();
+
+    auto* new_slot = emplace_at(find_insert_index(hash), hash, key, value);
+    return InsertKVResult{new_slot->key, new_slot->value, true};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::update(
+    KeyT const& key,
+    ValueT      value) -> InsertKVResult
+{
+    auto const hash = hash_for_key(key);
+
+    auto* slot = find_slot(key, hash);
+    if (slot != nullptr)
+    {
+        // found a matching key; update the associated value
+        slot->value = std::move(value);
+        return InsertKVResult{slot->key, slot->value, true};
+    }
+
+    perform_resize_if_required();
+
+    auto* new_slot = emplace_at(find_insert_index(hash), hash, key, value);
+    return InsertKVResult{new_slot->key, new_slot->value, true};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::remove(
+    KeyT const& key) -> RemoveKVResult
+{
+    auto* slot = find_slot(key, hash_for_key(key));
+    if (nullptr == slot)
+    {
+        // key not present in the map
+        return RemoveKVResult{};
+    }
+
+    auto result = RemoveKVResult{std::move(slot->key), std::move(slot->value)};
+    slot->~Slot();
+
+    auto const index       = static_cast<std::size_t>(slot - slots);
+    auto const group_start = index & ~(GROUP_WIDTH - 1);
+
+    // a probe sequence only continues past a group that contains
+    // no empty slots; if this group already contains an empty slot,
+    // no probe sequence can pass through it, so the slot may be
+    // marked empty rather than leaving behind a tombstone
+    if (Group{control + group_start}.match_empty() != 0)
+    {
+        control[index] = CTRL_EMPTY;
+    }
+    else
+    {
+        control[index] = CTRL_DELETED;
+        ++n_tombstones;
+    }
+
+    --n_items;
+
+    return result;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename BeginInputIter,
+    typename EndInputIter,
+    typename OutputIter>
+auto FlatMap<KeyT, ValueT, Hasher>::sequential_multilookup(
+    BeginInputIter begin_keys,
+    EndInputIter   end_keys,
+    OutputIter     begin_results) -> void
+{
+    for (auto iter = begin_keys; iter != end_keys; ++iter)
+    {
+        *begin_results = lookup(*iter);
+        ++begin_results;
+    }
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename BeginInputIter,
+    typename EndInputIter,
+    typename OutputIter,
+    typename Scheduler>
+auto FlatMap<KeyT, ValueT, Hasher>::interleaved_multilookup(
+    BeginInputIter    begin_keys,
+    EndInputIter      end_keys,
+    OutputIter        begin_results,
+    Scheduler const&  scheduler,
+    std::size_t const n_streams) -> void
+{
+    // instantiate a throttler for this multilookup
+    Throttler throttler{scheduler, n_streams};
+
+    for (auto key_iter = begin_keys; key_iter != end_keys; ++key_iter)
+    {
+        throttler.spawn(
+            lookup_task(
+                *key_iter,
+                scheduler,
+                [&begin_results](KeyT const& k, ValueT& v) mutable {
+                    *begin_results = LookupKVResult{k, v};
+                    ++begin_results;
+                },
+                [&begin_results]() mutable {
+                    *begin_results = LookupKVResult{};
+                    ++begin_results;
+                }));
+    }
+
+    // run until all lookup tasks complete
+    throttler.run();
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::count() const -> std::size_t
+{
+    return n_items;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::stats() const -> StatsResult
+{
+    StatsResult results{};
+
+    results.count        = n_items;
+    results.capacity     = capacity;
+    results.max_capacity = max_capacity;
+    results.tombstones   = n_tombstones;
+
+    results.load_factor
+        = static_cast<double>(n_items) / static_cast<double>(capacity);
+
+    auto const mask = group_count() - 1;
+
+    std::size_t max_length = 0;
+    std::size_t sum_length = 0;
+    for (auto i = 0ul; i < capacity; ++i)
+    {
+        if (control[i] < 0)
+        {
+            continue;
+        }
+
+        // replay the probe sequence for this item to compute its length
+        auto const target = i / GROUP_WIDTH;
+        auto group        = hash_for_key(slots[i].key) & mask;
+
+        std::size_t length = 1;
+        for (; group != target; ++length)
+        {
+            group = (group + length) & mask;
+        }
+
+        max_length = std::max(length, max_length);
+        sum_length += length;
+    }
+
+    results.max_probe_length = max_length;
+    results.avg_probe_length = (0 == n_items)
+        ? 0.0
+        : static_cast<double>(sum_length) / static_cast<double>(n_items);
+
+    return results;
+}
+
+// ----------------------------------------------------------------------------
+// Internal Definitions
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename Scheduler,
+    typename OnFound,
+    typename OnNotFound>
+auto FlatMap<KeyT, ValueT, Hasher>::lookup_task(
+    KeyT const       key,
+    Scheduler const& scheduler,
+    OnFound          on_found,
+    OnNotFound       on_not_found) -> LookupKVTask<Scheduler>
+{
+    auto const hash = hash_for_key(key);
+    auto const tag  = tag_for_hash(hash);
+    auto const mask = group_count() - 1;
+
+    auto group = hash & mask;
+    for (auto probe = 0ul; probe <= mask; ++probe)
+    {
+        auto* ctrl = co_await prefetch_and_schedule_on(control + group * GROUP_WIDTH, scheduler);
+
+        // NOTE: the group is not held across suspension points
+        // because the coroutine frame is not guaranteed to
+        // satisfy the alignment requirement of the SSE register
+        auto matches         = Group{ctrl}.match(tag);
+        auto const has_empty = (Group{ctrl}.match_empty() != 0);
+
+        for (; matches != 0; matches &= (matches - 1))
+        {
+            auto const index = group * GROUP_WIDTH
+                + static_cast<std::size_t>(std::countr_zero(matches));
+
+            auto* slot = co_await prefetch_and_schedule_on(slots + index, scheduler);
+            if (key == slot->key)
+            {
+                co_return on_found(slot->key, slot->value);
+            }
+        }
+
+        if (has_empty)
+        {
+            // the probe sequence terminates at the first non-full group
+            break;
+        }
+
+        group = (group + probe + 1) & mask;
+    }
+
+    // not found
+    co_return on_not_found();
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::find_slot(
+    KeyT const&       key,
+    std::size_t const hash) const -> Slot*
+{
+    auto const tag  = tag_for_hash(hash);
+    auto const mask = group_count() - 1;
+
+    // triangular probing over groups visits every group
+    // exactly once because the group count is a power of 2
+    auto group = hash & mask;
+    for (auto probe = 0ul; probe <= mask; ++probe)
+    {
+        Group const g{control + group * GROUP_WIDTH};
+        for (auto matches = g.match(tag); matches != 0; matches &= (matches - 1))
+        {
+            auto* slot = slots + group * GROUP_WIDTH
+                + static_cast<std::size_t>(std::countr_zero(matches));
+            if (key == slot->key)
+            {
+                return slot;
+            }
+        }
+
+        if (g.match_empty() != 0)
+        {
+            // the probe sequence terminates at the first non-full group
+            return nullptr;
+        }
+
+        group = (group + probe + 1) & mask;
+    }
+
+    // probed every group in the table
+    return nullptr;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::find_insert_index(
+    std::size_t const hash) const -> std::size_t
+{
+    auto const mask = group_count() - 1;
+
+    auto group = hash & mask;
+    for (auto probe = 0ul; probe <= mask; ++probe)
+    {
+        auto const available = Group{control + group * GROUP_WIDTH}.match_empty_or_deleted();
+        if (available != 0)
+        {
+            return group * GROUP_WIDTH + static_cast<std::size_t>(std::countr_zero(available));
+        }
+
+        group = (group + probe + 1) & mask;
+    }
+
+    // unreachable so long as n_items < capacity
+    throw std::runtime_error{"maximum capacity exceeded"};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::emplace_at(
+    std::size_t const index,
+    std::size_t const hash,
+    KeyT const&       key,
+    ValueT&           value) -> Slot*
+{
+    if (CTRL_DELETED == control[index])
+    {
+        --n_tombstones;
+    }
+
+    auto* slot = ::new (static_cast<void*>(slots + index)) Slot{key, value};
+    control[index] = tag_for_hash(hash);
+    ++n_items;
+
+    return slot;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::hash_for_key(KeyT const& key) const -> std::size_t
+{
+    return hasher(key) * HASH_MULTIPLIER;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::group_count() const -> std::size_t
+{
+    // NOTE: we rely on the fact that the number of groups
+    // in the internal table is always a power of 2
+    return capacity / GROUP_WIDTH;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::perform_resize_if_required() -> void
+{
+    if (!resize_required()) [[likely]]
+    {
+        return;
+    }
+
+    if ((capacity << 1) <= max_capacity)
+    {
+        // double the size of the table on resize
+        rehash(capacity << 1);
+    }
+    else if (n_tombstones > (capacity / GROUP_WIDTH))
+    {
+        // at maximum capacity; reclaim tombstones in place
+        rehash(capacity);
+    }
+    else if (n_items == capacity)
+    {
+        // open addressing cannot exceed one item per slot
+        throw std::runtime_error{"maximum capacity exceeded"};
+    }
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::resize_required() const -> bool
+{
+    return (static_cast<double>(n_items + n_tombstones + 1)
+        / static_cast<double>(capacity)) > MAX_LOAD_FACTOR;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::rehash(std::size_t const new_capacity) -> void
+{
+    auto* old_control = control;
+    auto* old_slots   = slots;
+
+    auto const old_capacity = capacity;
+
+    control  = allocate_control(new_capacity);
+    slots    = std::allocator<Slot>{}.allocate(new_capacity);
+    capacity = new_capacity;
+
+    n_tombstones = 0;
+
+    for (auto i = 0ul; i < old_capacity; ++i)
+    {
+        if (old_control[i] < 0)
+        {
+            continue;
+        }
+
+        auto& old_slot   = old_slots[i];
+        auto const hash  = hash_for_key(old_slot.key);
+        auto const index = find_insert_index(hash);
+
+        ::new (static_cast<void*>(slots + index)) Slot{std::move(old_slot)};
+        control[index] = tag_for_hash(hash);
+
+        old_slot.~Slot();
+    }
+
+    std::allocator<Slot>{}.deallocate(old_slots, old_capacity);
+    free_control(old_control);
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::tag_for_hash(std::size_t const hash) -> std::int8_t
+{
+    // the top 7 bits of the hash; the low bits select the group
+    return static_cast<std::int8_t>(hash >> (std::numeric_limits<std::size_t>::digits - 7));
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::allocate_control(std::size_t const n) -> std::int8_t*
+{
+    // groups are loaded with aligned SSE2 loads
+    auto* ctrl = static_cast<std::int8_t*>(
+        ::operator new(n, std::align_val_t{GROUP_WIDTH}));
+    std::memset(ctrl, CTRL_EMPTY, n);
+    return ctrl;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto FlatMap<KeyT, ValueT, Hasher>::free_control(std::int8_t* ctrl) -> void
+{
+    ::operator delete(ctrl, std::align_val_t{GROUP_WIDTH});
+}
+
+#endif // FLAT_MAP_HPP
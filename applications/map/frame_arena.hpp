@@ -0,0 +1,130 @@
+// frame_arena.hpp
+// A fixed pool of coroutine frames owned by a single batch of operations.
+//
+// An interleaved operation on the map spawns one coroutine per key, but
+// only a bounded number of them are alive at once; the arena holds one
+// slot for each, and hands slots back out in LIFO order such that the
+// frame of a new coroutine is the (still cached) frame of the last one
+// to complete. Frames that do not fit, or that exceed the number of slots,
+// fall back to the thread-caching allocator.
+
+#ifndef FRAME_ARENA_HPP
+#define FRAME_ARENA_HPP
+
+#include <new>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+#include <libcoro/recycling_allocator.hpp>
+
+class FrameArena
+{
+    // The granularity of a slot; a frame never shares a cache line.
+    constexpr static std::size_t const SLOT_ALIGNMENT = 64;
+
+    // Precedes each frame; identifies the arena to which it returns.
+    struct alignas(alignof(std::max_align_t)) Header
+    {
+        // the arena from which the frame was allocated, or nullptr
+        FrameArena* arena;
+    };
+
+    // the number of slots in the arena
+    std::size_t const n_slots;
+
+    // the size of each slot (with its header); fixed by the first frame
+    std::size_t slot_size;
+
+    // the storage for all slots, allocated with the first frame
+    std::byte* slots;
+
+    // the slots that are not in use, most recently freed last
+    std::vector<std::byte*> free_slots;
+
+    // the number of frames that did not fit in the arena
+    std::size_t n_fallbacks;
+
+public:
+    explicit FrameArena(std::size_t const n_slots_)
+        : n_slots{n_slots_}
+        , slot_size{0}
+        , slots{nullptr}
+        , free_slots{}
+        , n_fallbacks{0} {}
+
+    ~FrameArena()
+    {
+        // every frame must be freed before the arena
+        assert(free_slots.size() == ((nullptr == slots) ? 0 : n_slots));
+        ::operator delete(slots, std::align_val_t{SLOT_ALIGNMENT});
+    }
+
+    // non-copyable
+    FrameArena(FrameArena const&)            = delete;
+    FrameArena& operator=(FrameArena const&) = delete;
+
+    // non-movable
+    FrameArena(FrameArena&&)            = delete;
+    FrameArena& operator=(FrameArena&&) = delete;
+
+    // Allocate a frame of `n` bytes from the arena.
+    void* allocate(std::size_t const n)
+    {
+        auto const size = sizeof(Header) + n;
+        if (nullptr == slots && n_slots > 0)
+        {
+            // all of the frames in a batch are those of the same coroutine
+            slot_size = (size + SLOT_ALIGNMENT - 1) & ~(SLOT_ALIGNMENT - 1);
+            slots = static_cast<std::byte*>(
+                ::operator new(slot_size * n_slots, std::align_val_t{SLOT_ALIGNMENT}));
+
+            free_slots.reserve(n_slots);
+            for (auto i = n_slots; i-- > 0;)
+            {
+                free_slots.push_back(slots + i * slot_size);
+            }
+        }
+
+        if (size > slot_size || free_slots.empty())
+        {
+            ++n_fallbacks;
+            return allocate_unpooled(n);
+        }
+
+        auto* slot = free_slots.back();
+        free_slots.pop_back();
+
+        auto* h = ::new (slot) Header{this};
+        return h + 1;
+    }
+
+    // Allocate a frame of `n` bytes that does not belong to any arena.
+    static void* allocate_unpooled(std::size_t const n)
+    {
+        auto* block = coro::recycling_allocator::allocate(sizeof(Header) + n);
+        auto* h = ::new (block) Header{nullptr};
+        return h + 1;
+    }
+
+    // Free a frame of `n` bytes allocated by allocate() or allocate_unpooled().
+    static void deallocate(void* ptr, std::size_t const n)
+    {
+        auto* h = static_cast<Header*>(ptr) - 1;
+        if (nullptr == h->arena)
+        {
+            coro::recycling_allocator::deallocate(h, sizeof(Header) + n);
+            return;
+        }
+
+        h->arena->free_slots.push_back(reinterpret_cast<std::byte*>(h));
+    }
+
+    // The number of frames that were allocated outside of the arena.
+    auto get_n_fallbacks() const -> std::size_t
+    {
+        return n_fallbacks;
+    }
+};
+
+#endif // FRAME_ARENA_HPP
@@ -0,0 +1,114 @@
+// huge_pages.hpp
+// Allocation of memory backed by 2MB (rather than 4KB) pages.
+//
+// A structure that is probed at random (such as the bucket array of a
+// large map) touches a distinct page on nearly every access; with 4KB
+// pages its working set quickly outgrows the reach of the dTLB, and a
+// software prefetch that misses in the TLB is dropped by many cores.
+//
+// Huge pages are requested of the kernel on Linux only; elsewhere the
+// memory is merely aligned to a huge page (and zero-filled), such that
+// PageSize::Huge remains available, if without effect.
+
+#ifndef HUGE_PAGES_HPP
+#define HUGE_PAGES_HPP
+
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// The size of the pages with which memory is backed.
+enum class PageSize
+{
+    // the base page size of the system (typically 4KB)
+    Base,
+
+    // 2MB pages; reserved huge pages are used if any are available,
+    // and transparent huge pages are requested for the region otherwise
+    Huge
+};
+
+// The size (and alignment) of a huge page.
+inline constexpr std::size_t const HUGE_PAGE_SIZE = 1ul << 21;
+
+// Round `n_bytes` up to a whole number of huge pages.
+inline auto huge_page_length(std::size_t const n_bytes) -> std::size_t
+{
+    return (n_bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+// Allocate zero-filled memory for `n_bytes` that is backed by huge pages
+// where the system permits; throws std::bad_alloc on failure. The memory
+// must be released with free_huge_pages() with the same `n_bytes`.
+inline auto allocate_huge_pages(std::size_t const n_bytes) -> void*
+{
+    auto const length = huge_page_length(n_bytes);
+
+#if defined(__linux__)
+
+    // reserved huge pages (vm.nr_hugepages) are guaranteed to be huge
+    auto* region = ::mmap(nullptr, length,
+        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (region != MAP_FAILED)
+    {
+        return region;
+    }
+
+    // otherwise, the kernel may only back a region with transparent
+    // huge pages where it is aligned to a huge page, so over-allocate
+    // and trim the region to an aligned one of the requested length
+    auto* unaligned = ::mmap(nullptr, length + HUGE_PAGE_SIZE,
+        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == unaligned)
+    {
+        throw std::bad_alloc{};
+    }
+
+    auto const base    = reinterpret_cast<std::uintptr_t>(unaligned);
+    auto const aligned = (base + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+
+    if (aligned != base)
+    {
+        ::munmap(unaligned, aligned - base);
+    }
+
+    auto const tail = (base + length + HUGE_PAGE_SIZE) - (aligned + length);
+    if (tail != 0)
+    {
+        ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+
+    region = reinterpret_cast<void*>(aligned);
+
+    // advisory only; the region remains usable (with base pages)
+    // if transparent huge pages are disabled on this system
+    ::madvise(region, length, MADV_HUGEPAGE);
+
+    return region;
+#else
+    auto* region = ::operator new(length, std::align_val_t{HUGE_PAGE_SIZE});
+    std::memset(region, 0, length);
+    return region;
+#endif
+}
+
+// Release memory returned by allocate_huge_pages().
+inline auto free_huge_pages(void* region, std::size_t const n_bytes) -> void
+{
+    if (region != nullptr)
+    {
+#if defined(__linux__)
+        ::munmap(region, huge_page_length(n_bytes));
+#else
+        static_cast<void>(n_bytes);
+        ::operator delete(region, std::align_val_t{HUGE_PAGE_SIZE});
+#endif
+    }
+}
+
+#endif // HUGE_PAGES_HPP
@@ -0,0 +1,109 @@
+// inline_string.hpp
+// String key types and hashers that support heterogeneous lookup.
+
+#ifndef INLINE_STRING_HPP
+#define INLINE_STRING_HPP
+
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <functional>
+#include <string_view>
+
+// A string of at most `Capacity` characters, stored entirely inline.
+//
+// Used as a map key, the characters live in the map entry itself, such
+// that comparing keys touches no memory beyond the entry; a std::string
+// longer than its (implementation-defined) small-string buffer instead
+// points elsewhere, costing a second cache miss on every comparison.
+// The type is trivially copyable, and so may be saved in map snapshots.
+template <std::size_t Capacity = 23>
+class InlineString
+{
+    static_assert(Capacity <= std::numeric_limits<std::uint8_t>::max(), 
+        "InlineString capacity must fit in a byte");
+
+    // the characters of the string; not NUL-terminated
+    char chars[Capacity];
+
+    // the number of characters in the string
+    std::uint8_t length;
+
+public:
+    InlineString()
+        : chars{}, length{0} {}
+
+    // Construct from `str`; throws std::length_error if it does not fit.
+    InlineString(std::string_view const str)
+        : chars{}, length{0}
+    {
+        if (str.size() > Capacity)
+        {
+            throw std::length_error{"string exceeds InlineString capacity"};
+        }
+
+        std::memcpy(chars, str.data(), str.size());
+        length = static_cast<std::uint8_t>(str.size());
+    }
+
+    InlineString(char const* str)
+        : InlineString{std::string_view{str}} {}
+
+    InlineString(std::string const& str)
+        : InlineString{std::string_view{str}} {}
+
+    auto view() const -> std::string_view
+    {
+        return std::string_view{chars, length};
+    }
+
+    operator std::string_view() const
+    {
+        return view();
+    }
+
+    auto size() const -> std::size_t
+    {
+        return length;
+    }
+
+    constexpr static auto capacity() -> std::size_t
+    {
+        return Capacity;
+    }
+
+    // compares with any other InlineString, std::string, or string literal
+    auto operator==(std::string_view const rhs) const -> bool
+    {
+        return view() == rhs;
+    }
+};
+
+// A transparent hasher for std::string keys, which allows a map
+// to be queried by std::string_view without constructing a string.
+struct StringHash
+{
+    using is_transparent = void;
+
+    auto operator()(std::string_view const str) const noexcept -> std::size_t
+    {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+// InlineString hashes as the equivalent std::string_view, and so
+// (transparently) supports lookup by std::string_view by default.
+template <std::size_t Capacity>
+struct std::hash<InlineString<Capacity>>
+{
+    using is_transparent = void;
+
+    auto operator()(std::string_view const str) const noexcept -> std::size_t
+    {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+#endif // INLINE_STRING_HPP
@@ -0,0 +1,123 @@
+// lookup_task.hpp
+// The task type used to represent interleaved operations on the map types.
+
+#ifndef LOOKUP_TASK_HPP
+#define LOOKUP_TASK_HPP
+
+#include <memory>
+#include <exception>
+#include <stdcoro/coroutine.hpp>
+
+#include "throttler.hpp"
+
+// The task type used to represent interleaved operations
+// in e.g. Map::interleaved_multilookup() and Map::interleaved_multiinsert().
+template <typename Scheduler>
+class LookupKVTask
+{
+public:
+    struct promise_type;
+    using CoroHandle = stdcoro::coroutine_handle<promise_type>;
+
+    LookupKVTask() = delete;
+
+    // IMPT: not an RAII type; the throttler instance takes
+    // ownership of the LookupKVTask immediately upon spawning it.
+    ~LookupKVTask() = default;
+
+    LookupKVTask(LookupKVTask const&) = delete;
+
+    LookupKVTask(LookupKVTask&& rhs)
+        : handle{rhs.handle}
+    {
+        rhs.handle = nullptr;
+    }
+
+    struct promise_type
+    {
+        // pointer to the owning throttler instance for this promise
+        Throttler<Scheduler>* owning_throttler{nullptr};
+
+        // utilize the custom recycling allocator
+        void* operator new(std::size_t n)
+        {
+            return FrameArena::allocate_unpooled(n);
+        }
+
+        // utilize the frame arena of the throttler that spawns the task,
+        // for a task declared as e.g. task(std::allocator_arg_t, Throttler&, ...)
+        template <typename... Args>
+        void* operator new(
+            std::size_t n, 
+            std::allocator_arg_t, 
+            Throttler<Scheduler>& throttler, 
+            Args const&...)
+        {
+            return throttler.frame_arena().allocate(n);
+        }
+
+        // as above, for a task that is a member function
+        template <typename Owner, typename... Args>
+        void* operator new(
+            std::size_t n, 
+            Owner const&,
+            std::allocator_arg_t, 
+            Throttler<Scheduler>& throttler, 
+            Args const&...)
+        {
+            return throttler.frame_arena().allocate(n);
+        }
+
+        void operator delete(void* ptr, std::size_t n)
+        {
+            FrameArena::deallocate(ptr, n);
+        }
+
+        LookupKVTask get_return_object()
+        {
+            return LookupKVTask{*this};
+        }
+
+        auto initial_suspend()
+        {
+            return std::suspend_always{};
+        }
+
+        auto final_suspend()
+        {
+            return std::suspend_never{};
+        }
+
+        void return_void()
+        {
+            owning_throttler->on_task_complete();
+        }
+
+        void unhandled_exception() noexcept
+        {
+            std::terminate();
+        }
+    };
+
+    // make the throttler the "owner" of this coroutine
+    auto set_owner(Throttler<Scheduler>* owner)
+    {
+        auto result = handle;
+
+        // modify the promise to point to the owning throttler
+        handle.promise().owning_throttler = owner;
+
+        // reset our handle
+        handle = nullptr;
+
+        return result;
+    }
+
+private:
+    CoroHandle handle;
+
+    LookupKVTask(promise_type& p)
+        : handle{CoroHandle::from_promise(p)} {}
+};
+
+#endif // LOOKUP_TASK_HPP
@@ -8,29 +8,91 @@
 #ifndef MAP_HPP
 #define MAP_HPP
 
+#include <bit>
+#include <new>
+#include <string>
+#include <chrono>
+#include <thread>
 #include <vector>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <exception>
+#include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <optional>
 #include <stdexcept>
 #include <functional>
+#include <type_traits>
 #include <stdcoro/coroutine.hpp>
+#include <libcoro/amac.hpp>
+#include <libcoro/task.hpp>
+#include <libcoro/generator.hpp>
 
+#include <xmmintrin.h>
+
+#include "results.hpp"
+#include "mapped_file.hpp"
 #include "prefetch.hpp"
+#include "bloom_filter.hpp"
+#include "huge_pages.hpp"
 #include "throttler.hpp"
-#include "recycling_allocator.hpp"
+#include "lookup_task.hpp"
+#include "stream_tuner.hpp"
+#include "slab_allocator.hpp"
 
 // ----------------------------------------------------------------------------
 // Misc. Helper Declarations
 
 static std::size_t next_power_of_2(std::size_t n);
 
+// Determine whether `Hasher` permits lookup by keys of other types.
+template <typename Hasher, typename = void>
+struct is_transparent_hasher : std::false_type {};
+
+template <typename Hasher>
+struct is_transparent_hasher<Hasher, std::void_t<typename Hasher::is_transparent>> 
+    : std::true_type {};
+
+template <typename Hasher>
+inline constexpr bool is_transparent_hasher_v = is_transparent_hasher<Hasher>::value;
+
 // ----------------------------------------------------------------------------
 // Interface
 
+// The strategy used to grow the internal table of a Map.
+enum class ResizeMode
+{
+    // rehash every entry into the new table within the
+    // insertion that triggers the resize (stop-the-world)
+    Immediate,
+
+    // keep both tables alive and migrate a bounded number of
+    // buckets from the old table on each subsequent mutation
+    Incremental
+};
+
+// The means by which the lookups of a multilookup are executed.
+enum class Interleaving
+{
+    // one lookup at a time, leaving each access to the cache
+    Sequential,
+
+    // each lookup a coroutine that suspends on each of its prefetches
+    Coroutine,
+
+    // a fixed ring of lookup states stepped round-robin (AMAC)
+    Amac
+};
+
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher = std::hash<KeyT>>
+    typename Hasher = std::hash<KeyT>,
+    template <typename> typename EntryAllocator = SlabAllocator>
 class Map
 {
     // The default initial number of buckets allocated to internal table.
@@ -44,11 +106,95 @@ class Map
     // triggered, unless the maximum capacity has already been reached.
     constexpr static auto const MAX_LOAD_FACTOR = 0.5;
 
+    // The multiplier used to derive a bucket tag from a key's hash;
+    // the bucket index consumes the low bits of the hash (which are
+    // the only bits that vary for e.g. std::hash<int>) so the tag is
+    // taken from the high bits of the hash after mixing.
+    constexpr static std::size_t const TAG_MULTIPLIER = 0x9E3779B97F4A7C15ul;
+
+    // The size (in bytes) of the bucket array beyond which interleaved
+    // lookups prefetch the bucket slot in a stage of its own; below it,
+    // the array is assumed to be cached and the extra suspension is wasted.
+    constexpr static std::size_t const STAGED_BUCKET_THRESHOLD = 1ul << 21;
+
+    // The default footprint (in bytes) of the table and its entries 
+    // beyond which interleaved operations suspend on their prefetches; 
+    // roughly the size of a per-core L2 cache.
+    constexpr static std::size_t const DEFAULT_CACHE_BUDGET = 1ul << 20;
+
+    // The default maximum number of items in the map; items are never
+    // evicted unless a smaller budget is set with set_item_budget().
+    constexpr static std::size_t const DEFAULT_ITEM_BUDGET = std::numeric_limits<std::size_t>::max();
+
+    // The number of bits in the tag of a bucket (see Bucket::first_tag);
+    // the remaining bit of the 32-bit word holds the reference bit.
+    constexpr static std::size_t const TAG_BITS = 31;
+
+    // Identifies (and versions) the file format written by save().
+    constexpr static std::uint64_t const SNAPSHOT_MAGIC   = 0x50414d2d4f524f43ul;  // "CORO-MAP"
+    constexpr static std::uint32_t const SNAPSHOT_VERSION = 1;
+
+    // The alignment of each region (header, offsets, entries) of a snapshot.
+    constexpr static std::size_t const SNAPSHOT_ALIGNMENT = 64;
+
+    // The number of buckets migrated from the old table on each mutation
+    // while an incremental resize is in progress; a resize is triggered 
+    // after capacity / 2 insertions and the next one after another 
+    // capacity / 2, so any value of at least 2 completes the migration 
+    // before it is required again in an insert-only workload.
+    constexpr static std::size_t const MIGRATION_STEP = 4;
+
+    // The maximum number of bits of the bucket index by which a batch
+    // of lookups is partitioned; the partitioning pass writes to one
+    // stream per partition, and beyond 2^6 streams those writes miss in
+    // the TLB often enough to cost more than is gained by partitions any
+    // smaller than e.g. the 4MB regions of a table with 2^24 buckets.
+    constexpr static std::size_t const MAX_PARTITION_BITS = 6;
+
+    // The number of lookups ahead of the current one in a batch
+    // for which the bucket is prefetched.
+    constexpr static std::size_t const BATCH_PREFETCH_DISTANCE = 8;
+
+    // The number of buckets ahead of the current one in a full-table
+    // scan whose first entry is prefetched; the bucket array itself is 
+    // read sequentially and so is left to the hardware prefetcher.
+    constexpr static std::size_t const SCAN_PREFETCH_DISTANCE = 16;
+
+    // The number of lookups spawned by adaptive_interleaved_multilookup()
+    // between successive adjustments of the stream count; long enough
+    // that the clock reads are amortized, short enough to converge quickly.
+    constexpr static std::size_t const TUNING_EPOCH = 1024;
+
+    // Determines whether each entry stores the full hash of its key;
+    // a lookup then rejects non-matching entries by hash before comparing
+    // keys, and a resize never rehashes a key. Scalar keys compare as
+    // cheaply as their hashes and (with the default hasher) hash for
+    // free, so for them the hash would only inflate each entry.
+    constexpr static bool const STORES_HASH = !std::is_scalar_v<KeyT>;
+
+    // stands in for the hash of an entry that does not store it
+    struct UnstoredHash
+    {
+        UnstoredHash(std::size_t) {}
+    };
+
+    using StoredHash = std::conditional_t<STORES_HASH, std::size_t, UnstoredHash>;
+
+    // The type by which a key of type K is looked up; lookup by
+    // another type is only supported with a transparent hasher.
+    template <typename K>
+    using LookupKey = std::conditional_t<
+        is_transparent_hasher_v<Hasher>, std::remove_cvref_t<K>, KeyT>;
+
     struct Entry;
     struct Bucket;
+    struct BatchProbe;
 
-    template <typename Scheduler>
-    class LookupKVTask;
+    template <typename K, typename OutputIter>
+    struct LookupMachine;
+
+    struct SnapshotHeader;
+    struct SnapshotEntry;
 
     // The current number of items in the map.
     std::size_t n_items;
@@ -63,16 +209,101 @@ class Map
     // the array of buckets that composes the table
     Bucket* buckets;
 
+    // The strategy used to grow the table.
+    ResizeMode const resize_mode;
+
+    // the size of the pages that back the table and its entries
+    PageSize const page_size;
+
+    // the table being migrated during an incremental resize, if any
+    Bucket* old_buckets;
+
+    // the number of buckets in the table being migrated
+    std::size_t old_capacity;
+
+    // The index of the next bucket in the old table to be migrated;
+    // keys that hash to an old bucket below this index live in the 
+    // current table, all others still live in the old table.
+    std::size_t migrate_cursor;
+
     // the hash functor used to hash keys
     Hasher hasher;
 
+    // the allocator from which all entries are allocated
+    EntryAllocator<Entry> allocator;
+
+    // Set while a batch of interleaved mutations is in flight;
+    // the reclamation of removed entries is deferred until the batch
+    // completes so that suspended operations never observe a freed entry.
+    bool batch_in_progress;
+
+    // entries removed during the current batch, reclaimed once it completes
+    std::vector<Entry*> retired;
+
+    // Scratch space for batched_multilookup(); retained across calls 
+    // as faulting in fresh pages for a large batch otherwise costs 
+    // as much as the lookups themselves.
+    std::vector<BatchProbe> batch_probes;
+    std::vector<BatchProbe> batch_partitioned;
+
+    // selects the stream count for adaptive_interleaved_multilookup()
+    StreamTuner stream_tuner;
+
+    // determines whether interleaved operations suspend on prefetches
+    PrefetchPolicy prefetch_policy;
+
+    // the footprint beyond which PrefetchPolicy::SizeHeuristic suspends
+    std::size_t cache_budget;
+
+    // consulted before the table by lookups, if enabled
+    BlockedBloomFilter lookup_filter;
+
+    // the maximum number of items, beyond which insertions evict items
+    std::size_t item_budget;
+
+    // the index of the next bucket of the table examined for eviction
+    std::size_t clock_hand;
+
+    // the number of lookups performed, of those that found their key,
+    // and of items evicted to remain within the item budget
+    std::size_t n_lookups;
+    std::size_t n_hits;
+    std::size_t n_evictions;
+
+    // the number of times the table has been resized
+    std::size_t n_resizes;
+
+#ifndef NDEBUG
+    // advanced by each mutation, such that async_multilookup() can 
+    // detect a mutation of the map while its lookups are in flight
+    std::size_t mutation_epoch = 0;
+#endif
+
+    // The snapshot from which a map returned by load_mapped() is served,
+    // until it is first mutated in a way that changes its structure.
+    MappedFile snapshot;
+
+    // the bucket offset array within the snapshot; the entries of bucket
+    // `i` are those in [snapshot_offsets[i], snapshot_offsets[i + 1])
+    std::uint32_t const* snapshot_offsets;
+
+    // the packed entries within the snapshot, grouped by bucket
+    SnapshotEntry* snapshot_entries;
+
+    // the number of buckets in the snapshot
+    std::size_t snapshot_n_buckets;
+
 public:
-    class LookupKVResult;
-    class InsertKVResult;
-    class RemoveKVResult;
+    using LookupKVResult = ::LookupKVResult<KeyT, ValueT>;
+    using InsertKVResult = ::InsertKVResult<KeyT, ValueT>;
+    using RemoveKVResult = ::RemoveKVResult<KeyT, ValueT>;
 
     struct StatsResult;
 
+    class Iterator;
+
+    using iterator = Iterator;
+
     using LookupResultType = LookupKVResult;
     using InsertResultType = InsertKVResult;
     using UpdateResultType = InsertKVResult;
@@ -82,6 +313,17 @@ public:
 
     explicit Map(std::size_t const max_capacity_);
 
+    Map(std::size_t const max_capacity_, ResizeMode const resize_mode_);
+
+    // Construct a map whose table and entries are backed by pages of
+    // `page_size_`. With PageSize::Huge, a bucket array of at least one 
+    // huge page is allocated from huge pages, as is each chunk of entries
+    // if the entry allocator accepts a PageSize (e.g. SlabAllocator).
+    Map(
+        std::size_t const max_capacity_, 
+        ResizeMode const  resize_mode_, 
+        PageSize const    page_size_);
+
     ~Map();
     
     // non-copyable
@@ -95,6 +337,15 @@ public:
     // Lookup an item in the map by key.
     auto lookup(KeyT const& key) -> LookupKVResult;
 
+    // Lookup an item in the map by a key of another type that compares
+    // (and hashes) equal to the stored key, e.g. a std::string_view for 
+    // a std::string key; only available with a transparent hasher.
+    template <
+        typename K,
+        typename H = Hasher,
+        typename   = std::enable_if_t<is_transparent_hasher_v<H>>>
+    auto lookup(K const& key) -> LookupKVResult;
+
     // Insert a new key / value pair into the map;
     // does not insert if key is already present.
     auto insert(KeyT const& key, ValueT value) -> InsertKVResult;
@@ -137,29 +388,369 @@ public:
         Scheduler const&  scheduler,
         std::size_t const n_streams) -> void;
 
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys); otherwise identical to
+    // interleaved_multilookup(), except that the returned task
+    // does not run the scheduler itself. Awaited from a coroutine
+    // that runs on `scheduler`, the lookups are interleaved with any
+    // other coroutines on the scheduler, and the awaiting coroutine
+    // resumes once all of them complete. The scheduler must have room
+    // for `n_streams` lookups in addition to the task itself; the keys,
+    // the results, and the scheduler must outlive the task. The map must
+    // not be mutated until the task completes, as lookups in flight hold
+    // on to its buckets and entries (checked in debug builds).
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename OutputIter,
+        typename Scheduler>
+    auto async_multilookup(
+        BeginInputIter    begin_keys,
+        EndInputIter      end_keys,
+        OutputIter        begin_results,
+        Scheduler const&  scheduler,
+        std::size_t const n_streams) -> coro::task<void>;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys); otherwise identical to
+    // interleaved_multilookup(), except that the number of concurrent
+    // instruction streams is tuned at runtime from the observed cost
+    // per lookup, up to the number of tasks the scheduler can hold.
+    // The tuned stream count carries over to subsequent calls.
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename OutputIter,
+        typename Scheduler>
+    auto adaptive_interleaved_multilookup(
+        BeginInputIter    begin_keys,
+        EndInputIter      end_keys,
+        OutputIter        begin_results,
+        Scheduler const&  scheduler) -> void;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), writing the result of the
+    // lookup for the i-th key to `begin_results[i]`.
+    // The whole batch is hashed up front and radix-partitioned
+    // by bucket index, such that lookups sweep the table in bucket
+    // order rather than input order; keys that hit nearby buckets
+    // then share cache lines of the bucket array (and, for entries 
+    // inserted in bucket order, of the entries themselves).
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename RandomAccessOutputIter>
+    auto batched_multilookup(
+        BeginInputIter         begin_keys,
+        EndInputIter           end_keys,
+        RandomAccessOutputIter begin_results) -> void;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), inserting the result
+    // of each lookup operation into the range `begin_results`.
+    // Lookups are expressed as step machines (see libcoro/amac.hpp)
+    // and kept in a fixed ring of `n_streams` states stepped round-robin,
+    // each step prefetching the next line of its lookup; memory stalls
+    // are hidden as by interleaved_multilookup(), without the cost of
+    // a coroutine frame per lookup. Results are produced in order of
+    // completion.
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename OutputIter>
+    auto amac_multilookup(
+        BeginInputIter    begin_keys,
+        EndInputIter      end_keys,
+        OutputIter        begin_results,
+        std::size_t const n_streams) -> void;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), inserting the result
+    // of each lookup operation into the range `begin_results`,
+    // by the given means of execution: sequential_multilookup(),
+    // interleaved_multilookup() (on `scheduler`), or amac_multilookup().
+    // Which is cheapest depends upon the size of the table and upon the
+    // relative cost of a coroutine frame, and is best measured per call
+    // site (see bench_interleaved); `scheduler` and `n_streams` are
+    // ignored by the executions that do not use them.
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename OutputIter,
+        typename Scheduler>
+    auto multilookup(
+        BeginInputIter     begin_keys,
+        EndInputIter       end_keys,
+        OutputIter         begin_results,
+        Interleaving const interleaving,
+        Scheduler const&   scheduler,
+        std::size_t const  n_streams) -> void;
+
+    // Perform an insert operation for each key / value pair
+    // in the range [begin_items, end_items), inserting the result
+    // of each insert operation into the range `begin_results`.
+    // Operations are spawned as independent coroutines that prefetch
+    // the bucket and chain they modify before performing the insert,
+    // such that memory stalls for independent inserts are overlapped.
+    // Results are produced in order of completion.
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename OutputIter,
+        typename Scheduler>
+    auto interleaved_multiinsert(
+        BeginInputIter    begin_items,
+        EndInputIter      end_items,
+        OutputIter        begin_results,
+        Scheduler const&  scheduler,
+        std::size_t const n_streams) -> void;
+
+    // Perform an update operation for each key / value pair
+    // in the range [begin_items, end_items); otherwise
+    // identical to interleaved_multiinsert().
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename OutputIter,
+        typename Scheduler>
+    auto interleaved_multiupdate(
+        BeginInputIter    begin_items,
+        EndInputIter      end_items,
+        OutputIter        begin_results,
+        Scheduler const&  scheduler,
+        std::size_t const n_streams) -> void;
+
+    // Perform a remove operation for each key in the
+    // range [begin_keys, end_keys); otherwise
+    // identical to interleaved_multiinsert().
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename OutputIter,
+        typename Scheduler>
+    auto interleaved_multiremove(
+        BeginInputIter    begin_keys,
+        EndInputIter      end_keys,
+        OutputIter        begin_results,
+        Scheduler const&  scheduler,
+        std::size_t const n_streams) -> void;
+
     // Query the current number of items in the map.
     auto count() const -> std::size_t;
 
+    // Return the number of concurrent instruction streams that
+    // adaptive_interleaved_multilookup() currently uses with `Scheduler`.
+    template <typename Scheduler>
+    auto tuned_n_streams() const -> std::size_t;
+
+    // Set the policy by which interleaved operations decide whether to
+    // suspend on each prefetch; by default they suspend only once the 
+    // table and its entries outgrow `cache_budget` bytes, as switching
+    // coroutines costs more than a cache hit on a small, hot map.
+    auto set_prefetch_policy(
+        PrefetchPolicy const policy, 
+        std::size_t const    cache_budget_ = DEFAULT_CACHE_BUDGET) -> void;
+
+    // Enable (or disable) a filter of the keys in the map that lookups
+    // consult before the chain of a bucket, such that a lookup for an 
+    // absent key is usually resolved without walking the chain; the filter
+    // costs about two bytes per item, and is maintained by all subsequent
+    // mutations. Interleaved lookups fetch the line of the filter alongside
+    // the bucket, so a lookup for a present key pays for an additional
+    // cache line (though not for an additional suspension), and the filter
+    // only pays off for workloads in which a significant fraction of lookups miss.
+    auto set_lookup_filter(bool const enabled) -> void;
+
+    // Bound the number of items in the map to `max_items`, such that the
+    // map may serve as a cache. Once the budget is reached, each insertion
+    // of a new key evicts an item that has not been found by a lookup 
+    // since the previous sweep of the CLOCK hand over its bucket (the
+    // reference bit is kept per bucket, and so is shared by a chain).
+    // Items beyond a lowered budget are evicted immediately.
+    auto set_item_budget(std::size_t const max_items) -> void;
+
     // Compute some instance-specific statistics and return to the caller.
     auto stats() const -> StatsResult;
 
+    // Return an iterator to the first item in the map; the items are
+    // visited in an unspecified order, and dereference to a pair of 
+    // references to the key and value. Any mutation of the map 
+    // (other than through the iterator) invalidates all iterators.
+    auto begin() -> Iterator;
+    auto end() -> Iterator;
+
+    // Invoke `fn(key, value)` for each item in the map. The buckets of
+    // the table are split into `n_threads` contiguous ranges, each of
+    // which is scanned by its own thread (the calling thread scans the 
+    // first); `fn` must be safe to invoke concurrently, and the map 
+    // must not otherwise be mutated until the call returns.
+    template <typename Fn>
+    auto for_each_parallel(std::size_t const n_threads, Fn fn) -> void;
+
+    // Fold each item in the map into an accumulator with `fold(acc, key, value)`;
+    // each of `n_threads` threads folds the items in its range of buckets
+    // into its own copy of `init`, and the per-thread results are then
+    // combined (in bucket order) with `combine(acc, acc)`, such that 
+    // `init` must be an identity of `combine`.
+    template <
+        typename T, 
+        typename Fold, 
+        typename Combine>
+    auto reduce(
+        std::size_t const n_threads, 
+        T                 init, 
+        Fold              fold, 
+        Combine           combine) const -> T;
+
+    // Yield each item in the map as a pair of references to its key and 
+    // value. The table is walked in bucket order, and the chain of each
+    // bucket some distance ahead is prefetched while the current item 
+    // is yielded, such that the scan is not bound by the latency of 
+    // chasing each chain. The map must not be mutated during the scan.
+    auto scan() -> coro::generator<std::pair<KeyT const&, ValueT&>>;
+
+#if defined(MAPPED_FILE_SUPPORTED)
+    // Write a snapshot of the map to the file at `path`. The snapshot
+    // consists of a bucket offset array followed by the entries packed 
+    // in bucket order, such that load_mapped() may serve lookups from it
+    // directly; it requires trivially-copyable keys and values, and is 
+    // only valid for the same key, value, and hasher types on the same 
+    // platform as the map from which it was written.
+    auto save(std::string const& path) const -> void;
+
+    // Construct a map that is served from the snapshot at `path` in place,
+    // without rehashing or allocating its entries. Updates to existing
+    // keys are written to (copy-on-write) pages of the private mapping;
+    // the first mutation that changes the structure of the map copies
+    // the snapshot into an ordinary table and releases the mapping.
+    static auto load_mapped(std::string const& path) -> Map;
+#endif
+
 private:
+#if defined(MAPPED_FILE_SUPPORTED)
+    // Construct a map served from `file`, whose validated header is `header`.
+    Map(MappedFile file, SnapshotHeader const& header);
+#endif
+
+    template <typename K>
+    auto lookup_as(K const& key) -> LookupKVResult;
+
+    // The frame of the task is allocated from the frame 
+    // arena of the `throttler` by which it is spawned.
     template <
+        typename K,
         typename Scheduler, 
         typename OnFound, 
         typename OnNotFound>
     auto lookup_task(
+        std::allocator_arg_t,
+        Throttler<Scheduler>& throttler,
+        K const               key, 
+        Scheduler const&      scheduler,
+        OnFound               on_found, 
+        OnNotFound            on_not_found) -> LookupKVTask<Scheduler>;
+
+    template <
+        typename Scheduler, 
+        typename Operation>
+    auto mutation_task(
         KeyT const       key, 
         Scheduler const& scheduler,
-        OnFound          on_found, 
-        OnNotFound       on_not_found) -> LookupKVTask<Scheduler>;
+        Operation        operation) -> LookupKVTask<Scheduler>;
+
+    template <
+        typename BeginInputIter, 
+        typename EndInputIter, 
+        typename Scheduler,
+        typename MakeOperation>
+    auto interleaved_multimutate(
+        BeginInputIter    begin_inputs,
+        EndInputIter      end_inputs,
+        Scheduler const&  scheduler,
+        std::size_t const n_streams,
+        MakeOperation     make_operation) -> void;
 
-    auto bucket_index_for_key(KeyT const& key) -> std::size_t;
+    auto bucket_for_hash(std::size_t const hash) const -> Bucket&;
+
+    template <typename K>
+    auto lookup_in_bucket(
+        Bucket const&     bucket, 
+        K const&          key, 
+        std::size_t const hash) const -> LookupKVResult;
+
+    auto filter_rejects(std::size_t const hash) const -> bool;
+    auto stage_with_filter(void const* line, std::size_t const hash) const -> void const*;
+
+    template <typename K>
+    static auto entry_matches(
+        Entry const&      entry, 
+        K const&          key, 
+        std::size_t const hash) -> bool;
+
+    auto hash_of(Entry const& entry) const -> std::size_t;
+
+    static auto tag_for_hash(std::size_t const hash) -> std::uint32_t;
+    static auto chain_may_contain(Bucket const& bucket, std::uint32_t const tag) -> bool;
 
     auto perform_resize_if_required() -> void;
     auto resize_required() const -> bool;
 
-    auto insert_into_bucket(Bucket& bucket, Entry* entry) -> void;
+    auto resize_in_progress() const -> bool;
+    auto migrate_buckets(std::size_t const n_buckets) -> void;
+
+    auto footprint() const -> std::size_t;
+    auto should_suspend() const -> bool;
+
+    auto note_mutation() -> void;
+
+    template <typename Visitor>
+    auto for_each_entry(Visitor&& visitor) const -> void;
+
+    auto scan_extent() const -> std::size_t;
+    auto scan_bucket(std::size_t const index) const -> Bucket&;
+
+    template <typename Visitor>
+    auto scan_buckets(
+        std::size_t const first, 
+        std::size_t const last, 
+        Visitor&&         visitor) const -> void;
+
+    template <typename ScanRange>
+    auto scan_partitioned(std::size_t const n_threads, ScanRange scan_range) const -> void;
+
+    auto is_mapped() const -> bool;
+    auto materialize() -> void;
+
+    auto rebuild_lookup_filter(std::size_t const n_expected) -> void;
+    auto remove_from_lookup_filter() -> void;
+
+    auto record_hit(Bucket& bucket) -> void;
+    auto evict_if_over_budget(Entry const* keep) -> void;
+    auto evict_one(Entry const* keep) -> void;
+
+    template <typename K>
+    auto find_in_snapshot(K const& key, std::size_t const hash) const -> SnapshotEntry*;
+
+    static auto snapshot_header(MappedFile const& file) -> SnapshotHeader const&;
+    static auto snapshot_entries_offset(std::size_t const n_buckets) -> std::size_t;
+
+    auto allocate_buckets(std::size_t const n_buckets) const -> Bucket*;
+    auto free_buckets(Bucket* array, std::size_t const n_buckets) const -> void;
+    auto backs_with_huge_pages(std::size_t const n_buckets) const -> bool;
+
+    static auto make_allocator(PageSize const page_size_) -> EntryAllocator<Entry>;
+
+    auto insert_into_bucket(
+        Bucket&             bucket, 
+        Entry*              entry, 
+        std::uint32_t const tag) -> void;
+
+    auto make_entry(
+        KeyT const&       key, 
+        ValueT&           value, 
+        std::size_t const hash) -> Entry*;
+    auto destroy_entry(Entry* entry) -> void;
+    auto retire_entry(Entry* entry) -> void;
 };
 
 // ----------------------------------------------------------------------------
@@ -169,248 +760,255 @@ private:
 //
 // The layout of this structure is important as it
 // determines the per-item overhead for the map.
-template <typename KeyT, typename ValueT, typename Hasher>
-struct Map<KeyT, ValueT, Hasher>::Entry
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+struct Map<KeyT, ValueT, Hasher, EntryAllocator>::Entry
 {
     Entry* next;
 
+    // the full hash of `key`, if stored (see STORES_HASH)
+    [[no_unique_address]] StoredHash hash;
+
     KeyT   key;
     ValueT value;
 
     Entry() 
-        : next{nullptr}, key{}, value{} {}
+        : next{nullptr}, hash{0}, key{}, value{} {}
 
-    Entry(KeyT const& key_, ValueT& value_)
-        : next{nullptr}, key{key_}, value{value_} {}
+    Entry(KeyT const& key_, ValueT& value_, std::size_t const hash_)
+        : next{nullptr}, hash{hash_}, key{key_}, value{value_} {}
 };
 
 // The head of a bucket chain in the internal hashtable.
-template <typename KeyT, typename ValueT, typename Hasher>
-struct Map<KeyT, ValueT, Hasher>::Bucket
+//
+// Buckets remain 16 bytes (four to a cache line); the tag of the
+// first entry lets a lookup that lands on a bucket holding a single
+// non-matching entry resolve without ever touching that entry.
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+struct Map<KeyT, ValueT, Hasher, EntryAllocator>::Bucket
 {   
     // pointer to the first entry in the bucket chain, if any
     Entry* first;
 
     // the number of items in this bucket
-    std::size_t n_items;
+    std::uint32_t n_items;
+
+    // the tag for the key of the first entry in the bucket chain, if any
+    std::uint32_t first_tag : TAG_BITS;
+
+    // set when a key in the chain is found (or inserted) while the map
+    // has an item budget; cleared as the CLOCK hand sweeps past it
+    std::uint32_t referenced : 1;
 
     Bucket() 
-        : first{nullptr}, n_items{0} {}
-};
+        : first{nullptr}, n_items{0}, first_tag{0}, referenced{0} {}
 
-// ----------------------------------------------------------------------------
-// Auxiliary Types (Internal, Coroutine-Specific)
+    auto set_first_tag(std::uint32_t const tag) -> void
+    {
+        first_tag = tag & ((1u << TAG_BITS) - 1);
+    }
+};
 
-// The task type used to represent interleaved 
-// lookup operations in Map::interleaved_multilookup(). 
+// A single lookup as a step machine, see Map::amac_multilookup().
+//
+// The stages of the lookup mirror the suspension points of lookup_task():
+// the bucket (if the bucket array is large enough to be staged, with the
+// line of the lookup filter prefetched alongside it), and then each entry
+// of the chain.
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-template <typename Scheduler>
-class Map<KeyT, ValueT, Hasher>::LookupKVTask
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename K, typename OutputIter>
+struct Map<KeyT, ValueT, Hasher, EntryAllocator>::LookupMachine
 {
-public:
-    struct promise_type;
-    using CoroHandle = stdcoro::coroutine_handle<promise_type>;
+    enum class Stage : std::uint8_t
+    {
+        Bucket,
+        Chain
+    };
 
-    LookupKVTask() = delete;
+    struct state_type
+    {
+        // the key to lookup, and its hash
+        K           key{};
+        std::size_t hash{0};
 
-    // IMPT: not an RAII type; the throttler instance takes 
-    // ownership of the LookupKVTask immediately upon spawning it.
-    ~LookupKVTask() = default;
+        // the bucket of the key, once located
+        Bucket* bucket{nullptr};
 
-    LookupKVTask(LookupKVTask const&) = delete;
+        // the entry of the chain that is touched next
+        Entry* cursor{nullptr};
 
-    LookupKVTask(LookupKVTask&& rhs) 
-        : handle{rhs.handle}
-    {
-        rhs.handle = nullptr;
-    }
+        // the entry that matches the key, once found
+        Entry* found{nullptr};
 
-    struct promise_type
-    {
-        // pointer to the owning throttler instance for this promise
-        Throttler<Scheduler>* owning_throttler{nullptr};
+        Stage stage{Stage::Bucket};
+    };
 
-        // utilize the custom recycling allocator
-        void* operator new(std::size_t n)
-        {
-            return inline_recycling_allocator.alloc(n);
-        }
+    Map& map;
 
-        // utilize the custom recycling allocator
-        void operator delete(void* ptr, std::size_t n)
-        {
-            inline_recycling_allocator.free(ptr, n);
-        }
+    // the results, written in order of completion
+    OutputIter& results;
 
-        LookupKVTask get_return_object()
-        {
-            return LookupKVTask{*this};
-        }
+    // determines whether the bucket is reached in a step of its own
+    bool const stage_buckets;
 
-        auto initial_suspend()
-        {
-            return std::suspend_always{};
-        }
+    auto start(state_type& state, K const& key) -> void const*
+    {
+        ++map.n_lookups;
 
-        auto final_suspend()
-        {
-            return std::suspend_never{};
-        }
+        state.key   = key;
+        state.hash  = map.hasher(key);
+        state.found = nullptr;
 
-        void return_void()
-        {
-            owning_throttler->on_task_complete();
-        }
+        return locate_bucket(state);
+    }
 
-        void unhandled_exception() noexcept
+    auto step(state_type& state) -> void const*
+    {
+        switch (state.stage)
         {
-            std::terminate();
+        case Stage::Bucket:
+            return enter_chain(state);
+        case Stage::Chain:
+        default:
+            return walk_chain(state);
         }
-    };
+    }
 
-    // make the throttler the "owner" of this coroutine
-    auto set_owner(Throttler<Scheduler>* owner)
+    auto finish(state_type& state) -> void
     {
-        auto result = handle;
-        
-        // modify the promise to point to the owning throttler
-        handle.promise().owning_throttler = owner;
-        
-        // reset our handle
-        handle = nullptr;
-
-        return result;
+        auto* entry = state.found;
+        *results = (entry != nullptr) 
+            ? LookupKVResult{entry->key, entry->value} 
+            : LookupKVResult{};
+        ++results;
     }
 
 private:
-    CoroHandle handle;
-
-    LookupKVTask(promise_type& p)
-        : handle{CoroHandle::from_promise(p)} {}
-};
-
-// ----------------------------------------------------------------------------
-// Auxiliary Types (Exported)
-
-// The type returned by Map::lookup() operations.
-template <typename KeyT, typename ValueT, typename Hasher>
-class Map<KeyT, ValueT, Hasher>::LookupKVResult
-{
-    KeyT const* key;
-    ValueT*     value;
-
-public:
-    LookupKVResult() 
-        : key{nullptr}
-        , value{nullptr} {}
-
-    LookupKVResult(KeyT const& key_, ValueT& value_)
-        : key{&key_}, value{&value_} {}
-
-    KeyT const& get_key() const
+    auto locate_bucket(state_type& state) -> void const*
     {
-        return *key;
+        state.bucket = &map.bucket_for_hash(state.hash);
+        if (stage_buckets)
+        {
+            // the filter is queried once the bucket is reached
+            state.stage = Stage::Bucket;
+            return map.stage_with_filter(state.bucket, state.hash);
+        }
+
+        return enter_chain(state);
     }
 
-    ValueT& get_value() const
+    auto enter_chain(state_type& state) -> void const*
     {
-        return *value;
+        // a lookup for an absent key is (usually) resolved here
+        if (map.filter_rejects(state.hash) 
+            || !chain_may_contain(*state.bucket, tag_for_hash(state.hash)))
+        {
+            // not found
+            return nullptr;
+        }
+
+        state.stage  = Stage::Chain;
+        state.cursor = state.bucket->first;
+        return state.cursor;
     }
 
-    explicit operator bool() const
+    auto walk_chain(state_type& state) -> void const*
     {
-        return (key != nullptr);
+        auto* entry = state.cursor;
+        if (entry_matches(*entry, state.key, state.hash))
+        {
+            map.record_hit(*state.bucket);
+            state.found = entry;
+            return nullptr;
+        }
+
+        // not found at the end of the chain
+        state.cursor = entry->next;
+        return state.cursor;
     }
 };
 
-// The type returned by Map::insert() and Map::update() operations.
+// A single lookup within a batch, see Map::batched_multilookup().
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-class Map<KeyT, ValueT, Hasher>::InsertKVResult
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+struct Map<KeyT, ValueT, Hasher, EntryAllocator>::BatchProbe
 {
-    KeyT const* key;
-    ValueT*     value;
-    bool const  inserted;
-
-public:
-    InsertKVResult(
-        KeyT const& key_, 
-        ValueT&     value_, 
-        bool const  inserted_)
-        : key{&key_}
-        , value{&value_}
-        , inserted{inserted_} {}
+    // the key to lookup
+    KeyT key;
 
-    KeyT const& get_key() const
-    {
-        return *key;
-    }
-
-    ValueT& get_value() const
-    {
-        return *value;
-    }
+    // The position of the key in the input (and of its result in the
+    // output); narrowed such that small keys pack into 16 bytes.
+    std::uint32_t position;
 
-    explicit operator bool() const
-    {
-        return inserted;
-    }
+    // the hash of the key, computed once for the whole batch
+    std::size_t hash;
 };
 
-// The type returned by Map::remove() operations.
+// The header at the start of a snapshot file, see Map::save().
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-class Map<KeyT, ValueT, Hasher>::RemoveKVResult
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+struct Map<KeyT, ValueT, Hasher, EntryAllocator>::SnapshotHeader
 {
-    std::optional<KeyT>   key;
-    std::optional<ValueT> value;
-
-public:
-    RemoveKVResult()
-        : key{}, value{} {}
-
-    RemoveKVResult(KeyT&& key_, ValueT&& value_)
-        : key{std::move(key_)}, value{std::move(value_)} {}
+    // identifies the file format
+    std::uint64_t magic;
+    std::uint32_t version;
 
-    KeyT& get_key()
-    {
-        return *key;
-    }
+    // the layout of an entry, checked against the loading map's types
+    std::uint32_t entry_size;
+    std::uint32_t key_size;
+    std::uint32_t value_size;
 
-    ValueT& get_value()
-    {
-        return *value;
-    }
+    // the number of entries and of buckets in the snapshot
+    std::uint64_t n_items;
+    std::uint64_t n_buckets;
 
-    KeyT take_key()
-    {
-        return *std::move(key);
-    }
+    // the configuration of the saved map, restored upon load
+    std::uint64_t capacity;
+    std::uint64_t max_capacity;
+    std::uint32_t resize_mode;
 
-    ValueT take_value()
-    {
-        return *std::move(value);
-    }
+    std::uint32_t reserved;
+};
 
-    explicit operator bool()
-    {
-        return static_cast<bool>(key);
-    }
+// A packed entry within a snapshot file, see Map::save().
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+struct Map<KeyT, ValueT, Hasher, EntryAllocator>::SnapshotEntry
+{
+    KeyT   key;
+    ValueT value;
 };
 
+// ----------------------------------------------------------------------------
+// Auxiliary Types (Exported)
+
 // The type returned by Map::stats() operations.
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-struct Map<KeyT, ValueT, Hasher>::StatsResult
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+struct Map<KeyT, ValueT, Hasher, EntryAllocator>::StatsResult
 {
     // The current count of items in the map.
     std::size_t count;
@@ -432,29 +1030,195 @@ struct Map<KeyT, ValueT, Hasher>::StatsResult
 
     // The average length of a bucket chain in the map.
     std::size_t avg_bucket_depth;
-};
 
-// ----------------------------------------------------------------------------
+    // The maximum number of items in the map (see Map::set_item_budget()).
+    std::size_t item_budget;
+
+    // The number of lookups that found (and failed to find) their key;
+    // counted whether or not an item budget is set.
+    std::size_t hits;
+    std::size_t misses;
+
+    // The number of items evicted to remain within the item budget.
+    std::size_t evictions;
+
+    // The number of times the table has been resized.
+    std::size_t resizes;
+};
+
+// The iterator returned by Map::begin() and Map::end().
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+class Map<KeyT, ValueT, Hasher, EntryAllocator>::Iterator
+{
+    // the map over which we iterate
+    Map const* map;
+
+    // the index (see Map::scan_bucket()) of the bucket that holds `entry`
+    std::size_t bucket;
+
+    // the current entry of an ordinary map, or nullptr at its end
+    Entry* entry;
+
+    // the current entry of a mapped map, or nullptr for an ordinary map
+    SnapshotEntry* snapshot_entry;
+
+public:
+    // dereferences to a proxy (a pair of references) by value, 
+    // which the requirements of a forward iterator do not permit
+    using iterator_category = std::input_iterator_tag;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = std::pair<KeyT const, ValueT>;
+    using reference         = std::pair<KeyT const&, ValueT&>;
+    using pointer           = void;
+
+    Iterator()
+        : map{nullptr}, bucket{0}, entry{nullptr}, snapshot_entry{nullptr} {}
+
+    auto operator*() const -> reference
+    {
+        if (snapshot_entry != nullptr)
+        {
+            return reference{snapshot_entry->key, snapshot_entry->value};
+        }
+
+        return reference{entry->key, entry->value};
+    }
+
+    auto operator++() -> Iterator&
+    {
+        // the entries of a snapshot are contiguous
+        if (snapshot_entry != nullptr)
+        {
+            ++snapshot_entry;
+            return *this;
+        }
+
+        entry = entry->next;
+        if (nullptr == entry)
+        {
+            seek_from(bucket + 1);
+        }
+
+        return *this;
+    }
+
+    auto operator++(int) -> Iterator
+    {
+        auto previous = *this;
+        ++(*this);
+        return previous;
+    }
+
+    auto operator==(Iterator const& rhs) const -> bool
+    {
+        return entry == rhs.entry && snapshot_entry == rhs.snapshot_entry;
+    }
+
+private:
+    friend class Map;
+
+    Iterator(Map const* map_, Entry* entry_, SnapshotEntry* snapshot_entry_)
+        : map{map_}, bucket{0}, entry{entry_}, snapshot_entry{snapshot_entry_} {}
+
+    // Advance to the first entry in the first nonempty 
+    // bucket at or beyond `index`, if any, or to the end.
+    auto seek_from(std::size_t index) -> void
+    {
+        auto const extent = map->scan_extent();
+        for (; index < extent; ++index)
+        {
+            if (index + SCAN_PREFETCH_DISTANCE < extent)
+            {
+                _mm_prefetch(reinterpret_cast<char const*>(
+                    map->scan_bucket(index + SCAN_PREFETCH_DISTANCE).first), _MM_HINT_T0);
+            }
+
+            auto* first = map->scan_bucket(index).first;
+            if (first != nullptr)
+            {
+                bucket = index;
+                entry  = first;
+                return;
+            }
+        }
+
+        bucket = extent;
+        entry  = nullptr;
+    }
+};
+
+// ----------------------------------------------------------------------------
 // Exported Definitions
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-Map<KeyT, ValueT, Hasher>::Map() 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+Map<KeyT, ValueT, Hasher, EntryAllocator>::Map() 
     : Map{DEFAULT_MAX_CAPACITY} {}
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-Map<KeyT, ValueT, Hasher>::Map(
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+Map<KeyT, ValueT, Hasher, EntryAllocator>::Map(
     std::size_t const max_capacity_)
+    : Map{max_capacity_, ResizeMode::Immediate} {}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+Map<KeyT, ValueT, Hasher, EntryAllocator>::Map(
+    std::size_t const max_capacity_,
+    ResizeMode const  resize_mode_)
+    : Map{max_capacity_, resize_mode_, PageSize::Base} {}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+Map<KeyT, ValueT, Hasher, EntryAllocator>::Map(
+    std::size_t const max_capacity_,
+    ResizeMode const  resize_mode_,
+    PageSize const    page_size_)
     : n_items{0}
     , capacity{0}
     , max_capacity{max_capacity_}
     , buckets{nullptr}
+    , resize_mode{resize_mode_}
+    , page_size{page_size_}
+    , old_buckets{nullptr}
+    , old_capacity{0}
+    , migrate_cursor{0}
     , hasher{}
+    , allocator{make_allocator(page_size_)}
+    , batch_in_progress{false}
+    , retired{}
+    , batch_probes{}
+    , batch_partitioned{}
+    , stream_tuner{}
+    , prefetch_policy{PrefetchPolicy::SizeHeuristic}
+    , cache_budget{DEFAULT_CACHE_BUDGET}
+    , lookup_filter{}
+    , item_budget{DEFAULT_ITEM_BUDGET}
+    , clock_hand{0}
+    , n_lookups{0}
+    , n_hits{0}
+    , n_evictions{0}
+    , n_resizes{0}
+    , snapshot{}
+    , snapshot_offsets{nullptr}
+    , snapshot_entries{nullptr}
+    , snapshot_n_buckets{0}
 {
     if (0 == max_capacity)
     {
@@ -466,83 +1230,174 @@ Map<KeyT, ValueT, Hasher>::Map(
         next_power_of_2(std::min(DEFAULT_INIT_CAPACITY, max_capacity)) >> 1;
 
     capacity = init_capacity;
-    buckets  = new Bucket[init_capacity];
+    buckets  = allocate_buckets(init_capacity);
 }
 
+#if defined(MAPPED_FILE_SUPPORTED)
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-Map<KeyT, ValueT, Hasher>::~Map()
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+Map<KeyT, ValueT, Hasher, EntryAllocator>::Map(
+    MappedFile            file, 
+    SnapshotHeader const& header)
+    : Map{header.max_capacity, static_cast<ResizeMode>(header.resize_mode)}
 {
-    delete[] buckets;
+    static_assert(std::is_trivially_copyable_v<KeyT> && std::is_trivially_copyable_v<ValueT>,
+        "snapshots require trivially-copyable keys and values");
+
+    n_items            = header.n_items;
+    snapshot_n_buckets = header.n_buckets;
+    snapshot_offsets   = reinterpret_cast<std::uint32_t const*>(file.data() + sizeof(SnapshotHeader));
+    snapshot_entries   = reinterpret_cast<SnapshotEntry*>(
+        file.data() + snapshot_entries_offset(snapshot_n_buckets));
+
+    snapshot = std::move(file);
 }
+#endif
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::lookup(KeyT const& key) -> LookupKVResult
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+Map<KeyT, ValueT, Hasher, EntryAllocator>::~Map()
 {
-    auto const index = bucket_index_for_key(key);
-
-    auto& bucket = buckets[index];
-    if (0 == bucket.n_items)
+    // entries need not be visited individually if they hold no
+    // resources of their own and the allocator reclaims them in bulk
+    if constexpr (!std::is_trivially_destructible_v<Entry> 
+               || !EntryAllocator<Entry>::RELEASES_ON_DESTRUCTION)
     {
-        // not found
-        return LookupKVResult{};
-    }
+        auto const destroy_chain = [this](Bucket const& bucket) {
+            auto* entry = bucket.first;
+            while (entry != nullptr)
+            {
+                auto* next = entry->next;
+                destroy_entry(entry);
+                entry = next;
+            }
+        };
 
-    auto* entry = bucket.first;
-    for (;;)
-    {
-        if (key == entry->key)
+        for (auto i = 0ul; i < capacity; ++i)
         {
-            return LookupKVResult{entry->key, entry->value};
+            destroy_chain(buckets[i]);
         }
 
-        if (nullptr == entry->next)
+        // buckets below the cursor have already been emptied
+        for (auto i = migrate_cursor; resize_in_progress() && i < old_capacity; ++i)
         {
-            // reached the end of the bucket chain
-            break;
+            destroy_chain(old_buckets[i]);
         }
+    }
 
-        // traverse the linked-list of entries for this bucket
-        entry = entry->next;
+    free_buckets(old_buckets, old_capacity);
+    free_buckets(buckets, capacity);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::lookup(KeyT const& key) -> LookupKVResult
+{
+    return lookup_as(key);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename K, typename, typename>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::lookup(K const& key) -> LookupKVResult
+{
+    return lookup_as(key);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename K>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::lookup_as(K const& key) -> LookupKVResult
+{
+    ++n_lookups;
+
+    auto const hash = hasher(key);
+    if (is_mapped())
+    {
+        if (filter_rejects(hash))
+        {
+            // definitely not present
+            return LookupKVResult{};
+        }
+
+        auto* entry = find_in_snapshot(key, hash);
+        n_hits += (entry != nullptr) ? 1 : 0;
+        return (entry != nullptr) ? LookupKVResult{entry->key, entry->value} : LookupKVResult{};
     }
 
-    // not found
-    return LookupKVResult{};
+    auto& bucket = bucket_for_hash(hash);
+    auto result  = lookup_in_bucket(bucket, key, hash);
+    if (result)
+    {
+        record_hit(bucket);
+    }
+
+    return result;
 }
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::insert(
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::insert(
     KeyT const& key, 
     ValueT      value) -> InsertKVResult
 {
-    auto const index = bucket_index_for_key(key);
-    
-    auto& bucket = buckets[index];
+    note_mutation();
+
+    auto const hash = hasher(key);
+    if (is_mapped())
+    {
+        if (auto* entry = find_in_snapshot(key, hash); entry != nullptr)
+        {
+            // collision; do not insert
+            return InsertKVResult{entry->key, entry->value, false};
+        }
+
+        materialize();
+    }
+
+    if (resize_in_progress())
+    {
+        migrate_buckets(MIGRATION_STEP);
+    }
+
+    auto& bucket = bucket_for_hash(hash);
     if (0 == bucket.n_items)
     {
         // empty bucket chain
-        auto* new_entry = new Entry{key, value};
-        bucket.first = new_entry;
+        auto* new_entry = make_entry(key, value, hash);
+        bucket.first     = new_entry;
+        bucket.set_first_tag(tag_for_hash(hash));
         ++bucket.n_items;
         ++n_items;
 
         perform_resize_if_required();
+        evict_if_over_budget(new_entry);
 
-        return InsertKVResult{key, value, true};
+        return InsertKVResult{new_entry->key, new_entry->value, true};
     }
 
     auto* entry = bucket.first;
     for (;;)
     {
-        if (key == entry->key)
+        if (entry_matches(*entry, key, hash))
         {
             // collision; do not insert
             return InsertKVResult{entry->key, entry->value, false};
@@ -560,44 +1415,67 @@ auto Map<KeyT, ValueT, Hasher>::insert(
     // reached the end of the entry chain without collision;
     // insert this key / value pair at end of current chain
 
-    auto* new_entry = new Entry{key, value};
+    auto* new_entry = make_entry(key, value, hash);
     entry->next = new_entry;
     ++bucket.n_items;
     ++n_items;
 
     perform_resize_if_required();
+    evict_if_over_budget(new_entry);
 
-    return InsertKVResult{key, value, true};
+    return InsertKVResult{new_entry->key, new_entry->value, true};
 }
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::update(
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::update(
     KeyT const& key, 
     ValueT      value) -> InsertKVResult
 {
-    auto const index = bucket_index_for_key(key);
-    
-    auto& bucket = buckets[index];
+    note_mutation();
+
+    auto const hash = hasher(key);
+    if (is_mapped())
+    {
+        // an existing key is updated in place; only the page 
+        // of the mapping that holds it is copied on write
+        if (auto* entry = find_in_snapshot(key, hash); entry != nullptr)
+        {
+            entry->value = value;
+            return InsertKVResult{entry->key, entry->value, true};
+        }
+
+        materialize();
+    }
+
+    if (resize_in_progress())
+    {
+        migrate_buckets(MIGRATION_STEP);
+    }
+
+    auto& bucket = bucket_for_hash(hash);
     if (0 == bucket.n_items)
     {
         // empty bucket chain
-        auto* new_entry = new Entry{key, value};
-        bucket.first = new_entry;
+        auto* new_entry = make_entry(key, value, hash);
+        bucket.first     = new_entry;
+        bucket.set_first_tag(tag_for_hash(hash));
         ++bucket.n_items;
         ++n_items;
 
         perform_resize_if_required();
+        evict_if_over_budget(new_entry);
 
-        return InsertKVResult{key, value, true};
+        return InsertKVResult{new_entry->key, new_entry->value, true};
     }
 
     auto* entry = bucket.first;
     for (;;)
     {
-        if (key == entry->key)
+        if (entry_matches(*entry, key, hash))
         {
             // found a matching key; update the associated value
             entry->value.~ValueT();
@@ -617,27 +1495,46 @@ auto Map<KeyT, ValueT, Hasher>::update(
     // reached the end of the entry chain without collision;
     // insert this key / value pair at end of current chain
 
-    auto* new_entry = new Entry{key, value};
+    auto* new_entry = make_entry(key, value, hash);
     entry->next = new_entry;
     ++bucket.n_items;
     ++n_items;
 
     perform_resize_if_required();
+    evict_if_over_budget(new_entry);
 
-    return InsertKVResult{key, value, true};
+    return InsertKVResult{new_entry->key, new_entry->value, true};
 }
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::remove(
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::remove(
     KeyT const& key) -> RemoveKVResult
 {
-    auto const index = bucket_index_for_key(key);
+    note_mutation();
 
-    auto& bucket = buckets[index];
-    if (0 == bucket.n_items)
+    auto const hash = hasher(key);
+    if (is_mapped())
+    {
+        if (nullptr == find_in_snapshot(key, hash))
+        {
+            // key not present in the map
+            return RemoveKVResult{};
+        }
+
+        materialize();
+    }
+
+    if (resize_in_progress())
+    {
+        migrate_buckets(MIGRATION_STEP);
+    }
+
+    auto& bucket = bucket_for_hash(hash);
+    if (!chain_may_contain(bucket, tag_for_hash(hash)))
     {
         // key not present in the map
         return RemoveKVResult{};
@@ -647,7 +1544,7 @@ auto Map<KeyT, ValueT, Hasher>::remove(
     auto* entry = bucket.first;
     for (;;)
     {
-        if (key == entry->key)
+        if (entry_matches(*entry, key, hash))
         {
             // found a matching key; remove the key value pair
             auto result = RemoveKVResult{std::move(entry->key), std::move(entry->value)};
@@ -655,15 +1552,23 @@ auto Map<KeyT, ValueT, Hasher>::remove(
             {
                 prev->next = entry->next;
             }
+            else if (entry->next != nullptr)
+            {
+                // the successor becomes the head of the chain
+                bucket.first     = entry->next;
+                bucket.set_first_tag(tag_for_hash(hash_of(*entry->next)));
+            }
             else
             {
-                bucket.first = entry->next;
+                bucket.first = nullptr;
             }
             
-            delete entry;
+            retire_entry(entry);
             --bucket.n_items;
             --n_items;
 
+            remove_from_lookup_filter();
+
             return result;
         }
 
@@ -673,6 +1578,7 @@ auto Map<KeyT, ValueT, Hasher>::remove(
             break;
         }
 
+        prev  = entry;
         entry = entry->next;
     }
     
@@ -683,12 +1589,13 @@ auto Map<KeyT, ValueT, Hasher>::remove(
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
+    typename Hasher,
+    template <typename> typename EntryAllocator>
 template <
     typename BeginInputIter, 
     typename EndInputIter, 
     typename OutputIter>
-auto Map<KeyT, ValueT, Hasher>::sequential_multilookup(
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::sequential_multilookup(
     BeginInputIter begin_keys,
     EndInputIter   end_keys,
     OutputIter     begin_results) -> void
@@ -703,20 +1610,21 @@ auto Map<KeyT, ValueT, Hasher>::sequential_multilookup(
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
+    typename Hasher,
+    template <typename> typename EntryAllocator>
 template <
     typename BeginInputIter, 
     typename EndInputIter, 
     typename OutputIter,
     typename Scheduler>
-auto Map<KeyT, ValueT, Hasher>::interleaved_multilookup(
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::interleaved_multilookup(
     BeginInputIter    begin_keys,
     EndInputIter      end_keys,
     OutputIter        begin_results,
     Scheduler const&  scheduler,
     std::size_t const n_streams) -> void
 {
-    using MapType    = Map<KeyT, ValueT, Hasher>;
+    using MapType    = Map<KeyT, ValueT, Hasher, EntryAllocator>;
     using ResultType = typename MapType::LookupKVResult;
 
     // instantiate a throttler for this multilookup
@@ -725,7 +1633,9 @@ auto Map<KeyT, ValueT, Hasher>::interleaved_multilookup(
     for (auto key_iter = begin_keys; key_iter != end_keys; ++key_iter)
     {
         throttler.spawn(
-            lookup_task(
+            lookup_task<LookupKey<decltype(*key_iter)>>(
+                std::allocator_arg,
+                throttler,
                 *key_iter,
                 scheduler,
                 [&begin_results](KeyT const& k, ValueT& v) mutable {
@@ -745,173 +1655,1782 @@ auto Map<KeyT, ValueT, Hasher>::interleaved_multilookup(
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::count() const -> std::size_t
-{
-    return n_items;
-}
-
+    typename Hasher,
+    template <typename> typename EntryAllocator>
 template <
-    typename KeyT, 
-    typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::stats() const -> StatsResult
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename OutputIter,
+    typename Scheduler>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::async_multilookup(
+    BeginInputIter    begin_keys,
+    EndInputIter      end_keys,
+    OutputIter        begin_results,
+    Scheduler const&  scheduler,
+    std::size_t const n_streams) -> coro::task<void>
 {
-    StatsResult results{};
+    using MapType    = Map<KeyT, ValueT, Hasher, EntryAllocator>;
+    using ResultType = typename MapType::LookupKVResult;
 
-    results.count        = n_items;
-    results.capacity     = capacity;
-    results.max_capacity = max_capacity;
+    // instantiate a throttler for this multilookup; it lives in the
+    // frame of this coroutine, which outlives all of the lookup tasks
+    Throttler throttler{scheduler, n_streams};
 
-    results.load_factor 
-        = static_cast<double>(n_items) / static_cast<double>(capacity);
+#ifndef NDEBUG
+    auto const epoch = mutation_epoch;
+#endif
 
-    std::size_t min_length = std::numeric_limits<std::size_t>::max();
-    std::size_t max_length = 0;
-    std::size_t sum_length = 0;
-    for (auto i = 0ul; i < capacity; ++i)
-    {   
-        auto& bucket = buckets[i];
-        min_length = std::min(bucket.n_items, min_length);
-        max_length = std::max(bucket.n_items, max_length);
-        sum_length += bucket.n_items;
-    }
+    for (auto key_iter = begin_keys; key_iter != end_keys; ++key_iter)
+    {
+        // yield to the scheduler (rather than resuming lookups
+        // from here) while all of the streams are in flight
+        co_await throttler.wait_for_slot();
+        assert(epoch == mutation_epoch && "map mutated during async_multilookup()");
 
-    results.min_bucket_depth = min_length;
-    results.max_bucket_depth = max_length;
-    results.avg_bucket_depth = sum_length / capacity;
+        throttler.spawn(
+            lookup_task<LookupKey<decltype(*key_iter)>>(
+                std::allocator_arg,
+                throttler,
+                *key_iter,
+                scheduler,
+                [&begin_results](KeyT const& k, ValueT& v) mutable {
+                    *begin_results = ResultType{k, v};
+                    ++begin_results;
+                },
+                [&begin_results]() mutable { 
+                    *begin_results = ResultType{};
+                    ++begin_results;
+                }));
+    }
 
-    return results;
+    // resumed by the completion of the final lookup task
+    co_await throttler.wait_for_all();
+    assert(epoch == mutation_epoch && "map mutated during async_multilookup()");
 }
 
-// ----------------------------------------------------------------------------
-// Internal Definitions
-
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-template < 
-    typename Scheduler, 
-    typename OnFound, 
-    typename OnNotFound>
-auto Map<KeyT, ValueT, Hasher>::lookup_task(
-    KeyT const       key, 
-    Scheduler const& scheduler,
-    OnFound          on_found, 
-    OnNotFound       on_not_found) -> LookupKVTask<Scheduler>
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename OutputIter,
+    typename Scheduler>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::adaptive_interleaved_multilookup(
+    BeginInputIter    begin_keys,
+    EndInputIter      end_keys,
+    OutputIter        begin_results,
+    Scheduler const&  scheduler) -> void
 {
-    auto const index = bucket_index_for_key(key);
+    using MapType    = Map<KeyT, ValueT, Hasher, EntryAllocator>;
+    using ResultType = typename MapType::LookupKVResult;
+    using Clock      = std::chrono::steady_clock;
 
-    // assume that the bucket array itself is cached
-    // TODO: can we avoid this assumption?
-    auto& bucket = buckets[index];
-    if (0 == bucket.n_items)
-    {
-        // not found
-        co_return on_not_found();
-    }
+    auto const max_streams = Scheduler::max_tasks();
 
-    auto* entry = co_await prefetch_and_schedule_on(bucket.first, scheduler);
-    for (;;)
+    // instantiate a throttler for this multilookup,
+    // starting from the stream count tuned by previous calls
+    Throttler throttler{scheduler, stream_tuner.get_n_streams(max_streams), max_streams};
+
+    // the pipeline of lookups is in a steady state once it has filled,
+    // so the time between epochs of spawns measures the cost per lookup
+    auto epoch_start = Clock::now();
+    auto n_spawned   = std::size_t{0};
+
+    for (auto key_iter = begin_keys; key_iter != end_keys; ++key_iter)
     {
-        if (key == entry->key)
-        {
-            co_return on_found(entry->key, entry->value);
-        }
+        throttler.spawn(
+            lookup_task<LookupKey<decltype(*key_iter)>>(
+                std::allocator_arg,
+                throttler,
+                *key_iter,
+                scheduler,
+                [&begin_results](KeyT const& k, ValueT& v) mutable {
+                    *begin_results = ResultType{k, v};
+                    ++begin_results;
+                },
+                [&begin_results]() mutable { 
+                    *begin_results = ResultType{};
+                    ++begin_results;
+                }));
 
-        if (nullptr == entry->next)
+        if (++n_spawned == TUNING_EPOCH)
         {
-            // reached the end of the bucket chain
-            break;
-        }
+            auto const epoch_stop = Clock::now();
+            throttler.set_max_concurrent(
+                stream_tuner.record(n_spawned, epoch_stop - epoch_start, max_streams));
 
-        // traverse the linked-list of entries for this bucket
-        entry = co_await prefetch_and_schedule_on(entry->next, scheduler);
+            epoch_start = epoch_stop;
+            n_spawned   = 0;
+        }
     }
 
-    // not found
-    co_return on_not_found();
+    // run until all lookup tasks complete
+    throttler.run();
 }
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::bucket_index_for_key(KeyT const& key) -> std::size_t
-{
-    auto const hash = hasher(key);
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename RandomAccessOutputIter>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::batched_multilookup(
+    BeginInputIter         begin_keys,
+    EndInputIter           end_keys,
+    RandomAccessOutputIter begin_results) -> void
+{
+    // the buckets of a snapshot are already laid out contiguously,
+    // but are not partitioned here; lookups proceed in input order
+    if (is_mapped())
+    {
+        sequential_multilookup(begin_keys, end_keys, begin_results);
+        return;
+    }
+
+    // the batch is partitioned by the high bits of the bucket index (one
+    // pass of an MSD radix sort); each partition then covers a contiguous
+    // region of the bucket array small enough to remain cached while it 
+    // is probed, so the order of the lookups within a partition is immaterial
+    auto const bucket_bits    = static_cast<std::size_t>(std::countr_zero(capacity));
+    auto const partition_bits = std::min(bucket_bits, MAX_PARTITION_BITS);
+    auto const shift          = bucket_bits - partition_bits;
+
+    auto const partition_of = [this, shift](std::size_t const hash) {
+        return (hash & (capacity - 1)) >> shift;
+    };
+
+    // hash the whole batch once, remembering the position of each key
+    // and counting the number of keys that fall into each partition
+    auto& probes = batch_probes;
+    probes.clear();
+
+    std::vector<std::size_t> offsets((1ul << partition_bits) + 1, 0);
+
+    std::uint32_t position = 0;
+    for (auto key_iter = begin_keys; key_iter != end_keys; ++key_iter, ++position)
+    {
+        if (std::numeric_limits<std::uint32_t>::max() == position)
+        {
+            throw std::runtime_error{"batch size exceeds maximum"};
+        }
+
+        auto const& key  = *key_iter;
+        auto const  hash = hasher(key);
+
+        probes.push_back(BatchProbe{key, position, hash});
+        ++offsets[partition_of(hash) + 1];
+    }
+
+    for (auto i = 1ul; i < offsets.size(); ++i)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+
+    auto& partitioned = batch_partitioned;
+    partitioned.resize(probes.size());
+    for (auto const& probe : probes)
+    {
+        partitioned[offsets[partition_of(probe.hash)]++] = probe;
+    }
+
+    // probe the partitions in order, scattering each result 
+    // back to the position of its key in the input
+    for (auto i = 0ul; i < partitioned.size(); ++i)
+    {
+        if (i + BATCH_PREFETCH_DISTANCE < partitioned.size())
+        {
+            // neighbouring lookups are likely to share the line, so
+            // unlike the interleaved lookups it is kept in all levels
+            auto const  hash  = partitioned[i + BATCH_PREFETCH_DISTANCE].hash;
+            auto const* ahead = &bucket_for_hash(hash);
+            _mm_prefetch(reinterpret_cast<char const*>(ahead), _MM_HINT_T0);
+            if (lookup_filter.enabled())
+            {
+                _mm_prefetch(reinterpret_cast<char const*>(&lookup_filter.block_for(hash)), _MM_HINT_T0);
+            }
+        }
+
+        auto const& probe  = partitioned[i];
+        auto&       bucket = bucket_for_hash(probe.hash);
+
+        auto result = lookup_in_bucket(bucket, probe.key, probe.hash);
+        if (result)
+        {
+            record_hit(bucket);
+        }
+
+        begin_results[static_cast<std::ptrdiff_t>(probe.position)] = result;
+    }
+
+    n_lookups += partitioned.size();
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename OutputIter>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::amac_multilookup(
+    BeginInputIter    begin_keys,
+    EndInputIter      end_keys,
+    OutputIter        begin_results,
+    std::size_t const n_streams) -> void
+{
+    // the lookups of a snapshot are not expressed as step machines
+    if (is_mapped())
+    {
+        sequential_multilookup(begin_keys, end_keys, begin_results);
+        return;
+    }
+
+    using Machine = LookupMachine<LookupKey<decltype(*begin_keys)>, OutputIter>;
+
+    // as for the coroutines of interleaved_multilookup(), the prefetches
+    // of a table that (by the prefetch policy) remains cached are pure 
+    // overhead, and so the steps are then executed one lookup at a time
+    auto const suspend = should_suspend();
+
+    Machine machine{
+        *this, 
+        begin_results, 
+        suspend && capacity * sizeof(Bucket) > STAGED_BUCKET_THRESHOLD};
+
+    if (suspend)
+    {
+        coro::run_amac(machine, begin_keys, end_keys, n_streams);
+    }
+    else
+    {
+        coro::run_sequential(machine, begin_keys, end_keys);
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename OutputIter,
+    typename Scheduler>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::multilookup(
+    BeginInputIter     begin_keys,
+    EndInputIter       end_keys,
+    OutputIter         begin_results,
+    Interleaving const interleaving,
+    Scheduler const&   scheduler,
+    std::size_t const  n_streams) -> void
+{
+    switch (interleaving)
+    {
+    case Interleaving::Sequential:
+        sequential_multilookup(begin_keys, end_keys, begin_results);
+        break;
+    case Interleaving::Coroutine:
+        interleaved_multilookup(begin_keys, end_keys, begin_results, scheduler, n_streams);
+        break;
+    case Interleaving::Amac:
+    default:
+        amac_multilookup(begin_keys, end_keys, begin_results, n_streams);
+        break;
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename OutputIter,
+    typename Scheduler>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::interleaved_multiinsert(
+    BeginInputIter    begin_items,
+    EndInputIter      end_items,
+    OutputIter        begin_results,
+    Scheduler const&  scheduler,
+    std::size_t const n_streams) -> void
+{
+    interleaved_multimutate(
+        begin_items, 
+        end_items, 
+        scheduler, 
+        n_streams,
+        [this, &begin_results](auto const& item) mutable {
+            auto const& key   = item.first;
+            auto const& value = item.second;
+            return std::pair{key, [this, key, value, &begin_results]() mutable {
+                *begin_results = insert(key, std::move(value));
+                ++begin_results;
+            }};
+        });
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename OutputIter,
+    typename Scheduler>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::interleaved_multiupdate(
+    BeginInputIter    begin_items,
+    EndInputIter      end_items,
+    OutputIter        begin_results,
+    Scheduler const&  scheduler,
+    std::size_t const n_streams) -> void
+{
+    interleaved_multimutate(
+        begin_items, 
+        end_items, 
+        scheduler, 
+        n_streams,
+        [this, &begin_results](auto const& item) mutable {
+            auto const& key   = item.first;
+            auto const& value = item.second;
+            return std::pair{key, [this, key, value, &begin_results]() mutable {
+                *begin_results = update(key, std::move(value));
+                ++begin_results;
+            }};
+        });
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename OutputIter,
+    typename Scheduler>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::interleaved_multiremove(
+    BeginInputIter    begin_keys,
+    EndInputIter      end_keys,
+    OutputIter        begin_results,
+    Scheduler const&  scheduler,
+    std::size_t const n_streams) -> void
+{
+    interleaved_multimutate(
+        begin_keys, 
+        end_keys, 
+        scheduler, 
+        n_streams,
+        [this, &begin_results](KeyT const& key) mutable {
+            return std::pair{key, [this, key, &begin_results]() mutable {
+                *begin_results = remove(key);
+                ++begin_results;
+            }};
+        });
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::count() const -> std::size_t
+{
+    return n_items;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename Scheduler>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::tuned_n_streams() const -> std::size_t
+{
+    return stream_tuner.get_n_streams(Scheduler::max_tasks());
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::set_prefetch_policy(
+    PrefetchPolicy const policy, 
+    std::size_t const    cache_budget_) -> void
+{
+    prefetch_policy = policy;
+    cache_budget    = cache_budget_;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::set_lookup_filter(bool const enabled) -> void
+{
+    note_mutation();
+
+    if (enabled)
+    {
+        rebuild_lookup_filter(n_items);
+    }
+    else
+    {
+        lookup_filter.disable();
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::set_item_budget(std::size_t const max_items) -> void
+{
+    if (0 == max_items)
+    {
+        throw std::runtime_error{"item budget must be nonzero"};
+    }
+
+    item_budget = max_items;
+    note_mutation();
+
+    if (n_items > item_budget && is_mapped())
+    {
+        materialize();
+    }
+
+    while (n_items > item_budget)
+    {
+        evict_one(nullptr);
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::stats() const -> StatsResult
+{
+    StatsResult results{};
+
+    results.item_budget = item_budget;
+    results.hits        = n_hits;
+    results.misses      = n_lookups - n_hits;
+    results.evictions   = n_evictions;
+    results.resizes     = n_resizes;
+
+    if (is_mapped())
+    {
+        results.count        = n_items;
+        results.capacity     = snapshot_n_buckets;
+        results.max_capacity = max_capacity;
+
+        results.load_factor 
+            = static_cast<double>(n_items) / static_cast<double>(snapshot_n_buckets);
+
+        results.min_bucket_depth = std::numeric_limits<std::size_t>::max();
+        results.max_bucket_depth = 0;
+        for (auto i = 0ul; i < snapshot_n_buckets; ++i)
+        {
+            std::size_t const depth = snapshot_offsets[i + 1] - snapshot_offsets[i];
+            results.min_bucket_depth = std::min(depth, results.min_bucket_depth);
+            results.max_bucket_depth = std::max(depth, results.max_bucket_depth);
+        }
+
+        results.avg_bucket_depth = n_items / snapshot_n_buckets;
+        return results;
+    }
+
+    results.count        = n_items;
+    results.capacity     = capacity;
+    results.max_capacity = max_capacity;
+
+    results.load_factor 
+        = static_cast<double>(n_items) / static_cast<double>(capacity);
+
+    std::size_t min_length = std::numeric_limits<std::size_t>::max();
+    std::size_t max_length = 0;
+    std::size_t sum_length = 0;
+    for (auto i = 0ul; i < capacity; ++i)
+    {   
+        auto& bucket = buckets[i];
+        min_length = std::min<std::size_t>(bucket.n_items, min_length);
+        max_length = std::max<std::size_t>(bucket.n_items, max_length);
+        sum_length += bucket.n_items;
+    }
+
+    // during an incremental resize, the chains that remain in the 
+    // old table are not yet accounted for by the current table
+    for (auto i = migrate_cursor; resize_in_progress() && i < old_capacity; ++i)
+    {
+        auto& bucket = old_buckets[i];
+        max_length = std::max<std::size_t>(bucket.n_items, max_length);
+        sum_length += bucket.n_items;
+    }
+
+    results.min_bucket_depth = min_length;
+    results.max_bucket_depth = max_length;
+    results.avg_bucket_depth = sum_length / capacity;
+
+    return results;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::begin() -> Iterator
+{
+    if (is_mapped())
+    {
+        return Iterator{this, nullptr, snapshot_entries};
+    }
+
+    auto iter = Iterator{this, nullptr, nullptr};
+    iter.seek_from(0);
+    return iter;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::end() -> Iterator
+{
+    if (is_mapped())
+    {
+        return Iterator{this, nullptr, snapshot_entries + n_items};
+    }
+
+    return Iterator{this, nullptr, nullptr};
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename Fn>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::for_each_parallel(
+    std::size_t const n_threads, 
+    Fn                fn) -> void
+{
+    scan_partitioned(n_threads, 
+        [this, &fn](std::size_t const, std::size_t const first, std::size_t const last) {
+            scan_buckets(first, last, fn);
+        });
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename T, 
+    typename Fold, 
+    typename Combine>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::reduce(
+    std::size_t const n_threads, 
+    T                 init, 
+    Fold              fold, 
+    Combine           combine) const -> T
+{
+    // each thread publishes its result to a slot of its own
+    std::vector<std::optional<T>> partials(std::max(n_threads, 1ul));
+
+    scan_partitioned(n_threads, 
+        [this, &init, &fold, &partials](std::size_t const index, std::size_t const first, std::size_t const last) {
+            auto acc = init;
+            scan_buckets(first, last, [&fold, &acc](KeyT const& key, ValueT const& value) {
+                acc = fold(std::move(acc), key, value);
+            });
+            partials[index].emplace(std::move(acc));
+        });
+
+    auto result = std::move(*partials.front());
+    for (auto i = 1ul; i < partials.size(); ++i)
+    {
+        result = combine(std::move(result), std::move(*partials[i]));
+    }
+
+    return result;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::scan() 
+    -> coro::generator<std::pair<KeyT const&, ValueT&>>
+{
+    using ItemType = std::pair<KeyT const&, ValueT&>;
+
+    if (is_mapped())
+    {
+        for (auto* item = snapshot_entries; item != snapshot_entries + n_items; ++item)
+        {
+            co_yield ItemType{item->key, item->value};
+        }
+
+        co_return;
+    }
+
+    auto const extent = scan_extent();
+    for (auto i = 0ul; i < extent; ++i)
+    {
+        if (i + SCAN_PREFETCH_DISTANCE < extent)
+        {
+            _mm_prefetch(reinterpret_cast<char const*>(
+                scan_bucket(i + SCAN_PREFETCH_DISTANCE).first), _MM_HINT_T0);
+        }
+
+        for (auto* entry = scan_bucket(i).first; entry != nullptr; entry = entry->next)
+        {
+            // the next entry in the chain is fetched while the consumer
+            // processes this one; prefetching nullptr is harmless
+            _mm_prefetch(reinterpret_cast<char const*>(entry->next), _MM_HINT_T0);
+            co_yield ItemType{entry->key, entry->value};
+        }
+    }
+}
+
+#if defined(MAPPED_FILE_SUPPORTED)
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::save(std::string const& path) const -> void
+{
+    static_assert(std::is_trivially_copyable_v<KeyT> && std::is_trivially_copyable_v<ValueT>,
+        "snapshots require trivially-copyable keys and values");
+
+    // a mapped map has the layout of a snapshot already
+    if (is_mapped())
+    {
+        auto file = MappedFile::create_shared(path, snapshot.size());
+        std::memcpy(file.data(), snapshot.data(), snapshot.size());
+        file.flush();
+        return;
+    }
+
+    if (n_items > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::runtime_error{"map is too large to snapshot"};
+    }
+
+    // the snapshot need not retain the sparsity of the table;
+    // an average of one entry per bucket keeps the offsets compact
+    auto const n_buckets      = std::bit_ceil(std::max(n_items, 1ul));
+    auto const entries_offset = snapshot_entries_offset(n_buckets);
+
+    auto file = MappedFile::create_shared(
+        path, entries_offset + n_items * sizeof(SnapshotEntry));
+
+    new (file.data()) SnapshotHeader{
+        SNAPSHOT_MAGIC,
+        SNAPSHOT_VERSION,
+        static_cast<std::uint32_t>(sizeof(SnapshotEntry)),
+        static_cast<std::uint32_t>(sizeof(KeyT)),
+        static_cast<std::uint32_t>(sizeof(ValueT)),
+        n_items,
+        n_buckets,
+        capacity,
+        max_capacity,
+        static_cast<std::uint32_t>(resize_mode),
+        0};
+
+    // the file is zero-filled upon creation, and so are the offsets
+    auto* offsets = reinterpret_cast<std::uint32_t*>(file.data() + sizeof(SnapshotHeader));
+    auto* entries = reinterpret_cast<SnapshotEntry*>(file.data() + entries_offset);
+
+    auto const bucket_of = [this, n_buckets](Entry const& entry) {
+        return hash_of(entry) & (n_buckets - 1);
+    };
+
+    // counting sort of the entries by bucket: count the entries of 
+    // each bucket, then derive the first position of each bucket
+    for_each_entry([&](Entry const& entry) {
+        ++offsets[bucket_of(entry) + 1];
+    });
+
+    for (auto i = 1ul; i <= n_buckets; ++i)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+
+    // the offset of each bucket serves as its cursor while scattering,
+    // after which it holds the first position of the next bucket
+    for_each_entry([&](Entry const& entry) {
+        auto& cursor = offsets[bucket_of(entry)];
+        new (&entries[cursor++]) SnapshotEntry{entry.key, entry.value};
+    });
+
+    std::memmove(offsets + 1, offsets, n_buckets * sizeof(std::uint32_t));
+    offsets[0] = 0;
+
+    file.flush();
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::load_mapped(std::string const& path) -> Map
+{
+    auto file = MappedFile::map_private(path);
+
+    // the header lies within the mapping, which moves with the file
+    auto const& header = snapshot_header(file);
+    return Map{std::move(file), header};
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Internal Definitions
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template < 
+    typename K,
+    typename Scheduler, 
+    typename OnFound, 
+    typename OnNotFound>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::lookup_task(
+    std::allocator_arg_t,
+    Throttler<Scheduler>&,
+    K const               key, 
+    Scheduler const&      scheduler,
+    OnFound               on_found, 
+    OnNotFound            on_not_found) -> LookupKVTask<Scheduler>
+{
+    ++n_lookups;
+
+    auto const hash = hasher(key);
+    auto const tag  = tag_for_hash(hash);
+
+    // the bucket array is not cached once the table outgrows the
+    // cache, so the bucket slot is prefetched in its own stage before
+    // any of the entries in its chain; the table is not mutated 
+    // during a multilookup, so the slot remains valid across the stage
+    auto const suspend = should_suspend();
+
+    // a lookup for an absent key is (usually) resolved by the lookup 
+    // filter, whose line is prefetched alongside the first line of the
+    // lookup proper rather than in a stage of its own; hits then pay
+    // for the filter with bandwidth alone, not with a suspension
+    if (is_mapped())
+    {
+        // the offsets and the entries of a snapshot are separate arrays
+        auto const* offsets = snapshot_offsets + (hash & (snapshot_n_buckets - 1));
+        if (suspend)
+        {
+            co_await prefetch_and_schedule_on(stage_with_filter(offsets, hash), scheduler);
+        }
+
+        if (filter_rejects(hash) || offsets[0] == offsets[1])
+        {
+            // not found
+            co_return on_not_found();
+        }
+
+        auto* entry = co_await prefetch_and_schedule_on(snapshot_entries + offsets[0], scheduler, suspend);
+        for (auto* end = snapshot_entries + offsets[1]; entry != end; ++entry)
+        {
+            if (key == entry->key)
+            {
+                ++n_hits;
+                co_return on_found(entry->key, entry->value);
+            }
+        }
+
+        // not found
+        co_return on_not_found();
+    }
+
+    // when the bucket array is small enough to be cached, the (far
+    // smaller) filter is too, and so is queried without any prefetch
+    auto* bucket = &bucket_for_hash(hash);
+    if (suspend && capacity * sizeof(Bucket) > STAGED_BUCKET_THRESHOLD)
+    {
+        co_await prefetch_and_schedule_on(stage_with_filter(bucket, hash), scheduler);
+    }
+    if (filter_rejects(hash) || !chain_may_contain(*bucket, tag))
+    {
+        // not found
+        co_return on_not_found();
+    }
+
+    auto* entry = co_await prefetch_and_schedule_on(bucket->first, scheduler, suspend);
+    for (;;)
+    {
+        if (entry_matches(*entry, key, hash))
+        {
+            // the bucket was read just before the chain, so marking
+            // it referenced costs no miss of its own (see record_hit())
+            record_hit(*bucket);
+            co_return on_found(entry->key, entry->value);
+        }
+
+        if (nullptr == entry->next)
+        {
+            // reached the end of the bucket chain
+            break;
+        }
+
+        // traverse the linked-list of entries for this bucket
+        entry = co_await prefetch_and_schedule_on(entry->next, scheduler, suspend);
+    }
+
+    // not found
+    co_return on_not_found();
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template < 
+    typename Scheduler, 
+    typename Operation>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::mutation_task(
+    KeyT const       key, 
+    Scheduler const& scheduler,
+    Operation        operation) -> LookupKVTask<Scheduler>
+{
+    // walk the bucket chain for this key, prefetching each
+    // node that the operation is about to touch; the walk only
+    // warms the cache, the operation itself performs its own walk
+    // (now hitting in cache) once no more suspension points remain, 
+    // so it never acts on a chain that was modified while suspended
+    auto const hash    = hasher(key);
+    auto const suspend = should_suspend();
+    co_await prefetch_and_schedule_on(&bucket_for_hash(hash), scheduler, suspend);
+
+    // another operation may have resized the table while we were
+    // suspended, so the bucket is located again rather than relying
+    // on the address that was prefetched; entries are never freed
+    // while the batch is in progress, so a stale chain is still safe
+    auto* entry = bucket_for_hash(hash).first;
+    while (entry != nullptr)
+    {
+        entry = co_await prefetch_and_schedule_on(entry, scheduler, suspend);
+        if (entry_matches(*entry, key, hash))
+        {
+            break;
+        }
+
+        entry = entry->next;
+    }
+
+    co_return operation();
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <
+    typename BeginInputIter, 
+    typename EndInputIter, 
+    typename Scheduler,
+    typename MakeOperation>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::interleaved_multimutate(
+    BeginInputIter    begin_inputs,
+    EndInputIter      end_inputs,
+    Scheduler const&  scheduler,
+    std::size_t const n_streams,
+    MakeOperation     make_operation) -> void
+{
+    // the operations of the batch walk the ordinary table
+    if (is_mapped())
+    {
+        materialize();
+    }
+
+    batch_in_progress = true;
+
+    {
+        // instantiate a throttler for this batch
+        Throttler throttler{scheduler, n_streams};
+
+        for (auto iter = begin_inputs; iter != end_inputs; ++iter)
+        {
+            auto [key, operation] = make_operation(*iter);
+            throttler.spawn(mutation_task(key, scheduler, std::move(operation)));
+        }
+
+        // run until all mutation tasks complete
+        throttler.run();
+    }
+
+    batch_in_progress = false;
+
+    for (auto* entry : retired)
+    {
+        destroy_entry(entry);
+    }
+
+    retired.clear();
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::bucket_for_hash(
+    std::size_t const hash) const -> Bucket&
+{
     // NOTE: we rely on the fact that the number of buckets
-    // in the internal table is always a power of 2 here
-    return (hash & (capacity - 1));
+    // in the internal table(s) is always a power of 2 here
+
+    if (resize_in_progress())
+    {
+        // the migration cursor tells us exactly which of the two
+        // tables holds the key, so only one of them is ever probed
+        auto const old_index = (hash & (old_capacity - 1));
+        if (old_index >= migrate_cursor)
+        {
+            return old_buckets[old_index];
+        }
+    }
+
+    return buckets[hash & (capacity - 1)];
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename K>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::lookup_in_bucket(
+    Bucket const&     bucket, 
+    K const&          key, 
+    std::size_t const hash) const -> LookupKVResult
+{
+    if (filter_rejects(hash) || !chain_may_contain(bucket, tag_for_hash(hash)))
+    {
+        // not found
+        return LookupKVResult{};
+    }
+
+    auto* entry = bucket.first;
+    for (;;)
+    {
+        if (entry_matches(*entry, key, hash))
+        {
+            return LookupKVResult{entry->key, entry->value};
+        }
+
+        if (nullptr == entry->next)
+        {
+            // reached the end of the bucket chain
+            break;
+        }
+
+        // traverse the linked-list of entries for this bucket
+        entry = entry->next;
+    }
+
+    // not found
+    return LookupKVResult{};
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename K>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::entry_matches(
+    Entry const&      entry, 
+    K const&          key, 
+    std::size_t const hash) -> bool
+{
+    if constexpr (STORES_HASH)
+    {
+        return (hash == entry.hash) && (key == entry.key);
+    }
+    else
+    {
+        static_cast<void>(hash);
+        return (key == entry.key);
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::hash_of(Entry const& entry) const -> std::size_t
+{
+    if constexpr (STORES_HASH)
+    {
+        return entry.hash;
+    }
+    else
+    {
+        return hasher(entry.key);
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::tag_for_hash(
+    std::size_t const hash) -> std::uint32_t
+{
+    constexpr auto const shift = std::numeric_limits<std::size_t>::digits - TAG_BITS;
+    return static_cast<std::uint32_t>((hash * TAG_MULTIPLIER) >> shift);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::filter_rejects(
+    std::size_t const hash) const -> bool
+{
+    // a disabled filter rejects nothing
+    return lookup_filter.enabled() && !lookup_filter.may_contain(hash);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::stage_with_filter(
+    void const*       line, 
+    std::size_t const hash) const -> void const*
+{
+    if (!lookup_filter.enabled())
+    {
+        return line;
+    }
+
+    // both lines are requested ahead of a single suspension; a prefetch
+    // may be dropped while another misses in the TLB, so the line of the
+    // filter (which is consulted first upon resumption) is requested last
+    _mm_prefetch(reinterpret_cast<char const*>(line), _MM_HINT_NTA);
+    return &lookup_filter.block_for(hash);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::chain_may_contain(
+    Bucket const&       bucket, 
+    std::uint32_t const tag) -> bool
+{
+    // a chain of a single entry can be ruled out by its tag alone;
+    // longer chains must be walked regardless, as the tag only
+    // describes the first entry and the walk requires its `next`
+    return (bucket.n_items > 1) 
+        || (1 == bucket.n_items && tag == bucket.first_tag);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::perform_resize_if_required() -> void
+{   
+    if (!resize_required()) [[likely]]
+    {
+        return;
+    }
+
+    if (resize_in_progress())
+    {
+        // the previous resize must complete before the next begins
+        migrate_buckets(old_capacity - migrate_cursor);
+    }
+
+    // double the size of the table on resize; the current
+    // table becomes the old table that is migrated from
+    old_buckets    = buckets;
+    old_capacity   = capacity;
+    migrate_cursor = 0;
+
+    capacity = (capacity << 1);
+    buckets  = allocate_buckets(capacity);
+    ++n_resizes;
+
+    if (ResizeMode::Immediate == resize_mode)
+    {
+        migrate_buckets(old_capacity);
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::resize_required() const -> bool
+{
+    // QUESTION: which of these is likely to lead to more effective short-circuit? 
+
+    auto const load_factor_exceeded = (static_cast<double>(n_items) 
+        / static_cast<double>(capacity)) > MAX_LOAD_FACTOR;
+    
+    auto const capacity_available = (capacity << 1) <= max_capacity; 
+    
+    return load_factor_exceeded && capacity_available;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::resize_in_progress() const -> bool
+{
+    return (old_buckets != nullptr);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::footprint() const -> std::size_t
+{
+    if (is_mapped())
+    {
+        return snapshot.size() + lookup_filter.footprint();
+    }
+
+    // chain walks touch entries as well as buckets, so both count
+    return (capacity + old_capacity) * sizeof(Bucket) + n_items * sizeof(Entry) 
+        + lookup_filter.footprint();
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::should_suspend() const -> bool
+{
+    return prefetch_should_suspend(prefetch_policy, footprint(), cache_budget);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::note_mutation() -> void
+{
+#ifndef NDEBUG
+    ++mutation_epoch;
+#endif
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename Visitor>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::for_each_entry(Visitor&& visitor) const -> void
+{
+    auto const visit_chain = [&visitor](Bucket const& bucket) {
+        for (auto* entry = bucket.first; entry != nullptr; entry = entry->next)
+        {
+            visitor(*entry);
+        }
+    };
+
+    for (auto i = 0ul; i < capacity; ++i)
+    {
+        visit_chain(buckets[i]);
+    }
+
+    // buckets below the cursor have already been emptied
+    for (auto i = migrate_cursor; resize_in_progress() && i < old_capacity; ++i)
+    {
+        visit_chain(old_buckets[i]);
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::scan_extent() const -> std::size_t
+{
+    if (is_mapped())
+    {
+        return snapshot_n_buckets;
+    }
+
+    // the old table is only scanned from the cursor onwards, 
+    // as buckets below the cursor have already been emptied
+    return capacity + (resize_in_progress() ? old_capacity - migrate_cursor : 0);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::scan_bucket(
+    std::size_t const index) const -> Bucket&
+{
+    // scan order covers the current table, then the unmigrated 
+    // remainder of the old table (not applicable to a mapped map)
+    return (index < capacity) 
+        ? buckets[index] 
+        : old_buckets[migrate_cursor + (index - capacity)];
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename Visitor>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::scan_buckets(
+    std::size_t const first, 
+    std::size_t const last, 
+    Visitor&&         visitor) const -> void
+{
+    if (is_mapped())
+    {
+        auto* end = snapshot_entries + snapshot_offsets[last];
+        for (auto* item = snapshot_entries + snapshot_offsets[first]; item != end; ++item)
+        {
+            visitor(std::as_const(item->key), item->value);
+        }
+
+        return;
+    }
+
+    for (auto i = first; i < last; ++i)
+    {
+        if (i + SCAN_PREFETCH_DISTANCE < last)
+        {
+            _mm_prefetch(reinterpret_cast<char const*>(
+                scan_bucket(i + SCAN_PREFETCH_DISTANCE).first), _MM_HINT_T0);
+        }
+
+        for (auto* entry = scan_bucket(i).first; entry != nullptr; entry = entry->next)
+        {
+            _mm_prefetch(reinterpret_cast<char const*>(entry->next), _MM_HINT_T0);
+            visitor(std::as_const(entry->key), entry->value);
+        }
+    }
 }
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::perform_resize_if_required() -> void
-{   
-    if (!resize_required()) [[likely]]
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename ScanRange>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::scan_partitioned(
+    std::size_t const n_threads, 
+    ScanRange         scan_range) const -> void
+{
+    auto const n_ranges = std::max(n_threads, 1ul);
+    auto const extent   = scan_extent();
+
+    // the i-th of `n_ranges` contiguous ranges of buckets
+    auto const range_bound = [=](std::size_t const i) {
+        return extent * i / n_ranges;
+    };
+
+    // an exception thrown on any thread is rethrown on 
+    // the calling thread once all threads have been joined
+    std::vector<std::exception_ptr> errors(n_ranges);
+    auto const run_range = [&](std::size_t const i) {
+        try
+        {
+            scan_range(i, range_bound(i), range_bound(i + 1));
+        }
+        catch (...)
+        {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    {
+        // the threads are joined upon leaving this scope on every path,
+        // including a failure to start one of them
+        std::vector<std::jthread> threads{};
+        threads.reserve(n_ranges - 1);
+        for (auto i = 1ul; i < n_ranges; ++i)
+        {
+            threads.emplace_back(run_range, i);
+        }
+
+        run_range(0);
+    }
+
+    for (auto& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::is_mapped() const -> bool
+{
+    return static_cast<bool>(snapshot);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+template <typename K>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::find_in_snapshot(
+    K const&          key, 
+    std::size_t const hash) const -> SnapshotEntry*
+{
+    auto const index = hash & (snapshot_n_buckets - 1);
+    
+    auto* end = snapshot_entries + snapshot_offsets[index + 1];
+    for (auto* entry = snapshot_entries + snapshot_offsets[index]; entry != end; ++entry)
+    {
+        if (key == entry->key)
+        {
+            return entry;
+        }
+    }
+
+    return nullptr;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::rebuild_lookup_filter(
+    std::size_t const n_expected) -> void
+{
+    lookup_filter.reset(n_expected);
+
+    if (is_mapped())
     {
+        for (auto i = 0ul; i < n_items; ++i)
+        {
+            lookup_filter.insert(hasher(snapshot_entries[i].key));
+        }
+
         return;
     }
 
-    // double the size of the table on resize
-    auto const new_capacity = (capacity << 1);
-    auto* new_buckets = new Bucket[new_capacity];
+    for_each_entry([this](Entry const& entry) {
+        lookup_filter.insert(hash_of(entry));
+    });
+}
 
-    for (auto i = 0ul; i < capacity; ++i)
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::remove_from_lookup_filter() -> void
+{
+    if (lookup_filter.enabled())
     {
-        // iterate over each bucket in the current table
-        auto& bucket = buckets[i];
+        lookup_filter.remove();
+        if (lookup_filter.rebuild_required())
+        {
+            rebuild_lookup_filter(n_items);
+        }
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::record_hit(Bucket& bucket) -> void
+{
+    ++n_hits;
+
+    // the bucket is only written while the map is bounded, and then
+    // only if the bit is not already set, such that repeated hits on
+    // a hot bucket do not dirty its line (which the lookup just read)
+    if (item_budget != DEFAULT_ITEM_BUDGET && 0 == bucket.referenced)
+    {
+        bucket.referenced = 1;
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::evict_if_over_budget(Entry const* keep) -> void
+{
+    if (n_items <= item_budget) [[likely]]
+    {
+        return;
+    }
+
+    // an insertion counts as a reference to the bucket of the new entry
+    bucket_for_hash(hash_of(*keep)).referenced = 1;
+
+    evict_one(keep);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::evict_one(Entry const* keep) -> void
+{
+    // the hand sweeps only the current table; a map at its budget no
+    // longer grows, so an incremental resize here is rare, and is simply
+    // completed such that every entry is within reach of the hand
+    if (resize_in_progress())
+    {
+        migrate_buckets(old_capacity - migrate_cursor);
+    }
+
+    // the hand clears the reference bit of each bucket it passes, so it
+    // finds an unreferenced chain within two sweeps of the table; the
+    // first entry of the chain (the oldest) is evicted, unless it is 
+    // `keep` (the entry just inserted); entries are appended at the tail
+    // of a chain, so `keep` is only its first entry when it is alone
+    for (;;)
+    {
+        auto& bucket = buckets[clock_hand];
+        clock_hand = (clock_hand + 1) & (capacity - 1);
+
+        if (0 == bucket.n_items || bucket.first == keep)
+        {
+            continue;
+        }
+
+        if (bucket.referenced != 0)
+        {
+            bucket.referenced = 0;
+            continue;
+        }
+
+        auto* entry = bucket.first;
+        if (entry->next != nullptr)
+        {
+            bucket.first     = entry->next;
+            bucket.set_first_tag(tag_for_hash(hash_of(*entry->next)));
+        }
+        else
+        {
+            bucket.first = nullptr;
+        }
+
+        retire_entry(entry);
+        --bucket.n_items;
+        --n_items;
+        ++n_evictions;
+
+        remove_from_lookup_filter();
+
+        return;
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::materialize() -> void
+{
+    // the table is sized as it was when the snapshot was saved,
+    // such that repopulating it never triggers a resize; the header
+    // was validated when the snapshot was loaded
+    auto const& header = *reinterpret_cast<SnapshotHeader const*>(snapshot.data());
+
+    auto* table = allocate_buckets(header.capacity);
+    free_buckets(buckets, capacity);
+
+    buckets  = table;
+    capacity = header.capacity;
+
+    // each entry is added to the filter anew as it is copied
+    if (lookup_filter.enabled())
+    {
+        lookup_filter.reset(n_items);
+    }
+
+    for (auto i = 0ul; i < n_items; ++i)
+    {
+        auto& item = snapshot_entries[i];
+        auto const hash = hasher(item.key);
+        insert_into_bucket(bucket_for_hash(hash), make_entry(item.key, item.value, hash), tag_for_hash(hash));
+    }
+
+    snapshot_offsets   = nullptr;
+    snapshot_entries   = nullptr;
+    snapshot_n_buckets = 0;
+
+    snapshot = MappedFile{};
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::snapshot_header(
+    MappedFile const& file) -> SnapshotHeader const&
+{
+    if (file.size() < sizeof(SnapshotHeader))
+    {
+        throw std::runtime_error{"snapshot is truncated"};
+    }
+
+    auto const& header = *reinterpret_cast<SnapshotHeader const*>(file.data());
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION)
+    {
+        throw std::runtime_error{"file is not a supported map snapshot"};
+    }
+
+    if (header.entry_size != sizeof(SnapshotEntry)
+     || header.key_size   != sizeof(KeyT)
+     || header.value_size != sizeof(ValueT))
+    {
+        throw std::runtime_error{"snapshot key or value type does not match"};
+    }
+
+    if (!std::has_single_bit(header.n_buckets) 
+     || !std::has_single_bit(header.capacity)
+     || header.resize_mode > static_cast<std::uint32_t>(ResizeMode::Incremental))
+    {
+        throw std::runtime_error{"snapshot header is corrupt"};
+    }
+
+    // each bound is checked before it is used in the next, 
+    // such that none of the computations below may overflow
+    if (header.n_buckets > (file.size() - sizeof(SnapshotHeader)) / sizeof(std::uint32_t)
+     || snapshot_entries_offset(header.n_buckets) > file.size()
+     || header.n_items > (file.size() - snapshot_entries_offset(header.n_buckets)) / sizeof(SnapshotEntry)
+     || file.size() != snapshot_entries_offset(header.n_buckets) + header.n_items * sizeof(SnapshotEntry))
+    {
+        throw std::runtime_error{"snapshot is truncated"};
+    }
+
+    // lookups and scans index the entries by the offsets directly, so
+    // every bucket must lie within the entries: the offsets begin at 0,
+    // never decrease, and end at the number of entries
+    auto const* offsets = reinterpret_cast<std::uint32_t const*>(file.data() + sizeof(SnapshotHeader));
+    if (offsets[0] != 0 || offsets[header.n_buckets] != header.n_items)
+    {
+        throw std::runtime_error{"snapshot bucket offsets are corrupt"};
+    }
+
+    for (auto i = 0ul; i < header.n_buckets; ++i)
+    {
+        if (offsets[i + 1] < offsets[i])
+        {
+            throw std::runtime_error{"snapshot bucket offsets are corrupt"};
+        }
+    }
+
+    return header;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::snapshot_entries_offset(
+    std::size_t const n_buckets) -> std::size_t
+{
+    auto const end_of_offsets = sizeof(SnapshotHeader) + (n_buckets + 1) * sizeof(std::uint32_t);
+    return (end_of_offsets + SNAPSHOT_ALIGNMENT - 1) & ~(SNAPSHOT_ALIGNMENT - 1);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::migrate_buckets(
+    std::size_t const n_buckets) -> void
+{
+    auto const end = std::min(migrate_cursor + n_buckets, old_capacity);
+    for (; migrate_cursor < end; ++migrate_cursor)
+    {
+        // iterate over each bucket in the old table
+        auto& bucket = old_buckets[migrate_cursor];
         
         auto* entry = bucket.first;
         while (entry != nullptr)
         {
             // compute the new bucket index for this entry
-            auto const new_index = (hasher(entry->key) & (new_capacity - 1));
+            auto const hash      = hash_of(*entry);
+            auto const new_index = (hash & (capacity - 1));
 
             // grab a reference to the new bucket for this entry
-            auto& new_bucket = new_buckets[new_index];
+            auto& new_bucket = buckets[new_index];
 
             // the insertion into the new bucket alters the `next` pointer for `entry`
             auto* tmp_next = entry->next;
-            insert_into_bucket(new_bucket, entry);
+            insert_into_bucket(new_bucket, entry, tag_for_hash(hash));
+            new_bucket.referenced |= bucket.referenced;
 
             entry = tmp_next;
         }
     }
 
-    delete[] buckets;
+    if (migrate_cursor == old_capacity)
+    {
+        // migration complete; the old table is no longer referenced
+        free_buckets(old_buckets, old_capacity);
 
-    buckets  = new_buckets;
-    capacity = new_capacity;
+        old_buckets    = nullptr;
+        old_capacity   = 0;
+        migrate_cursor = 0;
+    }
 }
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::resize_required() const -> bool
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::allocate_buckets(
+    std::size_t const n_buckets) const -> Bucket*
 {
-    // QUESTION: which of these is likely to lead to more effective short-circuit? 
+    static_assert(std::is_trivially_copyable_v<Bucket>);
+
+    // zero-filled memory is a valid array of empty buckets; large
+    // requests are satisfied by fresh pages that the system zeroes 
+    // on first touch, so the cost of clearing the array is spread over 
+    // the operations that touch it rather than paid up front by the 
+    // operation that triggers a resize
+    if (backs_with_huge_pages(n_buckets))
+    {
+        return static_cast<Bucket*>(allocate_huge_pages(n_buckets * sizeof(Bucket)));
+    }
 
-    auto const load_factor_exceeded = (static_cast<double>(n_items) 
-        / static_cast<double>(capacity)) > MAX_LOAD_FACTOR;
-    
-    auto const capacity_available = (capacity << 1) <= max_capacity; 
-    
-    return load_factor_exceeded && capacity_available;
+    auto* array = static_cast<Bucket*>(std::calloc(n_buckets, sizeof(Bucket)));
+    if (nullptr == array)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return array;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::free_buckets(
+    Bucket*           array, 
+    std::size_t const n_buckets) const -> void
+{
+    if (backs_with_huge_pages(n_buckets))
+    {
+        free_huge_pages(array, n_buckets * sizeof(Bucket));
+    }
+    else
+    {
+        std::free(array);
+    }
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::backs_with_huge_pages(
+    std::size_t const n_buckets) const -> bool
+{
+    // an array smaller than a huge page spans few base pages, 
+    // so rounding it up to a whole huge page would be wasted
+    return PageSize::Huge == page_size && n_buckets * sizeof(Bucket) >= HUGE_PAGE_SIZE;
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::make_allocator(
+    PageSize const page_size_) -> EntryAllocator<Entry>
+{
+    if constexpr (std::is_constructible_v<EntryAllocator<Entry>, PageSize>)
+    {
+        return EntryAllocator<Entry>{page_size_};
+    }
+    else
+    {
+        return EntryAllocator<Entry>{};
+    }
 }
 
 template <
     typename KeyT, 
     typename ValueT, 
-    typename Hasher>
-auto Map<KeyT, ValueT, Hasher>::insert_into_bucket(
-    Bucket& bucket, 
-    Entry*  entry) -> void
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::insert_into_bucket(
+    Bucket&             bucket, 
+    Entry*              entry, 
+    std::uint32_t const tag) -> void
 {
     // ensure the `next` pointer for the new entry is nulled-out
     entry->next = nullptr;
@@ -919,7 +3438,8 @@ auto Map<KeyT, ValueT, Hasher>::insert_into_bucket(
     auto* current = bucket.first;
     if (nullptr == current)
     {
-        bucket.first = entry;
+        bucket.first     = entry;
+        bucket.set_first_tag(tag);
     }
     else
     {
@@ -931,6 +3451,61 @@ auto Map<KeyT, ValueT, Hasher>::insert_into_bucket(
     ++bucket.n_items;
 }
 
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::make_entry(
+    KeyT const&       key, 
+    ValueT&           value, 
+    std::size_t const hash) -> Entry*
+{
+    if (lookup_filter.enabled())
+    {
+        // the new entry is not yet linked, so it is 
+        // added to the filter only once it is rebuilt
+        if (lookup_filter.rebuild_required())
+        {
+            rebuild_lookup_filter(n_items + 1);
+        }
+
+        lookup_filter.insert(hash);
+    }
+
+    return ::new (static_cast<void*>(allocator.allocate())) Entry{key, value, hash};
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::destroy_entry(Entry* entry) -> void
+{
+    entry->~Entry();
+    allocator.deallocate(entry);
+}
+
+template <
+    typename KeyT, 
+    typename ValueT, 
+    typename Hasher,
+    template <typename> typename EntryAllocator>
+auto Map<KeyT, ValueT, Hasher, EntryAllocator>::retire_entry(Entry* entry) -> void
+{
+    if (batch_in_progress)
+    {
+        // a suspended operation in the current batch may still refer to 
+        // this entry; keep it alive (though unlinked) until the batch completes
+        retired.push_back(entry);
+    }
+    else
+    {
+        destroy_entry(entry);
+    }
+}
+
 // ----------------------------------------------------------------------------
 // Misc. Helper Defintions
 
@@ -0,0 +1,166 @@
+// mapped_file.hpp
+// An RAII wrapper for a memory-mapped file.
+//
+// Files may only be mapped where the system provides mmap(); elsewhere
+// MAPPED_FILE_SUPPORTED is left undefined, and a MappedFile is only ever
+// empty, such that code that merely holds one remains portable.
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <cstddef>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_SUPPORTED
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <libcoro/nix/unique_fd.hpp>
+#include <libcoro/nix/system_error.hpp>
+#endif
+
+class MappedFile
+{
+    // the base address of the mapping, or nullptr if none
+    void* base;
+
+    // the size of the mapping, in bytes
+    std::size_t length;
+
+public:
+    MappedFile()
+        : base{nullptr}, length{0} {}
+
+    ~MappedFile()
+    {
+        unmap();
+    }
+
+    // non-copyable
+    MappedFile(MappedFile const&)            = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    MappedFile(MappedFile&& rhs)
+        : base{std::exchange(rhs.base, nullptr)}
+        , length{std::exchange(rhs.length, 0)} {}
+
+    MappedFile& operator=(MappedFile&& rhs)
+    {
+        if (std::addressof(rhs) != this)
+        {
+            unmap();
+
+            base   = std::exchange(rhs.base, nullptr);
+            length = std::exchange(rhs.length, 0);
+        }
+
+        return *this;
+    }
+
+#if defined(MAPPED_FILE_SUPPORTED)
+    // Map the entirety of the existing file at `path` privately;
+    // writes through the mapping are copy-on-write, per page,
+    // and are never carried through to the file itself.
+    static auto map_private(std::string const& path) -> MappedFile
+    {
+        auto fd = coro::nix::unique_fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (!fd)
+        {
+            throw coro::nix::system_error{};
+        }
+
+        struct stat st{};
+        if (::fstat(fd.get(), &st) == -1)
+        {
+            throw coro::nix::system_error{};
+        }
+
+        // the mapping remains valid once the descriptor is closed
+        return MappedFile{fd.get(), static_cast<std::size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE};
+    }
+
+    // Create (or truncate) the file at `path` with a size of
+    // `length_` bytes and map it such that writes are carried through.
+    static auto create_shared(std::string const& path, std::size_t const length_) -> MappedFile
+    {
+        auto fd = coro::nix::unique_fd{::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+        if (!fd)
+        {
+            throw coro::nix::system_error{};
+        }
+
+        if (::ftruncate(fd.get(), static_cast<off_t>(length_)) == -1)
+        {
+            throw coro::nix::system_error{};
+        }
+
+        return MappedFile{fd.get(), length_, PROT_READ | PROT_WRITE, MAP_SHARED};
+    }
+#endif
+
+    auto data() const -> std::byte*
+    {
+        return static_cast<std::byte*>(base);
+    }
+
+    auto size() const -> std::size_t
+    {
+        return length;
+    }
+
+    explicit operator bool() const
+    {
+        return base != nullptr;
+    }
+
+#if defined(MAPPED_FILE_SUPPORTED)
+    // Write any modifications to a shared mapping back to the file.
+    void flush() const
+    {
+        if (base != nullptr && ::msync(base, length, MS_SYNC) == -1)
+        {
+            throw coro::nix::system_error{};
+        }
+    }
+#endif
+
+private:
+#if defined(MAPPED_FILE_SUPPORTED)
+    MappedFile(int const fd, std::size_t const length_, int const prot, int const flags)
+        : base{nullptr}, length{length_}
+    {
+        // a zero-length mapping is invalid, but also never needed
+        if (0 == length)
+        {
+            return;
+        }
+
+        auto* address = ::mmap(nullptr, length, prot, flags, fd, 0);
+        if (MAP_FAILED == address)
+        {
+            throw coro::nix::system_error{};
+        }
+
+        base = address;
+    }
+#endif
+
+    void unmap()
+    {
+#if defined(MAPPED_FILE_SUPPORTED)
+        if (base != nullptr)
+        {
+            ::munmap(base, length);
+            base = nullptr;
+        }
+#endif
+    }
+};
+
+#endif // MAPPED_FILE_HPP
@@ -5,26 +5,60 @@
 #ifndef PREFETCH_HPP
 #define PREFETCH_HPP
 
+#include <cstdlib>
 #include <stdcoro/coroutine.hpp>
 
 #include <xmmintrin.h>
 
+// The strategy by which a data structure decides whether
+// its interleaved operations suspend on each prefetch.
+enum class PrefetchPolicy
+{
+    // always prefetch and suspend; the target is assumed not to be cached
+    AlwaysSuspend,
+    // never suspend; the target is assumed to be cached already
+    NeverSuspend,
+    // suspend only once the footprint of the structure exceeds a cache budget
+    SizeHeuristic
+};
+
+// Determine whether an operation on a structure with the given
+// footprint (in bytes) should suspend on its prefetches under `policy`.
+inline auto prefetch_should_suspend(
+    PrefetchPolicy const policy,
+    std::size_t const    footprint,
+    std::size_t const    cache_budget) -> bool
+{
+    switch (policy)
+    {
+    case PrefetchPolicy::AlwaysSuspend:
+        return true;
+    case PrefetchPolicy::NeverSuspend:
+        return false;
+    case PrefetchPolicy::SizeHeuristic:
+    default:
+        return footprint > cache_budget;
+    }
+}
+
 template <typename T, typename Scheduler>
 struct prefetch_awaitable
 {
     T*               address;
     Scheduler const& scheduler;
+    bool const       suspend;
 
-    prefetch_awaitable(T* address_, Scheduler const& scheduler_) 
-        : address{address_}, scheduler{scheduler_} {}
+    prefetch_awaitable(T* address_, Scheduler const& scheduler_, bool const suspend_) 
+        : address{address_}, scheduler{scheduler_}, suspend{suspend_} {}
 
     bool await_ready()
     {
         // no way to query the system to determine if the address is
-        // already present in cache, so just (pessimistically) assume
-        // that it is not and thus that we have to suspend + prefetch
+        // already present in cache, so rely on the caller's judgement;
+        // by default it (pessimistically) assumes that it is not and 
+        // thus that we have to suspend + prefetch
 
-        return false;
+        return !suspend;
     }
 
     auto await_suspend(stdcoro::coroutine_handle<> awaiting_coroutine)
@@ -46,12 +80,15 @@ struct prefetch_awaitable
     }
 };
 
+// Prefetch `address` and reschedule the awaiting coroutine on `scheduler`;
+// when `suspend` is false the awaiting coroutine simply continues.
 template <typename T, typename Scheduler>
 auto prefetch_and_schedule_on(
     T*               address, 
-    Scheduler const& scheduler)
+    Scheduler const& scheduler,
+    bool const       suspend = true)
 {
-    return prefetch_awaitable<T, Scheduler>{address, scheduler};
+    return prefetch_awaitable<T, Scheduler>{address, scheduler, suspend};
 }
 
 #endif // PREFETCH_HPP
\ No newline at end of file
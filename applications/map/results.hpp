@@ -0,0 +1,146 @@
+// results.hpp
+// The result types returned by operations on the map types.
+
+#ifndef RESULTS_HPP
+#define RESULTS_HPP
+
+#include <utility>
+#include <optional>
+
+// The type returned by lookup() operations.
+template <typename KeyT, typename ValueT>
+class LookupKVResult
+{
+    KeyT const* key;
+    ValueT*     value;
+
+public:
+    LookupKVResult()
+        : key{nullptr}
+        , value{nullptr} {}
+
+    LookupKVResult(KeyT const& key_, ValueT& value_)
+        : key{&key_}, value{&value_} {}
+
+    KeyT const& get_key() const
+    {
+        return *key;
+    }
+
+    ValueT& get_value() const
+    {
+        return *value;
+    }
+
+    explicit operator bool() const
+    {
+        return (key != nullptr);
+    }
+};
+
+// The type returned by lookup() operations on maps that may be
+// modified concurrently; holds copies of the key and value rather
+// than references into the map, which may be invalidated at any time.
+template <typename KeyT, typename ValueT>
+class LookupKVCopyResult
+{
+    std::optional<KeyT>   key;
+    std::optional<ValueT> value;
+
+public:
+    LookupKVCopyResult()
+        : key{}, value{} {}
+
+    LookupKVCopyResult(KeyT const& key_, ValueT const& value_)
+        : key{key_}, value{value_} {}
+
+    KeyT const& get_key() const
+    {
+        return *key;
+    }
+
+    ValueT const& get_value() const
+    {
+        return *value;
+    }
+
+    explicit operator bool() const
+    {
+        return static_cast<bool>(key);
+    }
+};
+
+// The type returned by insert() and update() operations.
+template <typename KeyT, typename ValueT>
+class InsertKVResult
+{
+    KeyT const* key;
+    ValueT*     value;
+    bool const  inserted;
+
+public:
+    InsertKVResult(
+        KeyT const& key_,
+        ValueT&     value_,
+        bool const  inserted_)
+        : key{&key_}
+        , value{&value_}
+        , inserted{inserted_} {}
+
+    KeyT const& get_key() const
+    {
+        return *key;
+    }
+
+    ValueT& get_value() const
+    {
+        return *value;
+    }
+
+    explicit operator bool() const
+    {
+        return inserted;
+    }
+};
+
+// The type returned by remove() operations.
+template <typename KeyT, typename ValueT>
+class RemoveKVResult
+{
+    std::optional<KeyT>   key;
+    std::optional<ValueT> value;
+
+public:
+    RemoveKVResult()
+        : key{}, value{} {}
+
+    RemoveKVResult(KeyT&& key_, ValueT&& value_)
+        : key{std::move(key_)}, value{std::move(value_)} {}
+
+    KeyT& get_key()
+    {
+        return *key;
+    }
+
+    ValueT& get_value()
+    {
+        return *value;
+    }
+
+    KeyT take_key()
+    {
+        return *std::move(key);
+    }
+
+    ValueT take_value()
+    {
+        return *std::move(value);
+    }
+
+    explicit operator bool()
+    {
+        return static_cast<bool>(key);
+    }
+};
+
+#endif // RESULTS_HPP
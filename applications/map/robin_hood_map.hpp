@@ -0,0 +1,914 @@
+// robin_hood_map.hpp
+// An open-addressing hashmap with bounded probe lengths.
+//
+// Collisions are resolved by linear probing with the "Robin Hood" policy
+// described by Pedro Celis in his 1986 thesis "Robin Hood Hashing": an
+// item being inserted displaces any item that sits closer to its own home
+// slot, which keeps the variance of probe lengths low. Removals shift the
+// items that follow back by one slot (rather than leaving tombstones).
+//
+// Unlike the chaining map, whose chains grow without bound once its
+// maximum capacity is reached, no item is ever placed further than
+// MAX_PROBE_LENGTH slots from its home; an insertion that would exceed the
+// bound grows the table instead. A lookup thus reads at most two cache lines
+// of the (one byte per slot) distance array, plus the slots it compares.
+// The table is followed by MAX_PROBE_LENGTH - 1 overflow slots, such that
+// a probe sequence never wraps around to the start of the table.
+
+#ifndef ROBIN_HOOD_MAP_HPP
+#define ROBIN_HOOD_MAP_HPP
+
+#include <bit>
+#include <new>
+#include <array>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <stdcoro/coroutine.hpp>
+
+#include "results.hpp"
+#include "prefetch.hpp"
+#include "throttler.hpp"
+#include "lookup_task.hpp"
+
+// ----------------------------------------------------------------------------
+// Interface
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher = std::hash<KeyT>>
+class RobinHoodMap
+{
+public:
+    // The maximum number of slots probed to locate an item in the map.
+    constexpr static std::size_t const MAX_PROBE_LENGTH = 32;
+
+private:
+    // The default initial number of (home) slots allocated to internal table.
+    constexpr static auto const DEFAULT_INIT_CAPACITY = 16ul;
+
+    // The default maximum capacity for the map.
+    constexpr static auto const DEFAULT_MAX_CAPACITY = std::numeric_limits<std::size_t>::max();
+
+    // The maximum load factor; once exceeded, a resize operation is
+    // triggered, unless the maximum capacity has already been reached.
+    constexpr static auto const MAX_LOAD_FACTOR = 0.875;
+
+    // The distance of an empty slot; a full slot stores the
+    // length of the probe sequence that locates its item.
+    constexpr static std::uint8_t const DISTANCE_EMPTY = 0;
+
+    // The size of a cache line; the distance array is aligned to it.
+    constexpr static std::size_t const CACHE_LINE_SIZE = 64;
+
+    // Multiplier used to mix the bits of the user-provided hash;
+    // the home slot is selected by the high bits of the product.
+    constexpr static auto const HASH_MULTIPLIER
+        = static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+
+    static_assert(MAX_PROBE_LENGTH <= CACHE_LINE_SIZE);
+    static_assert(MAX_PROBE_LENGTH < std::numeric_limits<std::uint8_t>::max());
+
+    struct Slot;
+
+    struct DistancesDeleter;
+    struct SlotsDeleter;
+
+    // own the arrays of a table until it is installed in the map
+    using DistancesHandle = std::unique_ptr<std::uint8_t[], DistancesDeleter>;
+    using SlotsHandle     = std::unique_ptr<Slot[], SlotsDeleter>;
+
+    // The current number of items in the map.
+    std::size_t n_items;
+
+    // The current number of home slots in the table.
+    std::size_t capacity;
+
+    // The maximum number of home slots beyond which
+    // further insertions will no longer trigger a resize.
+    std::size_t const max_capacity;
+
+    // The shift that selects the home slot from the high bits of a hash.
+    int shift;
+
+    // the array of probe distances, one per slot
+    std::uint8_t* distances;
+
+    // the array of slots that composes the table
+    Slot* slots;
+
+    // the hash functor used to hash keys
+    Hasher hasher;
+
+public:
+    using LookupKVResult = ::LookupKVResult<KeyT, ValueT>;
+    using InsertKVResult = ::InsertKVResult<KeyT, ValueT>;
+    using RemoveKVResult = ::RemoveKVResult<KeyT, ValueT>;
+
+    struct StatsResult;
+
+    using LookupResultType = LookupKVResult;
+    using InsertResultType = InsertKVResult;
+    using UpdateResultType = InsertKVResult;
+    using RemoveResultType = RemoveKVResult;
+
+    RobinHoodMap();
+
+    explicit RobinHoodMap(std::size_t const max_capacity_);
+
+    ~RobinHoodMap();
+
+    // non-copyable
+    RobinHoodMap(RobinHoodMap const&)            = delete;
+    RobinHoodMap& operator=(RobinHoodMap const&) = delete;
+
+    // non-movable
+    RobinHoodMap(RobinHoodMap&&)            = delete;
+    RobinHoodMap& operator=(RobinHoodMap&&) = delete;
+
+    // Lookup an item in the map by key.
+    auto lookup(KeyT const& key) -> LookupKVResult;
+
+    // Insert a new key / value pair into the map;
+    // does not insert if key is already present.
+    auto insert(KeyT const& key, ValueT value) -> InsertKVResult;
+
+    // Update the value associated with `key` in the map;
+    // if `key` is not present, key / value pair is inserted.
+    auto update(KeyT const& key, ValueT value) -> InsertKVResult;
+
+    // Remove a key / value pair from the map.
+    auto remove(KeyT const& key) -> RemoveKVResult;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), inserting the result
+    // of each lookup operation into the range `begin_results`.
+    // Each lookup operation is performed sequentially.
+    template <
+        typename BeginInputIter,
+        typename EndInputIter,
+        typename OutputIter>
+    auto sequential_multilookup(
+        BeginInputIter begin_keys,
+        EndInputIter   end_keys,
+        OutputIter     begin_results) -> void;
+
+    // Perform a lookup operation for each key in the
+    // range [begin_keys, end_keys), inserting the result
+    // of each lookup operation into the range `begin_results`.
+    // Lookup operations are spawned as independent coroutines
+    // such that their instruction streams may be interleaved
+    // in order to hide memory stall latency for large maps.
+    template <
+        typename BeginInputIter,
+        typename EndInputIter,
+        typename OutputIter,
+        typename Scheduler>
+    auto interleaved_multilookup(
+        BeginInputIter    begin_keys,
+        EndInputIter      end_keys,
+        OutputIter        begin_results,
+        Scheduler const&  scheduler,
+        std::size_t const n_streams) -> void;
+
+    // Query the current number of items in the map.
+    auto count() const -> std::size_t;
+
+    // Compute some instance-specific statistics and return to the caller.
+    auto stats() const -> StatsResult;
+
+private:
+    template <
+        typename Scheduler,
+        typename OnFound,
+        typename OnNotFound>
+    auto lookup_task(
+        std::allocator_arg_t,
+        Throttler<Scheduler>& throttler,
+        KeyT const            key,
+        Scheduler const&      scheduler,
+        OnFound               on_found,
+        OnNotFound            on_not_found) -> LookupKVTask<Scheduler>;
+
+    auto find_slot(KeyT const& key, std::size_t const hash) const -> Slot*;
+
+    auto fits(std::size_t const home) const -> bool;
+    auto place(std::size_t const home, Slot item) -> std::size_t;
+
+    auto insert_new(KeyT const& key, std::size_t const hash, ValueT& value) -> Slot*;
+
+    auto hash_for_key(KeyT const& key) const -> std::size_t;
+    auto home_for_hash(std::size_t const hash) const -> std::size_t;
+    auto table_length() const -> std::size_t;
+
+    auto reserve_for(std::size_t const hash) -> void;
+    auto resize_required() const -> bool;
+
+    auto grow() -> void;
+    auto try_rehash(std::size_t const new_capacity) -> bool;
+
+    static auto length_for_capacity(std::size_t const n) -> std::size_t;
+
+    static auto allocate_distances(std::size_t const n) -> std::uint8_t*;
+    static auto free_distances(std::uint8_t* dist) -> void;
+};
+
+// ----------------------------------------------------------------------------
+// Auxiliary Types (Internal)
+
+// An individual slot in the internal hashtable.
+//
+// Slots are left uninitialized until a key / value pair
+// is inserted; the distance for a slot determines
+// whether or not the slot holds a live key / value pair.
+template <typename KeyT, typename ValueT, typename Hasher>
+struct RobinHoodMap<KeyT, ValueT, Hasher>::Slot
+{
+    KeyT   key;
+    ValueT value;
+
+    Slot(KeyT const& key_, ValueT value_)
+        : key{key_}, value{std::move(value_)} {}
+};
+
+// Frees an array of distances, see RobinHoodMap::DistancesHandle.
+template <typename KeyT, typename ValueT, typename Hasher>
+struct RobinHoodMap<KeyT, ValueT, Hasher>::DistancesDeleter
+{
+    auto operator()(std::uint8_t* dist) const -> void
+    {
+        free_distances(dist);
+    }
+};
+
+// Frees an array of `length` slots, see RobinHoodMap::SlotsHandle;
+// any live slots must be destroyed (or moved from) beforehand.
+template <typename KeyT, typename ValueT, typename Hasher>
+struct RobinHoodMap<KeyT, ValueT, Hasher>::SlotsDeleter
+{
+    std::size_t length;
+
+    auto operator()(Slot* table) const -> void
+    {
+        std::allocator<Slot>{}.deallocate(table, length);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Auxiliary Types (Exported)
+
+// The type returned by RobinHoodMap::stats() operations.
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+struct RobinHoodMap<KeyT, ValueT, Hasher>::StatsResult
+{
+    // The current count of items in the map.
+    std::size_t count;
+
+    // The current capacity of the map (number of home slots).
+    std::size_t capacity;
+
+    // The maximum capacity of the map (number of home slots).
+    std::size_t max_capacity;
+
+    // The current map load factor.
+    double load_factor;
+
+    // The maximum number of slots probed to locate an item in the map.
+    std::size_t max_probe_length;
+
+    // The average number of slots probed to locate an item in the map.
+    double avg_probe_length;
+
+    // The number of items located by a probe of each length;
+    // the i-th element counts the items located after i + 1 slots.
+    std::array<std::size_t, MAX_PROBE_LENGTH> probe_length_histogram;
+};
+
+// ----------------------------------------------------------------------------
+// Exported Definitions
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+RobinHoodMap<KeyT, ValueT, Hasher>::RobinHoodMap()
+    : RobinHoodMap{DEFAULT_MAX_CAPACITY} {}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+RobinHoodMap<KeyT, ValueT, Hasher>::RobinHoodMap(
+    std::size_t const max_capacity_)
+    : n_items{0}
+    , capacity{0}
+    , max_capacity{std::max(DEFAULT_INIT_CAPACITY, std::bit_floor(max_capacity_))}
+    , shift{0}
+    , distances{nullptr}
+    , slots{nullptr}
+    , hasher{}
+{
+    if (0 == max_capacity_)
+    {
+        throw std::runtime_error{"maximum capacity must be nonzero"};
+    }
+
+    // the number of home slots is always a power of 2
+    capacity  = std::min(DEFAULT_INIT_CAPACITY, max_capacity);
+    shift     = std::numeric_limits<std::size_t>::digits - std::countr_zero(capacity);
+
+    // the destructor does not run if the constructor throws
+    auto const length = length_for_capacity(capacity);
+    auto new_distances = DistancesHandle{allocate_distances(length)};
+    auto new_slots     = SlotsHandle{std::allocator<Slot>{}.allocate(length), SlotsDeleter{length}};
+
+    distances = new_distances.release();
+    slots     = new_slots.release();
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+RobinHoodMap<KeyT, ValueT, Hasher>::~RobinHoodMap()
+{
+    auto const length = table_length();
+    if constexpr (!std::is_trivially_destructible_v<Slot>)
+    {
+        for (auto i = 0ul; i < length; ++i)
+        {
+            if (distances[i] != DISTANCE_EMPTY)
+            {
+                slots[i].~Slot();
+            }
+        }
+    }
+
+    std::allocator<Slot>{}.deallocate(slots, length);
+    free_distances(distances);
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::lookup(KeyT const& key) -> LookupKVResult
+{
+    auto* slot = find_slot(key, hash_for_key(key));
+    if (nullptr == slot)
+    {
+        // not found
+        return LookupKVResult{};
+    }
+
+    return LookupKVResult{slot->key, slot->value};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::insert(
+    KeyT const& key,
+    ValueT      value) -> InsertKVResult
+{
+    auto const hash = hash_for_key(key);
+
+    auto* slot = find_slot(key, hash);
+    if (slot != nullptr)
+    {
+        // collision; do not insert
+        return InsertKVResult{slot->key, slot->value, false};
+    }
+
+    auto* new_slot = insert_new(key, hash, value);
+    return InsertKVResult{new_slot->key, new_slot->value, true};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::update(
+    KeyT const& key,
+    ValueT      value) -> InsertKVResult
+{
+    auto const hash = hash_for_key(key);
+
+    auto* slot = find_slot(key, hash);
+    if (slot != nullptr)
+    {
+        // found a matching key; update the associated value
+        slot->value = std::move(value);
+        return InsertKVResult{slot->key, slot->value, true};
+    }
+
+    auto* new_slot = insert_new(key, hash, value);
+    return InsertKVResult{new_slot->key, new_slot->value, true};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::remove(
+    KeyT const& key) -> RemoveKVResult
+{
+    auto* slot = find_slot(key, hash_for_key(key));
+    if (nullptr == slot)
+    {
+        // key not present in the map
+        return RemoveKVResult{};
+    }
+
+    auto result = RemoveKVResult{std::move(slot->key), std::move(slot->value)};
+    slot->~Slot();
+
+    // shift each of the following items that is not in its home slot
+    // back by one; the probe sequences of the shifted items all passed
+    // through the vacated slot, so none of them is left unreachable
+    auto const length = table_length();
+
+    auto index = static_cast<std::size_t>(slot - slots);
+    for (auto next = index + 1; next < length && distances[next] > 1; ++index, ++next)
+    {
+        ::new (static_cast<void*>(slots + index)) Slot{std::move(slots[next])};
+        slots[next].~Slot();
+
+        distances[index] = static_cast<std::uint8_t>(distances[next] - 1);
+    }
+
+    distances[index] = DISTANCE_EMPTY;
+    --n_items;
+
+    return result;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename BeginInputIter,
+    typename EndInputIter,
+    typename OutputIter>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::sequential_multilookup(
+    BeginInputIter begin_keys,
+    EndInputIter   end_keys,
+    OutputIter     begin_results) -> void
+{
+    for (auto iter = begin_keys; iter != end_keys; ++iter)
+    {
+        *begin_results = lookup(*iter);
+        ++begin_results;
+    }
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename BeginInputIter,
+    typename EndInputIter,
+    typename OutputIter,
+    typename Scheduler>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::interleaved_multilookup(
+    BeginInputIter    begin_keys,
+    EndInputIter      end_keys,
+    OutputIter        begin_results,
+    Scheduler const&  scheduler,
+    std::size_t const n_streams) -> void
+{
+    // instantiate a throttler for this multilookup
+    Throttler throttler{scheduler, n_streams};
+
+    for (auto key_iter = begin_keys; key_iter != end_keys; ++key_iter)
+    {
+        throttler.spawn(
+            lookup_task(
+                std::allocator_arg,
+                throttler,
+                *key_iter,
+                scheduler,
+                [&begin_results](KeyT const& k, ValueT& v) mutable {
+                    *begin_results = LookupKVResult{k, v};
+                    ++begin_results;
+                },
+                [&begin_results]() mutable {
+                    *begin_results = LookupKVResult{};
+                    ++begin_results;
+                }));
+    }
+
+    // run until all lookup tasks complete
+    throttler.run();
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::count() const -> std::size_t
+{
+    return n_items;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::stats() const -> StatsResult
+{
+    StatsResult results{};
+
+    results.count        = n_items;
+    results.capacity     = capacity;
+    results.max_capacity = max_capacity;
+
+    results.load_factor
+        = static_cast<double>(n_items) / static_cast<double>(capacity);
+
+    // the distance of each item is the length of the probe that locates it
+    std::size_t max_length = 0;
+    std::size_t sum_length = 0;
+
+    auto const length = table_length();
+    for (auto i = 0ul; i < length; ++i)
+    {
+        std::size_t const distance = distances[i];
+        if (DISTANCE_EMPTY == distance)
+        {
+            continue;
+        }
+
+        ++results.probe_length_histogram[distance - 1];
+        max_length = std::max(distance, max_length);
+        sum_length += distance;
+    }
+
+    results.max_probe_length = max_length;
+    results.avg_probe_length = (0 == n_items)
+        ? 0.0
+        : static_cast<double>(sum_length) / static_cast<double>(n_items);
+
+    return results;
+}
+
+// ----------------------------------------------------------------------------
+// Internal Definitions
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+template <
+    typename Scheduler,
+    typename OnFound,
+    typename OnNotFound>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::lookup_task(
+    std::allocator_arg_t,
+    Throttler<Scheduler>&,
+    KeyT const            key,
+    Scheduler const&      scheduler,
+    OnFound               on_found,
+    OnNotFound            on_not_found) -> LookupKVTask<Scheduler>
+{
+    auto const home = home_for_hash(hash_for_key(key));
+
+    auto* dist = co_await prefetch_and_schedule_on(distances + home, scheduler);
+    for (std::size_t probe = 1; probe <= MAX_PROBE_LENGTH; ++probe, ++dist)
+    {
+        if (probe > 1 && 0 == reinterpret_cast<std::uintptr_t>(dist) % CACHE_LINE_SIZE)
+        {
+            // the probe sequence crosses into the next line of distances
+            dist = co_await prefetch_and_schedule_on(dist, scheduler);
+        }
+
+        if (*dist < probe)
+        {
+            // an empty slot, or an item closer to its home
+            // than the key would be, ends the probe sequence
+            break;
+        }
+
+        if (*dist == probe)
+        {
+            auto* slot = co_await prefetch_and_schedule_on(
+                slots + home + probe - 1, scheduler);
+            if (key == slot->key)
+            {
+                co_return on_found(slot->key, slot->value);
+            }
+        }
+    }
+
+    // not found
+    co_return on_not_found();
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::find_slot(
+    KeyT const&       key,
+    std::size_t const hash) const -> Slot*
+{
+    auto index = home_for_hash(hash);
+    for (std::size_t probe = 1; probe <= MAX_PROBE_LENGTH; ++probe, ++index)
+    {
+        if (distances[index] < probe)
+        {
+            // an empty slot, or an item closer to its home
+            // than the key would be, ends the probe sequence
+            return nullptr;
+        }
+
+        if (distances[index] == probe && key == slots[index].key)
+        {
+            return slots + index;
+        }
+    }
+
+    // probed every slot within the bound
+    return nullptr;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::fits(
+    std::size_t const home) const -> bool
+{
+    // replay the displacements of place() without moving any item;
+    // they depend only upon the distances of the items in the way
+    auto index    = home;
+    auto distance = 1ul;
+    for (; distance <= MAX_PROBE_LENGTH; ++index, ++distance)
+    {
+        if (DISTANCE_EMPTY == distances[index])
+        {
+            return true;
+        }
+
+        if (distances[index] < distance)
+        {
+            // the displaced item continues the probe in our place
+            distance = distances[index];
+        }
+    }
+
+    return false;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::place(
+    std::size_t const home,
+    Slot              item) -> std::size_t
+{
+    // the index at which `item` itself comes to rest;
+    // the items that it displaces do not move it again
+    auto placed = std::numeric_limits<std::size_t>::max();
+
+    auto index    = home;
+    auto distance = std::uint8_t{1};
+    for (;; ++index, ++distance)
+    {
+        if (DISTANCE_EMPTY == distances[index])
+        {
+            ::new (static_cast<void*>(slots + index)) Slot{std::move(item)};
+            distances[index] = distance;
+            return std::min(placed, index);
+        }
+
+        if (distances[index] < distance)
+        {
+            // take the slot of the item closer to its home
+            std::swap(item, slots[index]);
+            std::swap(distance, distances[index]);
+            placed = std::min(placed, index);
+        }
+    }
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::insert_new(
+    KeyT const&       key,
+    std::size_t const hash,
+    ValueT&           value) -> Slot*
+{
+    // NOTE: a resize moves all items in the table, so it must
+    // occur before we hand out a reference to the new item
+    reserve_for(hash);
+
+    auto const index = place(home_for_hash(hash), Slot{key, std::move(value)});
+    ++n_items;
+
+    return slots + index;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::hash_for_key(KeyT const& key) const -> std::size_t
+{
+    return hasher(key) * HASH_MULTIPLIER;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::home_for_hash(std::size_t const hash) const -> std::size_t
+{
+    // NOTE: we rely on the fact that the number of home
+    // slots in the internal table is always a power of 2
+    return hash >> shift;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::table_length() const -> std::size_t
+{
+    return length_for_capacity(capacity);
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::reserve_for(std::size_t const hash) -> void
+{
+    for (;;)
+    {
+        auto const fit = fits(home_for_hash(hash));
+        if (fit && !resize_required()) [[likely]]
+        {
+            return;
+        }
+
+        if ((capacity << 1) > max_capacity)
+        {
+            if (fit)
+            {
+                // at maximum capacity; fill the table within the bound
+                return;
+            }
+
+            throw std::runtime_error{"maximum capacity exceeded"};
+        }
+
+        grow();
+    }
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::resize_required() const -> bool
+{
+    return (static_cast<double>(n_items + 1)
+        / static_cast<double>(capacity)) > MAX_LOAD_FACTOR;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::grow() -> void
+{
+    // double the size of the table on resize; the items are (rarely)
+    // clustered such that the bound is exceeded even after doubling
+    for (auto new_capacity = capacity << 1; new_capacity <= max_capacity; new_capacity <<= 1)
+    {
+        if (try_rehash(new_capacity))
+        {
+            return;
+        }
+    }
+
+    throw std::runtime_error{"maximum capacity exceeded"};
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::try_rehash(std::size_t const new_capacity) -> bool
+{
+    auto const old_length = table_length();
+    auto const new_length = length_for_capacity(new_capacity);
+    auto const new_shift  = std::numeric_limits<std::size_t>::digits - std::countr_zero(new_capacity);
+
+    // the placement of each item is computed before any item is moved,
+    // such that the table is left intact if any item exceeds the bound
+    // (or if any allocation fails, as the new arrays are owned until
+    // they are installed)
+    auto new_distances = DistancesHandle{allocate_distances(new_length)};
+    std::vector<std::size_t> origins(new_length);
+
+    for (auto i = 0ul; i < old_length; ++i)
+    {
+        if (DISTANCE_EMPTY == distances[i])
+        {
+            continue;
+        }
+
+        auto index    = hash_for_key(slots[i].key) >> new_shift;
+        auto distance = std::uint8_t{1};
+        auto origin   = i;
+        for (; new_distances[index] != DISTANCE_EMPTY; ++index, ++distance)
+        {
+            if (new_distances[index] < distance)
+            {
+                std::swap(distance, new_distances[index]);
+                std::swap(origin, origins[index]);
+            }
+
+            if (distance == MAX_PROBE_LENGTH)
+            {
+                return false;
+            }
+        }
+
+        new_distances[index] = distance;
+        origins[index]       = origin;
+    }
+
+    auto new_slots = SlotsHandle{std::allocator<Slot>{}.allocate(new_length), SlotsDeleter{new_length}};
+    for (auto i = 0ul; i < new_length; ++i)
+    {
+        if (new_distances[i] != DISTANCE_EMPTY)
+        {
+            auto& old_slot = slots[origins[i]];
+            ::new (static_cast<void*>(&new_slots[i])) Slot{std::move(old_slot)};
+            old_slot.~Slot();
+        }
+    }
+
+    std::allocator<Slot>{}.deallocate(slots, old_length);
+    free_distances(distances);
+
+    distances = new_distances.release();
+    slots     = new_slots.release();
+    capacity  = new_capacity;
+    shift     = new_shift;
+
+    return true;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::length_for_capacity(std::size_t const n) -> std::size_t
+{
+    // an item in the last home slot may be displaced into the overflow slots
+    return n + MAX_PROBE_LENGTH - 1;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::allocate_distances(std::size_t const n) -> std::uint8_t*
+{
+    // aligned such that a probe spans at most two cache lines of distances
+    auto* dist = static_cast<std::uint8_t*>(
+        ::operator new(n, std::align_val_t{CACHE_LINE_SIZE}));
+    std::memset(dist, DISTANCE_EMPTY, n);
+    return dist;
+}
+
+template <
+    typename KeyT,
+    typename ValueT,
+    typename Hasher>
+auto RobinHoodMap<KeyT, ValueT, Hasher>::free_distances(std::uint8_t* dist) -> void
+{
+    ::operator delete(dist, std::align_val_t{CACHE_LINE_SIZE});
+}
+
+#endif // ROBIN_HOOD_MAP_HPP
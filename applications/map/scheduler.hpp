@@ -9,6 +9,10 @@
 template <std::size_t QueueDepth>
 class StaticQueueScheduler
 {    
+    // one slot is sacrificed (see max_tasks()), and
+    // a scheduler must admit at least one task in flight
+    static_assert(QueueDepth >= 2, "a scheduler queue must hold at least two slots");
+
     using CoroHandle = std::coroutine_handle<>;
 
     mutable std::size_t head;
@@ -20,6 +24,15 @@ public:
     StaticQueueScheduler()
         : head{0}, tail{0} {}
 
+    // the maximum number of coroutines that may be scheduled at once;
+    // one slot of the buffer is sacrificed to tell a full queue from
+    // an empty one, so a throttler must keep fewer than QueueDepth
+    // tasks in flight on this scheduler
+    constexpr static auto max_tasks() -> std::size_t
+    {
+        return QueueDepth - 1;
+    }
+
     // schedule a coroutine for later resumption
     void schedule(CoroHandle handle) const
     {
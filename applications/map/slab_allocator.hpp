@@ -0,0 +1,173 @@
+// slab_allocator.hpp
+// Fixed-size object allocators for map entries.
+//
+// Both allocators expose the same minimal interface:
+//
+//  - T* allocate()          returns uninitialized storage for one T
+//  - void deallocate(T* p)  returns the storage for one (destroyed) T
+//
+// along with the RELEASES_ON_DESTRUCTION flag that reports whether
+// destroying the allocator reclaims all of the storage it handed out,
+// in which case the owning container may skip walking its entries.
+
+#ifndef SLAB_ALLOCATOR_HPP
+#define SLAB_ALLOCATOR_HPP
+
+#include <new>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#include "huge_pages.hpp"
+
+// An allocator that carves objects from large chunks, recycles freed
+// objects through an intrusive free list, and releases all chunks at once.
+template <typename T>
+class SlabAllocator
+{
+    // The approximate size of each chunk requested from the system.
+    constexpr static std::size_t const CHUNK_SIZE = 1 << 20;
+
+    // The storage for an individual object; a free object
+    // reuses its own storage as the link in the free list.
+    union Node
+    {
+        Node* next;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    // The number of objects carved from each chunk.
+    constexpr static std::size_t const OBJECTS_PER_CHUNK
+        = std::max(static_cast<std::size_t>(1), CHUNK_SIZE / sizeof(Node));
+
+    // The number of objects carved from each chunk backed by huge pages;
+    // each such chunk is a single huge page, unless an object exceeds it.
+    constexpr static std::size_t const OBJECTS_PER_HUGE_CHUNK
+        = std::max(static_cast<std::size_t>(1), HUGE_PAGE_SIZE / sizeof(Node));
+
+    // the head of the intrusive list of freed objects
+    Node* free_list;
+
+    // the next unused object in the current chunk
+    Node* cursor;
+
+    // one past the last object in the current chunk
+    Node* limit;
+
+    // all of the chunks allocated by this instance
+    std::vector<Node*> chunks;
+
+    // the size of the pages that back each chunk
+    PageSize const page_size;
+
+    // the number of objects carved from each chunk
+    std::size_t const objects_per_chunk;
+
+public:
+    constexpr static bool const RELEASES_ON_DESTRUCTION = true;
+
+    SlabAllocator()
+        : SlabAllocator{PageSize::Base} {}
+
+    explicit SlabAllocator(PageSize const page_size_)
+        : free_list{nullptr}
+        , cursor{nullptr}
+        , limit{nullptr}
+        , chunks{}
+        , page_size{page_size_}
+        , objects_per_chunk{(PageSize::Huge == page_size_) ? OBJECTS_PER_HUGE_CHUNK : OBJECTS_PER_CHUNK} {}
+
+    ~SlabAllocator()
+    {
+        for (auto* chunk : chunks)
+        {
+            if (PageSize::Huge == page_size)
+            {
+                free_huge_pages(chunk, objects_per_chunk * sizeof(Node));
+            }
+            else
+            {
+                delete[] chunk;
+            }
+        }
+    }
+
+    // non-copyable
+    SlabAllocator(SlabAllocator const&)            = delete;
+    SlabAllocator& operator=(SlabAllocator const&) = delete;
+
+    // non-movable
+    SlabAllocator(SlabAllocator&&)            = delete;
+    SlabAllocator& operator=(SlabAllocator&&) = delete;
+
+    T* allocate()
+    {
+        if (free_list != nullptr)
+        {
+            auto* node = free_list;
+            free_list = node->next;
+            return reinterpret_cast<T*>(node->storage);
+        }
+
+        if (cursor == limit)
+        {
+            // current chunk is exhausted; carve from a new one, making
+            // room to record it first such that recording it cannot throw
+            chunks.push_back(nullptr);
+
+            Node* chunk = nullptr;
+            try
+            {
+                chunk = (PageSize::Huge == page_size)
+                    ? static_cast<Node*>(allocate_huge_pages(objects_per_chunk * sizeof(Node)))
+                    : new Node[objects_per_chunk];
+            }
+            catch (...)
+            {
+                chunks.pop_back();
+                throw;
+            }
+
+            chunks.back() = chunk;
+
+            cursor = chunk;
+            limit  = chunk + objects_per_chunk;
+        }
+
+        auto* node = cursor++;
+        return reinterpret_cast<T*>(node->storage);
+    }
+
+    void deallocate(T* ptr)
+    {
+        auto* node = reinterpret_cast<Node*>(ptr);
+        node->next = free_list;
+        free_list  = node;
+    }
+
+    // The total number of bytes requested from the system.
+    std::size_t footprint() const
+    {
+        return chunks.size() * objects_per_chunk * sizeof(Node);
+    }
+};
+
+// An allocator that requests each object individually from the global heap.
+template <typename T>
+class HeapAllocator
+{
+public:
+    constexpr static bool const RELEASES_ON_DESTRUCTION = false;
+
+    T* allocate()
+    {
+        return static_cast<T*>(::operator new(sizeof(T)));
+    }
+
+    void deallocate(T* ptr)
+    {
+        ::operator delete(ptr, sizeof(T));
+    }
+};
+
+#endif // SLAB_ALLOCATOR_HPP
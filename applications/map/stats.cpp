@@ -5,6 +5,8 @@
 #include <iostream>
 
 #include "map.hpp"
+#include "flat_map.hpp"
+#include "robin_hood_map.hpp"
 
 // the maximum number of buckets allocated by the map
 constexpr static std::size_t const MAP_MAX_CAPACITY = 1 << 16;
@@ -43,11 +45,82 @@ static void perform_inserts_and_dump_stats(std::size_t const n_items)
         << std::flush;
 }
 
+static void perform_flat_inserts_and_dump_stats(std::size_t const n_items)
+{
+    // open addressing cannot exceed one item per slot,
+    // so the flat map is not constrained to MAP_MAX_CAPACITY
+    FlatMap<int, int> map{};
+
+    for (auto i = 0ul; i < n_items; ++i)
+    {
+        auto const kv = static_cast<int>(i);
+        map.insert(kv, kv);
+    }
+
+    auto stats = map.stats();
+
+    // the total number of bytes consumed by the table;
+    // each slot holds a key / value pair, along with one control byte,
+    // and is allocated regardless of whether or not it is occupied
+    auto const total_table_bytes 
+        = stats.capacity * ((sizeof(int)*2) + sizeof(std::int8_t));
+    auto const as_mb = total_table_bytes / static_cast<std::size_t>(1 << 20);
+
+    std::cout << "[+] flat map statistics:\n"
+        << "\titem count:           " << stats.count << '\n'
+        << "\tcapacity:             " << stats.capacity << '\n'
+        << "\tload factor:          " << stats.load_factor << '\n'
+        << "\tmax probe length:     " << stats.max_probe_length << '\n'
+        << "\tavg probe length:     " << stats.avg_probe_length << '\n'
+        << "\ttable footprint:      " << as_mb << " MB\n"
+        << std::flush;
+}
+
+static void perform_robin_hood_inserts_and_dump_stats(std::size_t const n_items)
+{
+    // the probe length of each item is bounded, so the robin hood
+    // map (like the flat map) grows instead of lengthening its probes
+    RobinHoodMap<int, int> map{};
+
+    for (auto i = 0ul; i < n_items; ++i)
+    {
+        auto const kv = static_cast<int>(i);
+        map.insert(kv, kv);
+    }
+
+    auto stats = map.stats();
+
+    // the total number of bytes consumed by the table;
+    // each slot holds a key / value pair, along with one distance byte,
+    // and is allocated regardless of whether or not it is occupied
+    auto const total_table_bytes 
+        = stats.capacity * ((sizeof(int)*2) + sizeof(std::uint8_t));
+    auto const as_mb = total_table_bytes / static_cast<std::size_t>(1 << 20);
+
+    std::cout << "[+] robin hood map statistics:\n"
+        << "\titem count:           " << stats.count << '\n'
+        << "\tcapacity:             " << stats.capacity << '\n'
+        << "\tload factor:          " << stats.load_factor << '\n'
+        << "\tmax probe length:     " << stats.max_probe_length << '\n'
+        << "\tavg probe length:     " << stats.avg_probe_length << '\n'
+        << "\ttable footprint:      " << as_mb << " MB\n"
+        << "\tprobe length histogram:\n";
+
+    for (auto i = 0ul; i < stats.max_probe_length; ++i)
+    {
+        std::cout << "\t\t" << (i + 1) << ": " << stats.probe_length_histogram[i] << '\n';
+    }
+
+    std::cout << std::flush;
+}
+
 int main()
 {
     for (auto i = MIN_N_ITEMS; i <= MAX_N_ITEMS; i <<= 1)
     {
         perform_inserts_and_dump_stats(i);
+        perform_flat_inserts_and_dump_stats(i);
+        perform_robin_hood_inserts_and_dump_stats(i);
     }
 
     return EXIT_SUCCESS;
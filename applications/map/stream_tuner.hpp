@@ -0,0 +1,100 @@
+// stream_tuner.hpp
+// Runtime selection of the number of interleaved instruction streams.
+
+#ifndef STREAM_TUNER_HPP
+#define STREAM_TUNER_HPP
+
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+// The StreamTuner hill-climbs the number of concurrent instruction
+// streams for interleaved operations: after each epoch of operations
+// it compares the cost per operation with that of the previous epoch,
+// and keeps stepping in the same direction while the cost improves.
+class StreamTuner
+{
+public:
+    // the stream count used before any measurements are taken
+    constexpr static std::size_t const INITIAL_N_STREAMS = 8;
+
+    // the relative increase in cost per operation tolerated as noise
+    // before the tuner concludes that a step made things worse
+    constexpr static double const NOISE_TOLERANCE = 0.02;
+
+private:
+    // the stream count selected for the next epoch
+    std::size_t n_streams;
+
+    // the direction of the next step, +1 or -1
+    int direction;
+
+    // the cost per operation (ns) observed in the previous epoch;
+    // zero until the first epoch has been recorded
+    double last_cost;
+
+public:
+    StreamTuner()
+        : n_streams{INITIAL_N_STREAMS}
+        , direction{1}
+        , last_cost{0.0} {}
+
+    // non-copyable
+    StreamTuner(StreamTuner const&)            = delete;
+    StreamTuner& operator=(StreamTuner const&) = delete;
+
+    // non-movable
+    StreamTuner(StreamTuner&&)            = delete;
+    StreamTuner& operator=(StreamTuner&&) = delete;
+
+    // Record that `n_ops` operations took `elapsed` with the current
+    // stream count, and select the stream count for the next epoch
+    // from the range [1, max_streams].
+    auto record(
+        std::size_t const              n_ops,
+        std::chrono::nanoseconds const elapsed,
+        std::size_t const              max_streams) -> std::size_t;
+
+    // Return the stream count selected for the next epoch,
+    // limited to at most `max_streams`.
+    auto get_n_streams(std::size_t const max_streams) const -> std::size_t
+    {
+        return std::clamp(n_streams, std::size_t{1}, max_streams);
+    }
+};
+
+inline auto StreamTuner::record(
+    std::size_t const              n_ops,
+    std::chrono::nanoseconds const elapsed,
+    std::size_t const              max_streams) -> std::size_t
+{
+    if (0 == n_ops)
+    {
+        return get_n_streams(max_streams);
+    }
+
+    auto const cost = static_cast<double>(elapsed.count())
+        / static_cast<double>(n_ops);
+
+    // the last step made things worse, so turn around
+    if (last_cost > 0.0 && cost > last_cost * (1.0 + NOISE_TOLERANCE))
+    {
+        direction = -direction;
+    }
+
+    last_cost = cost;
+
+    // turn around at either end of the admissible range
+    auto const current = get_n_streams(max_streams);
+    if ((direction < 0 && current == 1) || (direction > 0 && current == max_streams))
+    {
+        direction = -direction;
+    }
+
+    n_streams = (direction > 0) ? current + 1 : current - 1;
+    n_streams = get_n_streams(max_streams);
+
+    return n_streams;
+}
+
+#endif // STREAM_TUNER_HPP
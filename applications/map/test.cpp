@@ -3,9 +3,35 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
 
+#include <array>
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+#include <random>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include <libcoro/recycling_allocator.hpp>
+#include <libbench/key_distributions.hpp>
 
 #include "map.hpp"
+#include "flat_map.hpp"
+#include "robin_hood_map.hpp"
+#include "concurrent_map.hpp"
+#include "scheduler.hpp"
+#include "slab_allocator.hpp"
+#include "frame_arena.hpp"
+#include "bloom_filter.hpp"
+#include "stream_tuner.hpp"
+#include "inline_string.hpp"
 
 TEST_CASE("map supports construction")
 {
@@ -126,4 +152,1887 @@ TEST_CASE("map correctly handles resize operations")
         auto const r = map.lookup(i);
         REQUIRE(static_cast<bool>(r));
     }
-}
\ No newline at end of file
+
+    REQUIRE(map.stats().resizes > 0);
+}
+
+TEST_CASE("map correctly handles incremental resize operations")
+{
+    Map<int, int> map{std::numeric_limits<std::size_t>::max(), ResizeMode::Incremental};
+    StaticQueueScheduler<16> scheduler{};
+
+    // each insertion below observes the table mid-migration at some point
+    for (auto i = 0; i < 4096; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.insert(i, i)));
+        REQUIRE(static_cast<bool>(map.lookup(i / 2)));
+        REQUIRE_FALSE(static_cast<bool>(map.insert(i / 2, 0)));
+    }
+
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        REQUIRE(static_cast<bool>(map.update(i, -i)));
+        REQUIRE(static_cast<bool>(map.remove(i + 1)));
+    }
+
+    REQUIRE(map.count() == 2048);
+    REQUIRE(map.stats().count == 2048);
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 4096; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<Map<int, int>::LookupKVResult> results{};
+    map.interleaved_multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), scheduler, 8);
+
+    REQUIRE(results.size() == keys.size());
+    for (auto const& r : results)
+    {
+        if (r)
+        {
+            REQUIRE(r.get_key() % 2 == 0);
+            REQUIRE(r.get_value() == -r.get_key());
+        }
+    }
+
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }) == 2048);
+}
+
+TEST_CASE("map supports batched multilookup")
+{
+    auto const mode = GENERATE(ResizeMode::Immediate, ResizeMode::Incremental);
+
+    Map<int, int> map{std::numeric_limits<std::size_t>::max(), mode};
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        map.insert(i, -i);
+    }
+
+    // keys in descending order, such that input order opposes bucket order
+    std::vector<int> keys{};
+    for (auto i = 4095; i >= 0; --i)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<Map<int, int>::LookupKVResult> results(keys.size());
+    map.batched_multilookup(keys.begin(), keys.end(), results.begin());
+
+    // results are produced in input order
+    for (auto i = 0ul; i < keys.size(); ++i)
+    {
+        auto const& r = results[i];
+        REQUIRE(static_cast<bool>(r) == (0 == keys[i] % 2));
+        if (r)
+        {
+            REQUIRE(r.get_key() == keys[i]);
+            REQUIRE(r.get_value() == -keys[i]);
+        }
+    }
+
+    std::vector<int> empty{};
+    map.batched_multilookup(empty.begin(), empty.end(), results.begin());
+}
+
+TEST_CASE("map supports interleaved insertion, update, and removal")
+{
+    using InsertResultType = typename Map<int, int>::InsertResultType;
+    using RemoveResultType = typename Map<int, int>::RemoveResultType;
+
+    Map<int, int> map{};
+    StaticQueueScheduler<32> scheduler{};
+
+    std::vector<std::pair<int, int>> items{};
+    for (auto i = 0; i < 4096; ++i)
+    {
+        items.emplace_back(i, i);
+    }
+
+    std::vector<InsertResultType> inserted{};
+    map.interleaved_multiinsert(
+        items.begin(), 
+        items.end(), 
+        std::back_inserter(inserted), 
+        scheduler, 8);
+
+    REQUIRE(inserted.size() == items.size());
+    REQUIRE(map.count() == items.size());
+
+    REQUIRE(map.stats().load_factor <= 0.5);
+
+    for (auto& r : inserted)
+    {
+        REQUIRE(static_cast<bool>(r));
+        REQUIRE(r.get_key() == r.get_value());
+    }
+
+    for (auto& item : items)
+    {
+        item.second = -item.first;
+    }
+
+    std::vector<InsertResultType> updated{};
+    map.interleaved_multiupdate(
+        items.begin(), 
+        items.end(), 
+        std::back_inserter(updated), 
+        scheduler, 8);
+
+    REQUIRE(updated.size() == items.size());
+    REQUIRE(map.count() == items.size());
+    REQUIRE(map.lookup(42).get_value() == -42);
+
+    // remove each even key twice; only the first removal succeeds
+    std::vector<int> keys{};
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        keys.push_back(i);
+        keys.push_back(i);
+    }
+
+    std::vector<RemoveResultType> removed{};
+    map.interleaved_multiremove(
+        keys.begin(), 
+        keys.end(), 
+        std::back_inserter(removed), 
+        scheduler, 8);
+
+    REQUIRE(removed.size() == keys.size());
+
+    auto const n_removed = std::count_if(
+        removed.begin(), removed.end(), [](auto& r) { return static_cast<bool>(r); });
+    REQUIRE(n_removed == 2048);
+    REQUIRE(map.count() == 2048);
+
+    for (auto i = 0; i < 4096; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.lookup(i)) == (i % 2 == 1));
+    }
+}
+
+// A hash function that places every key in the same bucket
+// (for any realistic capacity) while keeping the hashes distinct.
+struct SingleBucketHasher
+{
+    std::size_t operator()(int const key) const
+    {
+        return static_cast<std::size_t>(key) << 40;
+    }
+};
+
+TEST_CASE("map resolves lookups within a shared bucket chain")
+{
+    Map<int, int, SingleBucketHasher> map{};
+    StaticQueueScheduler<16> scheduler{};
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.insert(i, i)));
+    }
+
+    REQUIRE(map.stats().max_bucket_depth == 4);
+
+    // removing each head of the chain in turn promotes its successor
+    for (auto i = 0; i < 3; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.remove(i)));
+        REQUIRE_FALSE(static_cast<bool>(map.lookup(i)));
+        REQUIRE_FALSE(static_cast<bool>(map.remove(i)));
+    }
+
+    auto result = map.lookup(3);
+    REQUIRE(static_cast<bool>(result));
+    REQUIRE(result.get_value() == 3);
+
+    std::vector<int> keys{0, 1, 2, 3};
+    std::vector<Map<int, int, SingleBucketHasher>::LookupKVResult> results{};
+
+    map.interleaved_multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), scheduler, 2);
+
+    REQUIRE(results.size() == keys.size());
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }) == 1);
+}
+
+TEST_CASE("map supports adaptive interleaved multilookup")
+{
+    // a small capacity yields long chains, such that each lookup 
+    // suspends many times before it completes
+    Map<int, int> map{64};
+    StaticQueueScheduler<16> scheduler{};
+
+    for (auto i = 0; i < 8192; i += 2)
+    {
+        map.insert(i, -i);
+    }
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 8192; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    // successive calls resume from the previously tuned stream count
+    for (auto round = 0; round < 2; ++round)
+    {
+        std::vector<Map<int, int>::LookupKVResult> results{};
+        map.adaptive_interleaved_multilookup(
+            keys.begin(), keys.end(), std::back_inserter(results), scheduler);
+
+        REQUIRE(results.size() == keys.size());
+        for (auto const& r : results)
+        {
+            if (r)
+            {
+                REQUIRE(r.get_key() % 2 == 0);
+                REQUIRE(r.get_value() == -r.get_key());
+            }
+        }
+
+        REQUIRE(std::count_if(results.begin(), results.end(), 
+            [](auto const& r) { return static_cast<bool>(r); }) == 4096);
+
+        auto const n_streams = map.tuned_n_streams<StaticQueueScheduler<16>>();
+        REQUIRE(n_streams >= 1);
+        REQUIRE(n_streams <= StaticQueueScheduler<16>::max_tasks());
+    }
+}
+
+// Await an asynchronous multilookup for each of `keys`, then set `done`.
+static auto await_multilookup(
+    Map<int, int>&                               map,
+    std::vector<int> const&                      keys,
+    std::vector<Map<int, int>::LookupKVResult>&  results,
+    StaticQueueScheduler<16> const&              scheduler,
+    bool&                                        done) -> coro::task<void>
+{
+    co_await map.async_multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), scheduler, 8);
+
+    done = true;
+}
+
+// Yield to the scheduler until `done` is set, counting each resumption.
+static auto count_until_done(
+    StaticQueueScheduler<16> const& scheduler,
+    bool const&                     done,
+    std::size_t&                    n_resumed) -> coro::task<void>
+{
+    while (!done)
+    {
+        ++n_resumed;
+        co_await prefetch_and_schedule_on(&n_resumed, scheduler);
+    }
+}
+
+TEST_CASE("map supports asynchronous multilookup")
+{
+    Map<int, int> map{64};
+    map.set_prefetch_policy(PrefetchPolicy::AlwaysSuspend);
+
+    StaticQueueScheduler<16> scheduler{};
+
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        map.insert(i, -i);
+    }
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 4096; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<Map<int, int>::LookupKVResult> results{};
+    auto done      = false;
+    auto n_resumed = std::size_t{0};
+
+    // both tasks are lazy; neither runs until it is resumed
+    auto lookups = await_multilookup(map, keys, results, scheduler, done);
+    auto counter = count_until_done(scheduler, done, n_resumed);
+    REQUIRE(results.empty());
+
+    lookups.resume();
+    counter.resume();
+    scheduler.run();
+
+    REQUIRE(lookups.is_ready());
+    REQUIRE(counter.is_ready());
+    REQUIRE(done);
+
+    REQUIRE(results.size() == keys.size());
+    for (auto const& r : results)
+    {
+        if (r)
+        {
+            REQUIRE(r.get_key() % 2 == 0);
+            REQUIRE(r.get_value() == -r.get_key());
+        }
+    }
+
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }) == 2048);
+
+    // the unrelated coroutine ran while the lookups were in flight
+    REQUIRE(n_resumed > 1);
+}
+
+TEST_CASE("map supports each prefetch policy in interleaved operations")
+{
+    using InsertResultType = typename Map<int, int>::InsertResultType;
+
+    auto const policy = GENERATE(
+        PrefetchPolicy::AlwaysSuspend, 
+        PrefetchPolicy::NeverSuspend, 
+        PrefetchPolicy::SizeHeuristic);
+
+    Map<int, int> map{};
+    StaticQueueScheduler<16> scheduler{};
+
+    // a small budget such that the heuristic switches to suspending 
+    // part way through the insertions below
+    map.set_prefetch_policy(policy, 1ul << 14);
+
+    std::vector<std::pair<int, int>> items{};
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        items.emplace_back(i, -i);
+    }
+
+    std::vector<InsertResultType> inserted{};
+    map.interleaved_multiinsert(
+        items.begin(), items.end(), std::back_inserter(inserted), scheduler, 8);
+
+    REQUIRE(map.count() == items.size());
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 4096; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<Map<int, int>::LookupKVResult> results{};
+    map.interleaved_multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), scheduler, 8);
+
+    REQUIRE(results.size() == keys.size());
+    for (auto const& r : results)
+    {
+        if (r)
+        {
+            REQUIRE(r.get_key() % 2 == 0);
+            REQUIRE(r.get_value() == -r.get_key());
+        }
+    }
+
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }) == 2048);
+}
+
+TEST_CASE("map supports multilookup by each means of interleaving")
+{
+    auto const interleaving = GENERATE(
+        Interleaving::Sequential, 
+        Interleaving::Coroutine, 
+        Interleaving::Amac);
+
+    auto const policy = GENERATE(
+        PrefetchPolicy::AlwaysSuspend, 
+        PrefetchPolicy::NeverSuspend);
+
+    auto const filtered = GENERATE(false, true);
+
+    // a small table, such that chains are several entries long
+    Map<int, int> map{64};
+    StaticQueueScheduler<16> scheduler{};
+
+    map.set_prefetch_policy(policy);
+    map.set_lookup_filter(filtered);
+
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        map.insert(i, -i);
+    }
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 4096; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<Map<int, int>::LookupKVResult> results{};
+    map.multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), interleaving, scheduler, 8);
+
+    REQUIRE(results.size() == keys.size());
+    for (auto const& r : results)
+    {
+        if (r)
+        {
+            REQUIRE(r.get_key() % 2 == 0);
+            REQUIRE(r.get_value() == -r.get_key());
+        }
+    }
+
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }) == 2048);
+}
+
+TEST_CASE("map consults a lookup filter on every path of a multilookup")
+{
+    auto const interleaving = GENERATE(
+        Interleaving::Coroutine, 
+        Interleaving::Amac);
+
+    // a table whose bucket array is large enough to be staged, such that
+    // the filter is fetched together with the bucket of each lookup
+    constexpr auto const n_keys = 1 << 18;
+
+    Map<int, int> map{};
+    StaticQueueScheduler<16> scheduler{};
+
+    map.set_prefetch_policy(PrefetchPolicy::AlwaysSuspend);
+    map.set_lookup_filter(true);
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < n_keys; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            map.insert(i, -i);
+        }
+
+        keys.push_back(i);
+    }
+
+    auto const check = [](auto const& results) {
+        REQUIRE(results.size() == static_cast<std::size_t>(n_keys));
+        for (auto const& r : results)
+        {
+            if (r)
+            {
+                REQUIRE(r.get_key() % 2 == 0);
+                REQUIRE(r.get_value() == -r.get_key());
+            }
+        }
+
+        REQUIRE(std::count_if(results.begin(), results.end(), 
+            [](auto const& r) { return static_cast<bool>(r); }) == n_keys / 2);
+    };
+
+    std::vector<Map<int, int>::LookupKVResult> results{};
+    map.multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), interleaving, scheduler, 8);
+    check(results);
+
+    std::vector<Map<int, int>::LookupKVResult> batched(keys.size());
+    map.batched_multilookup(keys.begin(), keys.end(), batched.begin());
+    check(batched);
+
+    for (auto i = 0; i < n_keys; ++i)
+    {
+        REQUIRE(static_cast<bool>(batched[static_cast<std::size_t>(i)]) == (i % 2 == 0));
+    }
+}
+
+TEST_CASE("prefetch policy decides whether to suspend")
+{
+    REQUIRE(prefetch_should_suspend(PrefetchPolicy::AlwaysSuspend, 0, 1024));
+    REQUIRE_FALSE(prefetch_should_suspend(PrefetchPolicy::NeverSuspend, 1ul << 30, 1024));
+    REQUIRE_FALSE(prefetch_should_suspend(PrefetchPolicy::SizeHeuristic, 1024, 1024));
+    REQUIRE(prefetch_should_suspend(PrefetchPolicy::SizeHeuristic, 1025, 1024));
+}
+
+TEST_CASE("stream tuner climbs while the cost improves and turns around otherwise")
+{
+    using namespace std::chrono_literals;
+
+    StreamTuner tuner{};
+    auto const initial = tuner.get_n_streams(32);
+
+    // improving cost keeps the tuner climbing
+    REQUIRE(tuner.record(100, 1000ns, 32) == initial + 1);
+    REQUIRE(tuner.record(100,  900ns, 32) == initial + 2);
+
+    // a worse cost reverses the direction of the climb
+    REQUIRE(tuner.record(100, 1800ns, 32) == initial + 1);
+    REQUIRE(tuner.record(100, 1700ns, 32) == initial);
+
+    // the stream count is confined to the admissible range
+    REQUIRE(tuner.get_n_streams(4) == 4);
+    REQUIRE(tuner.record(100, 1700ns, 4) == 3);
+    REQUIRE(tuner.get_n_streams(1) == 1);
+}
+
+#if defined(MAPPED_FILE_SUPPORTED)
+// A path in the temporary directory that is unique to this run of the 
+// tests, such that concurrent runs do not overwrite each other's files.
+static auto temp_path(std::string const& name) -> std::string
+{
+    static auto const run_id = std::random_device{}();
+    static std::atomic<unsigned> n_paths{0};
+
+    auto const unique = name + "." + std::to_string(run_id) + "." + std::to_string(n_paths++);
+    return (std::filesystem::temp_directory_path() / unique).string();
+}
+
+TEST_CASE("map supports snapshots served from a mapped file")
+{
+    auto const path = temp_path("map_snapshot_test.bin");
+
+    {
+        Map<int, int> map{};
+        for (auto i = 0; i < 4096; i += 2)
+        {
+            map.insert(i, -i);
+        }
+
+        map.save(path);
+    }
+
+    StaticQueueScheduler<16> scheduler{};
+
+    {
+        auto map = Map<int, int>::load_mapped(path);
+        REQUIRE(map.count() == 2048);
+        REQUIRE(map.stats().count == 2048);
+
+        for (auto i = 0; i < 4096; ++i)
+        {
+            auto const result = map.lookup(i);
+            REQUIRE(static_cast<bool>(result) == (i % 2 == 0));
+            if (result)
+            {
+                REQUIRE(result.get_value() == -i);
+            }
+        }
+
+        std::vector<int> keys{};
+        for (auto i = 0; i < 4096; ++i)
+        {
+            keys.push_back(i);
+        }
+
+        std::vector<Map<int, int>::LookupKVResult> results{};
+        map.interleaved_multilookup(
+            keys.begin(), keys.end(), std::back_inserter(results), scheduler, 8);
+
+        REQUIRE(std::count_if(results.begin(), results.end(), 
+            [](auto const& r) { return static_cast<bool>(r); }) == 2048);
+
+        // existing keys are updated in the (private) mapping; 
+        // neither these nor a failed insert change its structure
+        REQUIRE(static_cast<bool>(map.update(0, 1)));
+        REQUIRE_FALSE(static_cast<bool>(map.insert(2, 0)));
+        REQUIRE_FALSE(static_cast<bool>(map.remove(1)));
+        REQUIRE(map.lookup(0).get_value() == 1);
+
+        // mutations copy the snapshot into an ordinary table
+        REQUIRE(static_cast<bool>(map.insert(1, 1)));
+        REQUIRE(static_cast<bool>(map.remove(2)));
+        REQUIRE(map.count() == 2048);
+        REQUIRE(map.lookup(0).get_value() == 1);
+        REQUIRE(map.lookup(1).get_value() == 1);
+        REQUIRE_FALSE(static_cast<bool>(map.lookup(2)));
+
+        for (auto i = 4096; i < 8192; ++i)
+        {
+            map.insert(i, -i);
+        }
+
+        REQUIRE(map.count() == 6144);
+        REQUIRE(map.lookup(4094).get_value() == -4094);
+    }
+
+    {
+        // the file itself is never modified through the mapping
+        auto map = Map<int, int>::load_mapped(path);
+        REQUIRE(map.lookup(0).get_value() == 0);
+        REQUIRE(map.lookup(2).get_value() == -2);
+        REQUIRE_FALSE(static_cast<bool>(map.lookup(1)));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("map load throws on an invalid snapshot")
+{
+    auto const path = temp_path("map_snapshot_invalid.bin");
+
+    {
+        Map<int, int> map{};
+        map.insert(1, 1);
+        map.save(path);
+    }
+
+    // a snapshot of a map with different types
+    REQUIRE_THROWS(Map<long, long>::load_mapped(path));
+
+    std::filesystem::resize_file(path, 16);
+    REQUIRE_THROWS(Map<int, int>::load_mapped(path));
+
+    // a snapshot whose bucket offsets point beyond its entries
+    {
+        Map<int, int> map{};
+        for (auto i = 0; i < 64; ++i)
+        {
+            map.insert(i, i);
+        }
+
+        map.save(path);
+    }
+
+    {
+        // the offsets immediately follow the 64-byte header
+        std::fstream file{path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(64 + sizeof(std::uint32_t));
+
+        std::uint32_t const corrupt = 0x7fffffff;
+        for (auto i = 0; i < 4; ++i)
+        {
+            file.write(reinterpret_cast<char const*>(&corrupt), sizeof(corrupt));
+        }
+    }
+
+    REQUIRE_THROWS_WITH((Map<int, int>::load_mapped(path)), "snapshot bucket offsets are corrupt");
+
+    std::remove(path.c_str());
+}
+#endif
+
+TEST_CASE("map supports string keys with heterogeneous lookup")
+{
+    Map<std::string, int, StringHash> map{};
+    StaticQueueScheduler<16> scheduler{};
+
+    // long enough that the characters do not fit in the small-string buffer
+    auto const make_key = [](int const i) {
+        return "a rather long key, number " + std::to_string(i);
+    };
+
+    // each insertion below survives several resizes of the table
+    for (auto i = 0; i < 4096; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.insert(make_key(i), i)));
+    }
+
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        REQUIRE(static_cast<bool>(map.remove(make_key(i))));
+    }
+
+    REQUIRE(map.count() == 2048);
+
+    std::vector<std::string> strings{};
+    for (auto i = 0; i < 4096; ++i)
+    {
+        strings.push_back(make_key(i));
+    }
+
+    for (auto i = 0; i < 4096; ++i)
+    {
+        auto const result = map.lookup(std::string_view{strings[static_cast<std::size_t>(i)]});
+        REQUIRE(static_cast<bool>(result) == (i % 2 == 1));
+        if (result)
+        {
+            REQUIRE(result.get_value() == i);
+        }
+    }
+
+    // the keys are looked up through views, without constructing strings
+    std::vector<std::string_view> views(strings.begin(), strings.end());
+
+    std::vector<Map<std::string, int, StringHash>::LookupKVResult> results{};
+    map.interleaved_multilookup(
+        views.begin(), views.end(), std::back_inserter(results), scheduler, 8);
+
+    REQUIRE(results.size() == views.size());
+    for (auto const& r : results)
+    {
+        if (r)
+        {
+            REQUIRE(r.get_key() == make_key(r.get_value()));
+        }
+    }
+
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }) == 2048);
+}
+
+TEST_CASE("map supports inline string keys")
+{
+    using Key = InlineString<23>;
+    
+    REQUIRE_THROWS_AS(Key{"a key that exceeds the inline capacity"}, std::length_error);
+
+    Map<Key, int> map{};
+    for (auto i = 0; i < 1024; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.insert(Key{"key " + std::to_string(i)}, i)));
+    }
+
+    REQUIRE(map.lookup(std::string_view{"key 7"}).get_value() == 7);
+    REQUIRE(map.lookup(Key{"key 1023"}).get_value() == 1023);
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(std::string_view{"key 1024"})));
+
+#if defined(MAPPED_FILE_SUPPORTED)
+    auto const path = temp_path("map_inline_string_test.bin");
+    map.save(path);
+    
+    auto loaded = Map<Key, int>::load_mapped(path);
+    REQUIRE(loaded.count() == 1024);
+    REQUIRE(loaded.lookup(std::string_view{"key 512"}).get_value() == 512);
+
+    std::remove(path.c_str());
+#endif
+}
+
+TEST_CASE("map removes entries from the middle of a bucket chain")
+{
+    Map<int, int, SingleBucketHasher> map{};
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.insert(i, i)));
+    }
+
+    // neither the head nor the tail of the chain
+    REQUIRE(static_cast<bool>(map.remove(2)));
+    REQUIRE(static_cast<bool>(map.remove(1)));
+
+    REQUIRE(map.count() == 2);
+    REQUIRE(map.lookup(0).get_value() == 0);
+    REQUIRE(map.lookup(3).get_value() == 3);
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(1)));
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(2)));
+}
+
+TEST_CASE("map supports iteration and parallel scans")
+{
+    auto const resize_mode = GENERATE(ResizeMode::Immediate, ResizeMode::Incremental);
+
+    Map<int, int> map{std::numeric_limits<std::size_t>::max(), resize_mode};
+    REQUIRE(map.begin() == map.end());
+    REQUIRE(map.reduce(4, 0, [](int acc, int, int) { return acc + 1; }, std::plus<int>{}) == 0);
+
+    // an odd count leaves an incremental resize in progress
+    constexpr auto const n_items = 3001;
+    for (auto i = 0; i < n_items; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    // every item is visited exactly once by each form of scan
+    auto const require_each_once = [](std::vector<int> keys) {
+        std::sort(keys.begin(), keys.end());
+        REQUIRE(keys.size() == static_cast<std::size_t>(n_items));
+        for (auto i = 0; i < n_items; ++i)
+        {
+            REQUIRE(keys[static_cast<std::size_t>(i)] == i);
+        }
+    };
+
+    std::vector<int> iterated{};
+    for (auto [key, value] : map)
+    {
+        REQUIRE(key == value);
+        iterated.push_back(key);
+    }
+    require_each_once(iterated);
+
+    std::vector<int> scanned{};
+    for (auto [key, value] : map.scan())
+    {
+        REQUIRE(key == value);
+        scanned.push_back(key);
+    }
+    require_each_once(scanned);
+
+    // values are updated in place through each form of scan
+    for (auto [key, value] : map)
+    {
+        value = key + 1;
+    }
+
+    // assertions are not thread-safe, so mismatches are counted instead
+    std::atomic_size_t n_visited{0};
+    std::atomic_size_t n_mismatched{0};
+    map.for_each_parallel(4, [&](int const& key, int& value) {
+        if (value != key + 1)
+        {
+            n_mismatched.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        value = -key;
+        n_visited.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    REQUIRE(n_visited.load() == static_cast<std::size_t>(n_items));
+    REQUIRE(n_mismatched.load() == 0);
+    REQUIRE(map.lookup(n_items - 1).get_value() == -(n_items - 1));
+
+    auto const sum = map.reduce(3, 0l, 
+        [](long acc, int const& key, int const& value) { return acc + key + value; }, 
+        std::plus<long>{});
+    REQUIRE(sum == 0);
+
+    auto const max_key = map.reduce(8, 0, 
+        [](int acc, int const& key, int const&) { return std::max(acc, key); },
+        [](int a, int b) { return std::max(a, b); });
+    REQUIRE(max_key == n_items - 1);
+
+    // exceptions thrown on any thread propagate to the caller
+    REQUIRE_THROWS_AS(map.for_each_parallel(4, [](int const& key, int&) {
+        if (key == n_items / 2)
+        {
+            throw std::runtime_error{"scan failed"};
+        }
+    }), std::runtime_error);
+}
+
+#if defined(MAPPED_FILE_SUPPORTED)
+TEST_CASE("map supports iteration of a mapped snapshot")
+{
+    auto const path = temp_path("map_snapshot_scan.bin");
+
+    {
+        Map<int, int> map{};
+        for (auto i = 0; i < 1000; ++i)
+        {
+            map.insert(i, 2 * i);
+        }
+
+        map.save(path);
+    }
+
+    auto map = Map<int, int>::load_mapped(path);
+
+    auto n_iterated = 0;
+    for (auto [key, value] : map)
+    {
+        REQUIRE(value == 2 * key);
+        ++n_iterated;
+    }
+    REQUIRE(n_iterated == 1000);
+
+    auto n_scanned = 0;
+    for (auto [key, value] : map.scan())
+    {
+        REQUIRE(value == 2 * key);
+        ++n_scanned;
+    }
+    REQUIRE(n_scanned == 1000);
+
+    map.for_each_parallel(4, [](int const&, int& value) { value += 1; });
+
+    auto const sum = map.reduce(4, 0l, 
+        [](long acc, int const&, int const& value) { return acc + value; }, 
+        std::plus<long>{});
+    REQUIRE(sum == 999 * 1000 + 1000);
+
+    std::remove(path.c_str());
+}
+#endif
+
+TEST_CASE("map consults a lookup filter for absent keys")
+{
+    Map<int, int> map{};
+    map.set_lookup_filter(true);
+
+    StaticQueueScheduler<16> scheduler{};
+
+    // the filter grows with the map, and never rejects a present key
+    for (auto i = 0; i < 8192; i += 2)
+    {
+        REQUIRE(static_cast<bool>(map.insert(i, i)));
+    }
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 8192; ++i)
+    {
+        keys.push_back(i);
+        REQUIRE(static_cast<bool>(map.lookup(i)) == (i % 2 == 0));
+    }
+
+    std::vector<Map<int, int>::LookupKVResult> results{};
+    map.set_prefetch_policy(PrefetchPolicy::AlwaysSuspend);
+    map.interleaved_multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), scheduler, 8);
+
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }) == 4096);
+
+    // removals leave stale keys in the filter until it is rebuilt
+    for (auto i = 0; i < 8192; i += 4)
+    {
+        REQUIRE(static_cast<bool>(map.remove(i)));
+    }
+
+    for (auto i = 1; i < 8192; i += 4)
+    {
+        REQUIRE(static_cast<bool>(map.update(i, -i)));
+    }
+
+    REQUIRE(map.count() == 4096);
+    for (auto i = 0; i < 8192; ++i)
+    {
+        auto const present = (i % 4 == 1) || (i % 4 == 2);
+        REQUIRE(static_cast<bool>(map.lookup(i)) == present);
+    }
+
+    map.set_lookup_filter(false);
+    REQUIRE(map.lookup(1).get_value() == -1);
+    REQUIRE(map.lookup(2).get_value() == 2);
+}
+
+TEST_CASE("map evicts unreferenced items beyond its item budget")
+{
+    auto const interleaved = GENERATE(false, true);
+    auto const resize_mode = GENERATE(ResizeMode::Immediate, ResizeMode::Incremental);
+
+    Map<int, int> map{std::numeric_limits<std::size_t>::max(), resize_mode};
+    map.set_prefetch_policy(PrefetchPolicy::AlwaysSuspend);
+
+    REQUIRE_THROWS_AS(map.set_item_budget(0), std::runtime_error);
+
+    map.set_item_budget(64);
+    for (auto i = 0; i < 64; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    REQUIRE(map.count() == 64);
+    REQUIRE(map.stats().evictions == 0);
+
+    // find the first half of the items, such that they are referenced
+    std::vector<int> hot{};
+    for (auto i = 0; i < 32; ++i)
+    {
+        hot.push_back(i);
+    }
+
+    std::vector<Map<int, int>::LookupKVResult> results{};
+    if (interleaved)
+    {
+        StaticQueueScheduler<16> scheduler{};
+        map.interleaved_multilookup(
+            hot.begin(), hot.end(), std::back_inserter(results), scheduler, 8);
+    }
+    else
+    {
+        map.sequential_multilookup(hot.begin(), hot.end(), std::back_inserter(results));
+    }
+
+    REQUIRE(std::all_of(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }));
+
+    // each insertion beyond the budget evicts an unreferenced item
+    for (auto i = 64; i < 96; ++i)
+    {
+        REQUIRE(map.insert(i, i).get_value() == i);
+    }
+
+    auto const stats = map.stats();
+    REQUIRE(stats.count == 64);
+    REQUIRE(stats.item_budget == 64);
+    REQUIRE(stats.evictions == 32);
+    REQUIRE(stats.hits == 32);
+    REQUIRE(stats.misses == 0);
+
+    for (auto i = 0; i < 96; ++i)
+    {
+        auto const cold = (i >= 32 && i < 64);
+        REQUIRE(static_cast<bool>(map.lookup(i)) == !cold);
+    }
+
+    REQUIRE(map.stats().misses == 32);
+
+    // lowering the budget evicts immediately
+    map.set_item_budget(16);
+    REQUIRE(map.count() == 16);
+    REQUIRE(map.stats().evictions == 80);
+
+    auto n_present = 0ul;
+    for (auto [key, value] : map)
+    {
+        REQUIRE(key == value);
+        ++n_present;
+    }
+
+    REQUIRE(n_present == 16);
+}
+
+TEST_CASE("blocked bloom filter has no false negatives and few false positives")
+{
+    BlockedBloomFilter filter{};
+    REQUIRE_FALSE(filter.enabled());
+
+    constexpr auto const n_keys = 1ul << 16;
+    filter.reset(n_keys);
+
+    auto const hash = std::hash<std::size_t>{};
+    for (auto i = 0ul; i < n_keys; ++i)
+    {
+        filter.insert(hash(i));
+    }
+
+    REQUIRE_FALSE(filter.rebuild_required());
+
+    auto n_false_positives = 0ul;
+    for (auto i = 0ul; i < n_keys; ++i)
+    {
+        REQUIRE(filter.may_contain(hash(i)));
+        n_false_positives += filter.may_contain(hash(n_keys + i)) ? 1ul : 0ul;
+    }
+
+    REQUIRE(n_false_positives < n_keys / 100);
+
+    // once half of the keys are stale the filter should be rebuilt
+    for (auto i = 0ul; i <= n_keys / 2; ++i)
+    {
+        filter.remove();
+    }
+
+    REQUIRE(filter.rebuild_required());
+}
+
+TEST_CASE("map supports alternative entry allocators")
+{
+    Map<int, int, std::hash<int>, HeapAllocator> map{};
+
+    for (auto i = 0; i < 64; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.insert(i, i)));
+    }
+
+    for (auto i = 0; i < 64; i += 2)
+    {
+        REQUIRE(static_cast<bool>(map.remove(i)));
+    }
+
+    REQUIRE(map.count() == 32);
+    REQUIRE(static_cast<bool>(map.lookup(1)));
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(2)));
+}
+
+TEST_CASE("slab allocator recycles freed objects")
+{
+    SlabAllocator<std::pair<int, int>> allocator{};
+
+    auto* a = allocator.allocate();
+    auto* b = allocator.allocate();
+    REQUIRE(a != b);
+
+    auto const footprint = allocator.footprint();
+    REQUIRE(footprint > 0);
+
+    allocator.deallocate(a);
+    REQUIRE(allocator.allocate() == a);
+
+    // no additional chunk is required to satisfy these requests
+    REQUIRE(allocator.footprint() == footprint);
+}
+
+TEST_CASE("recycling allocator recycles frames by size class")
+{
+    using coro::recycling_allocator;
+
+    recycling_allocator::trim();
+    auto const before = recycling_allocator::stats();
+
+    auto* a = recycling_allocator::allocate(100);
+    auto* b = recycling_allocator::allocate(300);
+    REQUIRE(a != b);
+
+    recycling_allocator::deallocate(a, 100);
+    recycling_allocator::deallocate(b, 300);
+
+    // a frame is only recycled for a request of the same size class
+    REQUIRE(recycling_allocator::allocate(90) == a);
+    REQUIRE(recycling_allocator::allocate(280) == b);
+
+    auto const after = recycling_allocator::stats();
+    REQUIRE(after.n_allocs - before.n_allocs == 4);
+    REQUIRE(after.n_recycled - before.n_recycled == 2);
+
+    recycling_allocator::deallocate(a, 90);
+    recycling_allocator::deallocate(b, 280);
+
+    // frames too large to be cached are returned to the system
+    auto* large = recycling_allocator::allocate(1ul << 16);
+    recycling_allocator::deallocate(large, 1ul << 16);
+    REQUIRE(recycling_allocator::stats().cached_bytes == after.cached_bytes + 64 * 2 + 64 * 5);
+
+    recycling_allocator::trim();
+    REQUIRE(recycling_allocator::stats().cached_bytes == 0);
+}
+
+TEST_CASE("recycling allocator trims its cache beyond the high-water mark")
+{
+    using coro::recycling_allocator;
+
+    recycling_allocator::trim();
+    auto const before = recycling_allocator::stats();
+
+    // twice as many bytes as a thread may cache
+    std::vector<void*> frames{};
+    for (auto i = 0; i < 2048; ++i)
+    {
+        frames.push_back(recycling_allocator::allocate(1000));
+    }
+
+    for (auto* frame : frames)
+    {
+        recycling_allocator::deallocate(frame, 1000);
+    }
+
+    auto const after = recycling_allocator::stats();
+    REQUIRE(after.cached_bytes > 0);
+    REQUIRE(after.cached_bytes <= (1ul << 20));
+    REQUIRE(after.n_trimmed > before.n_trimmed);
+
+    recycling_allocator::trim();
+}
+
+TEST_CASE("recycling allocator returns frames freed on another thread")
+{
+    using coro::recycling_allocator;
+
+    constexpr static auto const N_FRAMES = 64ul;
+
+    recycling_allocator::trim();
+    auto const before = recycling_allocator::stats();
+
+    std::vector<void*> frames{};
+    for (auto i = 0ul; i < N_FRAMES; ++i)
+    {
+        frames.push_back(recycling_allocator::allocate(200));
+    }
+
+    std::thread{[&frames]() {
+        for (auto* frame : frames)
+        {
+            recycling_allocator::deallocate(frame, 200);
+        }
+    }}.join();
+
+    // the frames are handed back to this thread, and recycled by it
+    std::vector<void*> recycled{};
+    for (auto i = 0ul; i < N_FRAMES; ++i)
+    {
+        recycled.push_back(recycling_allocator::allocate(200));
+    }
+
+    auto const after = recycling_allocator::stats();
+    REQUIRE(after.n_remote_frees - before.n_remote_frees == N_FRAMES);
+    REQUIRE(after.n_recycled - before.n_recycled == N_FRAMES);
+
+    std::sort(frames.begin(), frames.end());
+    std::sort(recycled.begin(), recycled.end());
+    REQUIRE(frames == recycled);
+
+    // frames may also outlive the thread that allocated them
+    std::vector<void*> orphaned{};
+    std::thread{[&orphaned]() {
+        for (auto i = 0ul; i < N_FRAMES; ++i)
+        {
+            orphaned.push_back(recycling_allocator::allocate(200));
+        }
+    }}.join();
+
+    for (auto* frame : orphaned)
+    {
+        recycling_allocator::deallocate(frame, 200);
+    }
+
+    for (auto* frame : recycled)
+    {
+        recycling_allocator::deallocate(frame, 200);
+    }
+
+    recycling_allocator::trim();
+}
+
+// Frees its frame upon destruction, on the thread that destroys it.
+struct frame_holder
+{
+    void* frame = nullptr;
+
+    ~frame_holder()
+    {
+        coro::recycling_allocator::deallocate(frame, 200);
+    }
+};
+
+TEST_CASE("recycling allocator accepts frames freed after the thread cache")
+{
+    using coro::recycling_allocator;
+
+    std::thread{[]() {
+        // constructed before the cache of this thread, and so destroyed
+        // after it; the frame is then handed back to the orphaned inbox
+        thread_local frame_holder holder{};
+        holder.frame = recycling_allocator::allocate(200);
+    }}.join();
+
+    // the next thread to start adopts the inbox, and recycles the frame
+    std::size_t n_recycled = 0;
+    std::thread{[&n_recycled]() {
+        auto* frame = recycling_allocator::allocate(200);
+        n_recycled = recycling_allocator::stats().n_recycled;
+
+        recycling_allocator::deallocate(frame, 200);
+    }}.join();
+
+    REQUIRE(n_recycled == 1);
+}
+
+// Allocates (and frees) a frame upon destruction, recording its success.
+struct frame_user
+{
+    bool* allocated = nullptr;
+
+    ~frame_user()
+    {
+        auto* frame = coro::recycling_allocator::allocate(200);
+        *allocated = (frame != nullptr);
+        coro::recycling_allocator::deallocate(frame, 200);
+    }
+};
+
+TEST_CASE("recycling allocator allocates frames after the thread cache")
+{
+    using coro::recycling_allocator;
+
+    auto allocated = false;
+    std::thread{[&allocated]() {
+        // constructed before the cache of this thread, and so destroyed
+        // after it; the frame is then allocated from the system
+        thread_local frame_user user{};
+        user.allocated = &allocated;
+        recycling_allocator::deallocate(recycling_allocator::allocate(200), 200);
+    }}.join();
+
+    REQUIRE(allocated);
+}
+
+TEST_CASE("frame arena recycles its slots and falls back once exhausted")
+{
+    FrameArena arena{2};
+
+    auto* a = arena.allocate(100);
+    auto* b = arena.allocate(100);
+    REQUIRE(a != b);
+    REQUIRE(arena.get_n_fallbacks() == 0);
+
+    // the most recently freed slot is the next to be reused
+    FrameArena::deallocate(a, 100);
+    REQUIRE(arena.allocate(100) == a);
+
+    // the arena is exhausted, and frames larger than a slot never fit
+    auto* c = arena.allocate(100);
+    auto* d = arena.allocate(1000);
+    FrameArena::deallocate(b, 100);
+    auto* e = arena.allocate(1000);
+    REQUIRE(arena.get_n_fallbacks() == 3);
+
+    FrameArena::deallocate(a, 100);
+    FrameArena::deallocate(c, 100);
+    FrameArena::deallocate(d, 1000);
+    FrameArena::deallocate(e, 1000);
+}
+
+TEST_CASE("map allocates lookup frames from the frame arena of the throttler")
+{
+    using coro::recycling_allocator;
+
+    Map<int, int> map{64};
+    map.set_prefetch_policy(PrefetchPolicy::AlwaysSuspend);
+
+    StaticQueueScheduler<16> scheduler{};
+
+    for (auto i = 0; i < 1024; i += 2)
+    {
+        map.insert(i, -i);
+    }
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 1024; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    auto const before = recycling_allocator::stats();
+
+    std::vector<Map<int, int>::LookupKVResult> results{};
+    map.interleaved_multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), scheduler, 8);
+    map.adaptive_interleaved_multilookup(
+        keys.begin(), keys.end(), std::back_inserter(results), scheduler);
+
+    REQUIRE(results.size() == 2 * keys.size());
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r); }) == 1024);
+
+    // no lookup frame went to the global allocator
+    REQUIRE(recycling_allocator::stats().n_allocs == before.n_allocs);
+}
+
+TEST_CASE("map supports tables and entries backed by huge pages")
+{
+    auto const resize_mode = GENERATE(ResizeMode::Immediate, ResizeMode::Incremental);
+
+    Map<int, int> map{std::numeric_limits<std::size_t>::max(), resize_mode, PageSize::Huge};
+
+    // enough items that the bucket array outgrows a single huge page
+    constexpr auto const n_items = 1 << 18;
+    for (auto i = 0; i < n_items; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.insert(i, i)));
+    }
+
+    REQUIRE(map.stats().capacity * 16 > HUGE_PAGE_SIZE);
+
+    for (auto i = 0; i < n_items; i += 2)
+    {
+        REQUIRE(static_cast<bool>(map.remove(i)));
+    }
+
+    REQUIRE(map.count() == n_items / 2);
+    for (auto i = 0; i < n_items; ++i)
+    {
+        auto const result = map.lookup(i);
+        REQUIRE(static_cast<bool>(result) == (i % 2 == 1));
+    }
+
+    // an allocator that cannot use huge pages ignores the page size
+    Map<int, int, std::hash<int>, HeapAllocator> heap_map{64, ResizeMode::Immediate, PageSize::Huge};
+    REQUIRE(static_cast<bool>(heap_map.insert(1, 1)));
+    REQUIRE(heap_map.lookup(1).get_value() == 1);
+}
+
+TEST_CASE("slab allocator carves chunks from huge pages")
+{
+    SlabAllocator<std::pair<int, int>> allocator{PageSize::Huge};
+
+    auto* a = allocator.allocate();
+    REQUIRE(reinterpret_cast<std::uintptr_t>(a) % HUGE_PAGE_SIZE == 0);
+    REQUIRE(allocator.footprint() == HUGE_PAGE_SIZE);
+
+    // the memory is writable and recycled as with base pages
+    *a = std::make_pair(1, 2);
+    allocator.deallocate(a);
+    REQUIRE(allocator.allocate() == a);
+}
+
+TEST_CASE("flat map supports construction")
+{
+    SECTION("default construction")
+    {
+        FlatMap<int, int> map{};
+        REQUIRE(map.count() == 0);
+
+        auto stats = map.stats();
+        REQUIRE(stats.capacity == 16);
+    }
+
+    SECTION("construction with explicit maximum capacity")
+    {
+        FlatMap<int, int> map{64};
+        REQUIRE(map.count() == 0);
+
+        auto stats = map.stats();
+        REQUIRE(stats.max_capacity == 64);
+    }
+}
+
+TEST_CASE("flat map construction throws on invalid maximum capacity")
+{
+    std::unique_ptr<FlatMap<int, int>> ptr{};
+    REQUIRE_THROWS_AS(ptr.reset(new FlatMap<int, int>{0}), std::runtime_error);
+}
+
+TEST_CASE("flat map supports insertion, lookup, update, and removal")
+{
+    FlatMap<int, int> map{};
+
+    auto r1 = map.insert(1, 1);
+    REQUIRE(static_cast<bool>(r1));
+    REQUIRE(map.count() == 1);
+
+    auto r2 = map.insert(1, 2);
+    REQUIRE_FALSE(static_cast<bool>(r2));
+    REQUIRE(r2.get_value() == 1);
+
+    auto r3 = map.lookup(1);
+    REQUIRE(static_cast<bool>(r3));
+    REQUIRE(r3.get_key() == 1);
+    REQUIRE(r3.get_value() == 1);
+
+    auto r4 = map.update(1, 2);
+    REQUIRE(static_cast<bool>(r4));
+    REQUIRE(r4.get_value() == 2);
+    REQUIRE(map.count() == 1);
+
+    auto r5 = map.remove(1);
+    REQUIRE(static_cast<bool>(r5));
+    REQUIRE(r5.take_key() == 1);
+    REQUIRE(r5.take_value() == 2);
+    REQUIRE(map.count() == 0);
+
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(1)));
+    REQUIRE_FALSE(static_cast<bool>(map.remove(1)));
+}
+
+TEST_CASE("flat map correctly handles resize operations")
+{
+    FlatMap<int, int> map{};
+
+    for (auto i = 0; i < 10000; ++i)
+    {
+        auto const r = map.insert(i, i);
+        REQUIRE(static_cast<bool>(r));
+    }
+
+    REQUIRE(map.count() == 10000);
+    REQUIRE(map.stats().load_factor <= 0.875);
+
+    for (auto i = 0; i < 10000; ++i)
+    {
+        auto const r = map.lookup(i);
+        REQUIRE(static_cast<bool>(r));
+        REQUIRE(r.get_value() == i);
+    }
+}
+
+TEST_CASE("flat map remains consistent under interleaved insertion and removal")
+{
+    FlatMap<int, int> map{};
+
+    for (auto i = 0; i < 4096; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        REQUIRE(static_cast<bool>(map.remove(i)));
+    }
+
+    REQUIRE(map.count() == 2048);
+
+    for (auto i = 0; i < 4096; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.lookup(i)) == (i % 2 == 1));
+    }
+
+    // reinsert into the slots vacated by removals
+    for (auto i = 0; i < 4096; i += 2)
+    {
+        REQUIRE(static_cast<bool>(map.insert(i, -i)));
+    }
+
+    REQUIRE(map.count() == 4096);
+    REQUIRE(map.lookup(8).get_value() == -8);
+}
+
+TEST_CASE("flat map throws when maximum capacity is exhausted")
+{
+    FlatMap<int, int> map{16};
+
+    for (auto i = 0; i < 16; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    REQUIRE(map.count() == 16);
+    REQUIRE_THROWS_AS(map.insert(16, 16), std::runtime_error);
+
+    for (auto i = 0; i < 16; ++i)
+    {
+        REQUIRE(static_cast<bool>(map.lookup(i)));
+    }
+
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(16)));
+}
+
+TEST_CASE("flat map supports interleaved multilookup")
+{
+    using ResultType = typename FlatMap<int, int>::LookupResultType;
+
+    FlatMap<int, int> map{};
+    StaticQueueScheduler<32> scheduler{};
+
+    for (auto i = 0; i < 1024; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 2048; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<ResultType> results{};
+    map.interleaved_multilookup(
+        keys.begin(),
+        keys.end(),
+        std::back_inserter(results),
+        scheduler, 8);
+
+    REQUIRE(results.size() == keys.size());
+
+    std::size_t n_found = 0;
+    for (auto& r : results)
+    {
+        if (r)
+        {
+            REQUIRE(r.get_key() == r.get_value());
+            ++n_found;
+        }
+    }
+
+    REQUIRE(n_found == 1024);
+}
+
+TEST_CASE("robin hood map supports insertion, lookup, update, and removal")
+{
+    RobinHoodMap<int, int> map{};
+    REQUIRE(map.stats().capacity == 16);
+
+    auto r1 = map.insert(1, 1);
+    REQUIRE(static_cast<bool>(r1));
+    REQUIRE(map.count() == 1);
+
+    auto r2 = map.insert(1, 2);
+    REQUIRE_FALSE(static_cast<bool>(r2));
+    REQUIRE(r2.get_value() == 1);
+
+    auto r3 = map.update(1, 2);
+    REQUIRE(static_cast<bool>(r3));
+    REQUIRE(map.lookup(1).get_value() == 2);
+
+    auto r4 = map.remove(1);
+    REQUIRE(static_cast<bool>(r4));
+    REQUIRE(r4.take_value() == 2);
+    REQUIRE(map.count() == 0);
+
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(1)));
+    REQUIRE_FALSE(static_cast<bool>(map.remove(1)));
+
+    std::unique_ptr<RobinHoodMap<int, int>> ptr{};
+    REQUIRE_THROWS_AS(ptr.reset(new RobinHoodMap<int, int>{0}), std::runtime_error);
+}
+
+TEST_CASE("robin hood map bounds the probe length of every item")
+{
+    using MapType = RobinHoodMap<int, int>;
+
+    MapType map{};
+
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> dist{};
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 100000; ++i)
+    {
+        auto const key = dist(gen);
+        if (map.insert(key, -key))
+        {
+            keys.push_back(key);
+        }
+    }
+
+    // remove every other item; the items that follow each
+    // removed item shift back toward their home slots
+    for (auto i = 0ul; i < keys.size(); i += 2)
+    {
+        REQUIRE(static_cast<bool>(map.remove(keys[i])));
+    }
+
+    for (auto i = 0ul; i < keys.size(); ++i)
+    {
+        auto const r = map.lookup(keys[i]);
+        REQUIRE(static_cast<bool>(r) == (i % 2 == 1));
+    }
+
+    auto const stats = map.stats();
+    REQUIRE(stats.count == keys.size() / 2);
+    REQUIRE(stats.load_factor <= 0.875);
+    REQUIRE(stats.max_probe_length <= MapType::MAX_PROBE_LENGTH);
+    REQUIRE(stats.avg_probe_length >= 1.0);
+
+    // the histogram accounts for every item in the map
+    auto const& histogram = stats.probe_length_histogram;
+    REQUIRE(std::accumulate(histogram.begin(), histogram.end(), 0ul) == stats.count);
+    REQUIRE(histogram[stats.max_probe_length - 1] > 0);
+}
+
+// A hasher under which every key collides.
+struct ConstantHasher
+{
+    std::size_t operator()(int const) const
+    {
+        return 0;
+    }
+};
+
+TEST_CASE("robin hood map throws once the probe bound cannot be kept")
+{
+    using MapType = RobinHoodMap<int, int, ConstantHasher>;
+
+    MapType map{64};
+
+    for (auto i = 0; i < static_cast<int>(MapType::MAX_PROBE_LENGTH); ++i)
+    {
+        REQUIRE(static_cast<bool>(map.insert(i, i)));
+    }
+
+    // the table is grown to its maximum capacity before giving up
+    REQUIRE_THROWS_AS(map.insert(-1, -1), std::runtime_error);
+    REQUIRE(map.stats().capacity == 64);
+    REQUIRE(map.stats().max_probe_length == MapType::MAX_PROBE_LENGTH);
+
+    for (auto i = 0; i < static_cast<int>(MapType::MAX_PROBE_LENGTH); ++i)
+    {
+        REQUIRE(map.lookup(i).get_value() == i);
+    }
+
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(-1)));
+}
+
+TEST_CASE("robin hood map supports interleaved multilookup")
+{
+    using ResultType = typename RobinHoodMap<int, int>::LookupResultType;
+
+    RobinHoodMap<int, int> map{};
+    StaticQueueScheduler<32> scheduler{};
+
+    for (auto i = 0; i < 1024; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 2048; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<ResultType> results{};
+    map.interleaved_multilookup(
+        keys.begin(),
+        keys.end(),
+        std::back_inserter(results),
+        scheduler, 8);
+
+    REQUIRE(results.size() == keys.size());
+
+    std::size_t n_found = 0;
+    for (auto& r : results)
+    {
+        if (r)
+        {
+            REQUIRE(r.get_key() == r.get_value());
+            ++n_found;
+        }
+    }
+
+    REQUIRE(n_found == 1024);
+}
+
+TEST_CASE("concurrent map construction throws on invalid shard count")
+{
+    REQUIRE_THROWS(ConcurrentMap<int, int>{0});
+    REQUIRE_THROWS(ConcurrentMap<int, int>{(1ul << 32) + 1});
+    REQUIRE_THROWS(ConcurrentMap<int, int>{std::numeric_limits<std::size_t>::max()});
+}
+
+TEST_CASE("concurrent map supports insertion, lookup, update, and removal")
+{
+    ConcurrentMap<int, int> map{4};
+
+    for (auto i = 0; i < 1024; ++i)
+    {
+        REQUIRE(map.insert(i, i));
+    }
+
+    REQUIRE_FALSE(map.insert(0, 1));
+    REQUIRE(map.count() == 1024);
+
+    for (auto i = 0; i < 1024; ++i)
+    {
+        auto const r = map.lookup(i);
+        REQUIRE(static_cast<bool>(r));
+        REQUIRE(r.get_value() == i);
+    }
+
+    map.update(0, -1);
+    map.update(2048, 2048);
+    REQUIRE(map.lookup(0).get_value() == -1);
+    REQUIRE(map.lookup(2048).get_value() == 2048);
+
+    auto removed = map.remove(0);
+    REQUIRE(static_cast<bool>(removed));
+    REQUIRE(removed.get_value() == -1);
+    REQUIRE_FALSE(static_cast<bool>(map.remove(0)));
+    REQUIRE_FALSE(static_cast<bool>(map.lookup(0)));
+    REQUIRE(map.count() == 1024);
+}
+
+TEST_CASE("concurrent map supports interleaved multilookup")
+{
+    using ResultType = typename ConcurrentMap<int, int>::LookupResultType;
+
+    ConcurrentMap<int, int> map{};
+    StaticQueueScheduler<32> scheduler{};
+
+    for (auto i = 0; i < 1024; ++i)
+    {
+        map.insert(i, i);
+    }
+
+    std::vector<int> keys{};
+    for (auto i = 0; i < 2048; ++i)
+    {
+        keys.push_back(i);
+    }
+
+    std::vector<ResultType> results{};
+    map.interleaved_multilookup(
+        keys.begin(),
+        keys.end(),
+        std::back_inserter(results),
+        scheduler, 8);
+
+    REQUIRE(results.size() == keys.size());
+    REQUIRE(std::count_if(results.begin(), results.end(), 
+        [](auto const& r) { return static_cast<bool>(r) && r.get_key() == r.get_value(); }) == 1024);
+}
+
+TEST_CASE("concurrent map remains consistent under concurrent readers and writers")
+{
+    constexpr static auto const N_WRITERS = 4;
+    constexpr static auto const N_KEYS    = 1 << 14;
+
+    // a small number of shards ensures that readers and writers collide
+    ConcurrentMap<int, int> map{2};
+
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> n_inconsistent{0};
+
+    // readers only ever observe a key mapped to itself or its negation
+    auto reader = [&]() {
+        StaticQueueScheduler<16> scheduler{};
+        std::vector<int> keys{};
+        for (auto i = 0; i < 256; ++i)
+        {
+            keys.push_back(i);
+        }
+
+        while (!done.load())
+        {
+            for (auto i = 0; i < N_KEYS; ++i)
+            {
+                auto const r = map.lookup(i);
+                if (r && r.get_value() != i && r.get_value() != -i)
+                {
+                    ++n_inconsistent;
+                }
+            }
+
+            std::vector<ConcurrentMap<int, int>::LookupKVResult> results{};
+            map.interleaved_multilookup(
+                keys.begin(), keys.end(), std::back_inserter(results), scheduler, 4);
+            for (auto const& r : results)
+            {
+                if (r && r.get_value() != r.get_key() && r.get_value() != -r.get_key())
+                {
+                    ++n_inconsistent;
+                }
+            }
+        }
+    };
+
+    // each writer owns a disjoint set of keys
+    auto writer = [&](int const id) {
+        for (auto round = 0; round < 4; ++round)
+        {
+            for (auto i = id; i < N_KEYS; i += N_WRITERS)
+            {
+                map.insert(i, i);
+                map.update(i, -i);
+            }
+
+            for (auto i = id; i < N_KEYS; i += 2 * N_WRITERS)
+            {
+                map.remove(i);
+            }
+        }
+    };
+
+    std::vector<std::thread> readers{};
+    for (auto i = 0; i < 2; ++i)
+    {
+        readers.emplace_back(reader);
+    }
+
+    std::vector<std::thread> writers{};
+    for (auto i = 0; i < N_WRITERS; ++i)
+    {
+        writers.emplace_back(writer, i);
+    }
+
+    for (auto& t : writers)
+    {
+        t.join();
+    }
+
+    done.store(true);
+    for (auto& t : readers)
+    {
+        t.join();
+    }
+
+    REQUIRE(n_inconsistent.load() == 0);
+    REQUIRE(map.count() == N_KEYS / 2);
+
+    for (auto i = 0; i < N_KEYS; ++i)
+    {
+        auto const r = map.lookup(i);
+        REQUIRE(static_cast<bool>(r) == (i % (2 * N_WRITERS) >= N_WRITERS));
+    }
+}
+
+TEST_CASE("zipfian distribution draws only rank 0 from a single rank")
+{
+    std::mt19937_64 gen{42};
+
+    for (auto const n : {0ul, 1ul})
+    {
+        bench::zipfian_distribution distribution{n};
+        for (auto i = 0; i < 1000; ++i)
+        {
+            REQUIRE(distribution(gen) == 0);
+        }
+    }
+
+    // with two ranks, both are drawn, rank 0 more often than rank 1
+    bench::zipfian_distribution distribution{2};
+    std::array<std::size_t, 2> counts{};
+    for (auto i = 0; i < 1000; ++i)
+    {
+        auto const rank = distribution(gen);
+        REQUIRE(rank < 2);
+        ++counts[rank];
+    }
+
+    REQUIRE(counts[1] > 0);
+    REQUIRE(counts[0] > counts[1]);
+}
@@ -4,6 +4,10 @@
 #define THROTTLER_HPP
 
 #include <iostream>
+#include <utility>
+#include <stdcoro/coroutine.hpp>
+
+#include "frame_arena.hpp"
 
 template <typename Scheduler>
 class Throttler
@@ -11,19 +15,69 @@ class Throttler
     // the scheduler used by the throttler instance
     Scheduler const& scheduler;
 
-    // the current number of remaining coroutines this instance may spawn
-    std::size_t limit;
+    // the maximum number of coroutines this instance keeps in flight
+    std::size_t max_concurrent;
+
+    // the current number of spawned coroutines that have not completed
+    std::size_t active;
+
+    // the coroutine suspended in wait_for_slot() or wait_for_all(), if any
+    stdcoro::coroutine_handle<> waiting;
+
+    // the number of active coroutines at (or below) which `waiting` resumes
+    std::size_t waiting_limit;
+
+    // the frames of the coroutines spawned by this instance, see frame_arena()
+    FrameArena frames;
+
+    // The awaitable returned by wait_for_slot() and wait_for_all().
+    struct CompletionAwaitable
+    {
+        Throttler&        throttler;
+        std::size_t const limit;
+
+        bool await_ready() const
+        {
+            return throttler.active <= limit;
+        }
+
+        void await_suspend(stdcoro::coroutine_handle<> awaiting_coroutine)
+        {
+            // rescheduled by on_task_complete(); control returns to
+            // whoever resumed the awaiting coroutine (e.g. the scheduler)
+            throttler.waiting       = awaiting_coroutine;
+            throttler.waiting_limit = limit;
+        }
+
+        void await_resume() {}
+    };
 
 public:
     Throttler(
         Scheduler const&  scheduler_, 
         std::size_t const max_concurrent_tasks) 
+        : Throttler{scheduler_, max_concurrent_tasks, max_concurrent_tasks} {}
+
+    // Construct a throttler whose maximum number of coroutines in
+    // flight may later be raised (see set_max_concurrent()) up to `max_tasks`.
+    Throttler(
+        Scheduler const&  scheduler_, 
+        std::size_t const max_concurrent_tasks,
+        std::size_t const max_tasks) 
         : scheduler{scheduler_}
-        , limit{max_concurrent_tasks} {}
+        , max_concurrent{max_concurrent_tasks}
+        , active{0}
+        , waiting{nullptr}
+        , waiting_limit{0}
+        // a task is created before spawn() makes room for it
+        , frames{max_tasks + 1} {}
 
     ~Throttler()
     {
-        run();
+        if (active != 0)
+        {
+            run();
+        }
     }
 
     // non-copyable
@@ -37,7 +91,9 @@ public:
     template <typename TaskType>
     void spawn(TaskType task)
     {
-        if (0 == limit)
+        // resuming a task need not complete it (it may suspend again
+        // on its next prefetch), so keep resuming until a slot frees up
+        while (active != 0 && active >= max_concurrent)
         {
             auto handle = scheduler.remove_next_task();
             handle.resume();
@@ -47,8 +103,8 @@ public:
         auto handle = task.set_owner(this);
         scheduler.schedule(handle);
         
-        // spawned a new active task, so decrement the limit
-        --limit;
+        // spawned a new active task
+        ++active;
     }
 
     void run()
@@ -56,10 +112,55 @@ public:
         scheduler.run();
     }
 
+    // Suspend the awaiting coroutine until a task may be spawned without
+    // blocking; unlike spawn(), which resumes other tasks itself until a
+    // slot frees up, this leaves the scheduler to whoever is running it,
+    // so that a coroutine that spawns tasks may itself run on the scheduler.
+    auto wait_for_slot() -> CompletionAwaitable
+    {
+        return CompletionAwaitable{*this, (max_concurrent > 0) ? max_concurrent - 1 : 0};
+    }
+
+    // Suspend the awaiting coroutine until all spawned tasks complete.
+    auto wait_for_all() -> CompletionAwaitable
+    {
+        return CompletionAwaitable{*this, 0};
+    }
+
     void on_task_complete()
     {
-        ++limit;
+        --active;
+
+        if (waiting && active <= waiting_limit)
+        {
+            scheduler.schedule(std::exchange(waiting, nullptr));
+        }
+    }
+
+    // Adjust the maximum number of coroutines kept in flight;
+    // when lowered, the excess tasks drain on subsequent spawns.
+    void set_max_concurrent(std::size_t const max_concurrent_tasks)
+    {
+        max_concurrent = max_concurrent_tasks;
+    }
+
+    auto get_max_concurrent() const -> std::size_t
+    {
+        return max_concurrent;
+    }
+
+    auto get_active() const -> std::size_t
+    {
+        return active;
+    }
+
+    // The arena from which the frames of tasks spawned by this instance
+    // may be allocated; a task type opts in by way of a promise operator
+    // new that takes the throttler as an allocator argument.
+    auto frame_arena() -> FrameArena&
+    {
+        return frames;
     }
 };
 
-#endif // THROTTLER_HPP
\ No newline at end of file
+#endif // THROTTLER_HPP
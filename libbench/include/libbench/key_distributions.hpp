@@ -0,0 +1,138 @@
+// key_distributions.hpp
+// Distributions over the ranks of a key space for benchmark workloads.
+//
+// Each distribution produces ranks in [0, n), in the manner of the
+// distributions of <random>; a benchmark maps each rank to a key of its
+// own key space, such that rank 0 is the most frequently drawn key.
+
+#ifndef BENCH_KEY_DISTRIBUTIONS_HPP
+#define BENCH_KEY_DISTRIBUTIONS_HPP
+
+#include <cmath>
+#include <random>
+#include <cstddef>
+#include <algorithm>
+
+namespace bench
+{
+    // A Zipfian distribution over the ranks [0, n): the probability of
+    // rank i is proportional to 1 / (i + 1)^theta. Ranks are drawn in
+    // constant time with the method of Gray et al., "Quickly Generating
+    // Billion-Record Synthetic Databases" (SIGMOD 1994), as in YCSB.
+    // With at most a single rank, rank 0 is always drawn.
+    class zipfian_distribution
+    {
+        // the number of ranks
+        std::size_t n;
+
+        // the skew of the distribution; YCSB uses 0.99
+        double theta;
+
+        // constants of the method, fixed upon construction
+        double alpha;
+        double zeta_n;
+        double eta;
+        double half_pow_theta;
+
+        std::uniform_real_distribution<double> uniform;
+
+    public:
+        explicit zipfian_distribution(std::size_t const n_, double const theta_ = 0.99)
+            : n{n_}
+            , theta{theta_}
+            , alpha{1.0 / (1.0 - theta_)}
+            , zeta_n{zeta(std::max(n_, static_cast<std::size_t>(2)), theta_)}
+            , eta{0.0}
+            , half_pow_theta{std::pow(0.5, theta_)}
+            , uniform{0.0, 1.0}
+        {
+            // the constants are those of two ranks if there are fewer,
+            // though they are then never used (see operator())
+            auto const n_ranks = std::max(n, static_cast<std::size_t>(2));
+            auto const zeta_2  = zeta(2, theta);
+            eta = (1.0 - std::pow(2.0 / static_cast<double>(n_ranks), 1.0 - theta))
+                / (1.0 - zeta_2 / zeta_n);
+        }
+
+        template <typename Generator>
+        auto operator()(Generator& gen) -> std::size_t
+        {
+            if (n <= 1)
+            {
+                return 0;
+            }
+
+            auto const u  = uniform(gen);
+            auto const uz = u * zeta_n;
+
+            if (uz < 1.0)
+            {
+                return 0;
+            }
+
+            if (uz < 1.0 + half_pow_theta)
+            {
+                return 1;
+            }
+
+            auto const rank = static_cast<std::size_t>(
+                static_cast<double>(n) * std::pow(eta * u - eta + 1.0, alpha));
+            return std::min(rank, n - 1);
+        }
+
+    private:
+        // The generalized harmonic number of order `theta`; computed once
+        // per distribution, in time linear in the number of ranks.
+        static auto zeta(std::size_t const count, double const skew) -> double
+        {
+            auto sum = 0.0;
+            for (auto i = 1ul; i <= count; ++i)
+            {
+                sum += 1.0 / std::pow(static_cast<double>(i), skew);
+            }
+
+            return sum;
+        }
+    };
+
+    // A "hotspot" distribution over the ranks [0, n), as in YCSB: a
+    // fraction `hot_op_fraction` of the draws are uniform over the first
+    // `hot_fraction` of the ranks, and the remainder uniform over the rest.
+    // A single rank is both the hot set and the rest, so is always drawn.
+    class hotspot_distribution
+    {
+        // the number of ranks in the hot set
+        std::size_t n_hot;
+
+        // the fraction of draws from the hot set
+        double hot_op_fraction;
+
+        std::uniform_real_distribution<double>     coin;
+        std::uniform_int_distribution<std::size_t> hot;
+        std::uniform_int_distribution<std::size_t> cold;
+
+    public:
+        explicit hotspot_distribution(
+            std::size_t const n, 
+            double const      hot_fraction     = 0.2, 
+            double const      hot_op_fraction_ = 0.8)
+            : n_hot{std::clamp(
+                static_cast<std::size_t>(static_cast<double>(n) * hot_fraction), 
+                static_cast<std::size_t>(1), 
+                std::max(n, static_cast<std::size_t>(2)) - 1)}
+            , hot_op_fraction{hot_op_fraction_}
+            , coin{0.0, 1.0}
+            , hot{0, n_hot - 1}
+            , cold{
+                std::min(n_hot, std::max(n, static_cast<std::size_t>(1)) - 1),
+                std::max(n, static_cast<std::size_t>(1)) - 1} {}
+
+        template <typename Generator>
+        auto operator()(Generator& gen) -> std::size_t
+        {
+            return (coin(gen) < hot_op_fraction) ? hot(gen) : cold(gen);
+        }
+    };
+}
+
+#endif // BENCH_KEY_DISTRIBUTIONS_HPP
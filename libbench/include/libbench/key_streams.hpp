@@ -0,0 +1,224 @@
+// key_streams.hpp
+// Lazily-generated streams of keys for benchmark workloads.
+//
+// Each stream is a coro::generator that yields `count` keys drawn from
+// the key space [0, n_keys), such that a benchmark pays neither the
+// memory for a vector of (up to tens of millions of) keys nor the cost
+// of populating one. The streams other than the sequential stream are
+// meant to keep a benchmark honest: with std::hash<int> the identity,
+// dense sequential keys spread perfectly over the buckets of a hash
+// table, a distribution that production workloads never exhibit.
+
+#ifndef BENCH_KEY_STREAMS_HPP
+#define BENCH_KEY_STREAMS_HPP
+
+#include <bit>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <libcoro/generator.hpp>
+
+#include "key_distributions.hpp"
+
+namespace bench
+{
+    // The default stride of a strided stream; an odd multiplier, so that
+    // a strided pass over a key space of power-of-2 size visits every key.
+    constexpr static std::size_t const SCATTER_STRIDE = 0x9E3779B1;
+
+    // The default number of low-order bits shared by colliding keys;
+    // colliding keys fill 1 / 2^bits of the buckets of a table indexed by
+    // the low-order bits of an identity hash, such as that of Map.
+    constexpr static unsigned const COLLIDING_BITS = 4;
+
+    // The distributions of the keys of a benchmark workload.
+    enum class key_distribution : std::int64_t
+    {
+        sequential,
+        strided,
+        uniform,
+        zipfian,
+        hotspot,
+        colliding
+    };
+
+    // The name of `distribution`, e.g. for a benchmark label.
+    inline auto key_distribution_name(key_distribution const distribution) -> char const*
+    {
+        switch (distribution)
+        {
+        case key_distribution::sequential:
+            return "sequential";
+        case key_distribution::strided:
+            return "strided";
+        case key_distribution::uniform:
+            return "uniform";
+        case key_distribution::zipfian:
+            return "zipfian";
+        case key_distribution::hotspot:
+            return "hotspot";
+        case key_distribution::colliding:
+        default:
+            return "colliding";
+        }
+    }
+
+    // Map rank `i` of the key space [0, n_keys) to a key, scattering the
+    // ranks across the key space if its size is a power of 2, such that
+    // the popular ranks of a skewed stream do not share buckets.
+    inline auto scatter(std::size_t const i, std::size_t const n_keys) -> std::size_t
+    {
+        return std::has_single_bit(n_keys) ? ((i * SCATTER_STRIDE) & (n_keys - 1)) : i;
+    }
+
+    // Yield the keys [0, count) in order.
+    template <typename T>
+    coro::generator<T> sequential_keys(std::size_t const count)
+    {
+        for (auto i = 0ul; i < count; ++i)
+        {
+            co_yield static_cast<T>(i);
+        }
+    }
+
+    // Yield `count` keys, `stride` apart (modulo `n_keys`); with an odd
+    // stride and `n_keys` a power of 2, the first `n_keys` keys of the
+    // stream visit every key exactly once, in an order that defeats the
+    // hardware prefetcher.
+    template <typename T>
+    coro::generator<T> strided_keys(
+        std::size_t const count,
+        std::size_t const n_keys,
+        std::size_t const stride = SCATTER_STRIDE)
+    {
+        for (auto i = 0ul; i < count; ++i)
+        {
+            co_yield static_cast<T>((i * stride) % n_keys);
+        }
+    }
+
+    // Yield `count` keys drawn uniformly at random.
+    template <typename T>
+    coro::generator<T> uniform_keys(
+        std::size_t const   count,
+        std::size_t const   n_keys,
+        std::uint64_t const seed)
+    {
+        std::mt19937_64 gen{seed};
+        std::uniform_int_distribution<std::size_t> distribution{0, n_keys - 1};
+        for (auto i = 0ul; i < count; ++i)
+        {
+            co_yield static_cast<T>(distribution(gen));
+        }
+    }
+
+    // Yield `count` keys drawn with Zipfian skew `theta`; the popular
+    // keys are scattered across the key space (see scatter()).
+    template <typename T>
+    coro::generator<T> zipfian_keys(
+        std::size_t const   count,
+        std::size_t const   n_keys,
+        std::uint64_t const seed,
+        double const        theta = 0.99)
+    {
+        std::mt19937_64 gen{seed};
+        zipfian_distribution distribution{n_keys, theta};
+        for (auto i = 0ul; i < count; ++i)
+        {
+            co_yield static_cast<T>(scatter(distribution(gen), n_keys));
+        }
+    }
+
+    // Yield `count` keys of which `hot_op_fraction` are drawn from the
+    // contiguous range of keys that is the first `hot_fraction` of the
+    // key space, and the remainder from the rest of the key space.
+    template <typename T>
+    coro::generator<T> hotspot_keys(
+        std::size_t const   count,
+        std::size_t const   n_keys,
+        std::uint64_t const seed,
+        double const        hot_fraction    = 0.2,
+        double const        hot_op_fraction = 0.8)
+    {
+        std::mt19937_64 gen{seed};
+        hotspot_distribution distribution{n_keys, hot_fraction, hot_op_fraction};
+        for (auto i = 0ul; i < count; ++i)
+        {
+            co_yield static_cast<T>(distribution(gen));
+        }
+    }
+
+    // Yield `count` keys that share their low-order `bits`, in order;
+    // the key space [0, n_keys) is mapped to keys i << bits.
+    template <typename T>
+    coro::generator<T> colliding_keys(
+        std::size_t const count,
+        std::size_t const n_keys,
+        unsigned const    bits = COLLIDING_BITS)
+    {
+        for (auto i = 0ul; i < count; ++i)
+        {
+            co_yield static_cast<T>((i % n_keys) << bits);
+        }
+    }
+
+    // Yield `count` keys that share their low-order `bits`, drawn 
+    // uniformly at random; the key space [0, n_keys) is mapped as by
+    // colliding_keys().
+    template <typename T>
+    coro::generator<T> uniform_colliding_keys(
+        std::size_t const   count,
+        std::size_t const   n_keys,
+        std::uint64_t const seed,
+        unsigned const      bits = COLLIDING_BITS)
+    {
+        std::mt19937_64 gen{seed};
+        std::uniform_int_distribution<std::size_t> distribution{0, n_keys - 1};
+        for (auto i = 0ul; i < count; ++i)
+        {
+            co_yield static_cast<T>(distribution(gen) << bits);
+        }
+    }
+
+    // Yield the `n_keys` keys with which to populate a structure that
+    // is then probed with lookup_keys() under `distribution`; these are
+    // [0, n_keys), other than for the colliding distribution.
+    template <typename T>
+    coro::generator<T> key_set(
+        key_distribution const distribution,
+        std::size_t const      n_keys)
+    {
+        return (key_distribution::colliding == distribution)
+            ? colliding_keys<T>(n_keys, n_keys)
+            : sequential_keys<T>(n_keys);
+    }
+
+    // Yield `count` keys drawn from the key set of `n_keys`
+    // keys (see key_set()) under `distribution`.
+    template <typename T>
+    coro::generator<T> lookup_keys(
+        key_distribution const distribution,
+        std::size_t const      count,
+        std::size_t const      n_keys,
+        std::uint64_t const    seed)
+    {
+        switch (distribution)
+        {
+        case key_distribution::sequential:
+            return strided_keys<T>(count, n_keys, 1);
+        case key_distribution::strided:
+            return strided_keys<T>(count, n_keys);
+        case key_distribution::uniform:
+            return uniform_keys<T>(count, n_keys, seed);
+        case key_distribution::zipfian:
+            return zipfian_keys<T>(count, n_keys, seed);
+        case key_distribution::hotspot:
+            return hotspot_keys<T>(count, n_keys, seed);
+        case key_distribution::colliding:
+        default:
+            return uniform_colliding_keys<T>(count, n_keys, seed);
+        }
+    }
+}
+
+#endif // BENCH_KEY_STREAMS_HPP
@@ -0,0 +1,54 @@
+// peak_rss.hpp
+// The peak resident set size of the calling process.
+//
+// The peak is read from VmHWM in /proc/self/status, and reset by way of
+// /proc/self/clear_refs (Linux 4.0 and later), such that the peak may be
+// measured for each benchmark rather than for the process as a whole.
+// On other platforms (or if procfs is unavailable) the peak reads as 0.
+
+#ifndef BENCH_PEAK_RSS_HPP
+#define BENCH_PEAK_RSS_HPP
+
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+
+namespace bench
+{
+    // Reset the peak resident set size to the current resident set size.
+    inline void reset_peak_rss()
+    {
+#if defined(__linux__)
+        if (auto* file = std::fopen("/proc/self/clear_refs", "w"); file != nullptr)
+        {
+            std::fputs("5", file);
+            std::fclose(file);
+        }
+#endif
+    }
+
+    // Query the peak resident set size, in bytes, since the last reset.
+    inline auto peak_rss() -> std::size_t
+    {
+        std::size_t kb = 0;
+#if defined(__linux__)
+        if (auto* file = std::fopen("/proc/self/status", "r"); file != nullptr)
+        {
+            char line[256];
+            while (std::fgets(line, sizeof(line), file) != nullptr)
+            {
+                if (std::strncmp(line, "VmHWM:", 6) == 0)
+                {
+                    std::sscanf(line + 6, "%zu", &kb);
+                    break;
+                }
+            }
+
+            std::fclose(file);
+        }
+#endif
+        return kb * 1024;
+    }
+}
+
+#endif // BENCH_PEAK_RSS_HPP
@@ -0,0 +1,281 @@
+// perf_counters.hpp
+// Hardware performance counters for the timed region of a benchmark.
+//
+// Counters are collected with perf_event_open(2) for the calling thread
+// (user space only) and reported per operation as Google Benchmark user
+// counters. Any counter that cannot be opened (e.g. on a platform other
+// than Linux, under a restrictive perf_event_paranoid setting, or in a
+// virtual machine that does not expose the PMU) is silently omitted.
+
+#ifndef BENCH_PERF_COUNTERS_HPP
+#define BENCH_PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace bench
+{
+    class perf_counters
+    {
+    public:
+        // the events collected
+        enum event : std::size_t
+        {
+            instructions,
+            cycles,
+            l1d_misses,
+            llc_misses,
+            dtlb_misses,
+            n_events
+        };
+
+    private:
+        // A single read of an event: its raw count, and the total time
+        // for which it has been enabled and running (i.e. scheduled on 
+        // the PMU), which differ if the PMU is multiplexed.
+        struct reading
+        {
+            std::uint64_t value;
+            std::uint64_t time_enabled;
+            std::uint64_t time_running;
+        };
+
+        // the name under which each event is reported
+        constexpr static std::array<char const*, n_events> const EVENT_NAMES = {
+            "instructions",
+            "cycles",
+            "l1d_misses",
+            "llc_misses",
+            "dtlb_misses"
+        };
+
+        // the descriptor for each event, or -1 if unavailable
+        std::array<int, n_events> fds;
+
+        // the reading of each event at the start of the current sample
+        std::array<reading, n_events> begun;
+
+        // the count for each event, summed over all samples
+        std::array<double, n_events> totals;
+
+        // the number of start() / stop() pairs observed
+        std::size_t n_samples;
+
+    public:
+        perf_counters()
+            : fds{}, begun{}, totals{}, n_samples{0}
+        {
+            for (auto i = 0ul; i < n_events; ++i)
+            {
+                fds[i] = open_event(static_cast<event>(i));
+            }
+        }
+
+        ~perf_counters()
+        {
+#if defined(__linux__)
+            for (auto const fd : fds)
+            {
+                if (fd != -1)
+                {
+                    ::close(fd);
+                }
+            }
+#endif
+        }
+
+        // non-copyable
+        perf_counters(perf_counters const&)            = delete;
+        perf_counters& operator=(perf_counters const&) = delete;
+
+        // non-movable
+        perf_counters(perf_counters&&)            = delete;
+        perf_counters& operator=(perf_counters&&) = delete;
+
+        // Determine whether `e` is being collected.
+        auto available(event const e) const -> bool
+        {
+            return fds[e] != -1;
+        }
+
+        // Determine whether any event is being collected.
+        auto any_available() const -> bool
+        {
+            for (auto const fd : fds)
+            {
+                if (fd != -1)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Begin counting; call immediately before the timed region.
+        void start()
+        {
+#if defined(__linux__)
+            // the counters are never reset, as a reset zeroes the count but
+            // not the times enabled and running; each sample is instead the
+            // difference of the readings at its start and at its end
+            for (auto i = 0ul; i < n_events; ++i)
+            {
+                begun[i] = read_event(fds[i]);
+            }
+
+            for (auto const fd : fds)
+            {
+                if (fd != -1)
+                {
+                    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+            }
+#endif
+        }
+
+        // Stop counting; call immediately after the timed region.
+        void stop()
+        {
+#if defined(__linux__)
+            for (auto const fd : fds)
+            {
+                if (fd != -1)
+                {
+                    ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            }
+
+            for (auto i = 0ul; i < n_events; ++i)
+            {
+                totals[i] += scaled_count(begun[i], read_event(fds[i]));
+            }
+#endif
+            ++n_samples;
+        }
+
+        // Report the mean count for each available event per operation,
+        // where each sample (timed region) performed `ops_per_sample`.
+        void report(benchmark::State& state, std::size_t const ops_per_sample) const
+        {
+            if (0 == n_samples || 0 == ops_per_sample)
+            {
+                return;
+            }
+
+            auto const n_ops = static_cast<double>(n_samples) * static_cast<double>(ops_per_sample);
+            for (auto i = 0ul; i < n_events; ++i)
+            {
+                if (fds[i] != -1)
+                {
+                    state.counters[EVENT_NAMES[i]] = totals[i] / n_ops;
+                }
+            }
+
+            if (available(instructions) && available(cycles) && totals[cycles] > 0.0)
+            {
+                state.counters["ipc"] = totals[instructions] / totals[cycles];
+            }
+        }
+
+    private:
+        // Open a (disabled) counter for `e` on the calling
+        // thread; returns -1 if the event cannot be counted.
+        static auto open_event(event const e) -> int
+        {
+#if defined(__linux__)
+            perf_event_attr attr{};
+            attr.size           = sizeof(attr);
+            attr.disabled       = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+
+            // the fraction of the time for which the event was scheduled
+            // is read alongside its count, to correct for multiplexing
+            attr.read_format
+                = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            constexpr auto const read_miss = [](std::uint64_t const cache) {
+                return cache
+                    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            };
+
+            switch (e)
+            {
+            case instructions:
+                attr.type   = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case cycles:
+                attr.type   = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case l1d_misses:
+                attr.type   = PERF_TYPE_HW_CACHE;
+                attr.config = read_miss(PERF_COUNT_HW_CACHE_L1D);
+                break;
+            case llc_misses:
+                attr.type   = PERF_TYPE_HW_CACHE;
+                attr.config = read_miss(PERF_COUNT_HW_CACHE_LL);
+                break;
+            case dtlb_misses:
+                attr.type   = PERF_TYPE_HW_CACHE;
+                attr.config = read_miss(PERF_COUNT_HW_CACHE_DTLB);
+                break;
+            case n_events:
+            default:
+                return -1;
+            }
+
+            auto const fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            return (fd < 0) ? -1 : static_cast<int>(fd);
+#else
+            static_cast<void>(e);
+            return -1;
+#endif
+        }
+
+#if defined(__linux__)
+        // Read the event at `fd`; all zero if it cannot be read.
+        static auto read_event(int const fd) -> reading
+        {
+            reading result{};
+            if (-1 == fd || ::read(fd, &result, sizeof(result)) != static_cast<ssize_t>(sizeof(result)))
+            {
+                return reading{};
+            }
+
+            return result;
+        }
+
+        // The count of an event between readings `from` and `to`, scaled 
+        // up to the time for which the event was enabled in that interval
+        // if it was not running throughout.
+        static auto scaled_count(reading const& from, reading const& to) -> double
+        {
+            auto const running = to.time_running - from.time_running;
+            if (0 == running || to.value < from.value)
+            {
+                return 0.0;
+            }
+
+            auto const enabled = to.time_enabled - from.time_enabled;
+            return static_cast<double>(to.value - from.value)
+                * (static_cast<double>(enabled) / static_cast<double>(running));
+        }
+#endif
+    };
+}
+
+#endif // BENCH_PERF_COUNTERS_HPP
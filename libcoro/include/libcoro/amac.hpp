@@ -0,0 +1,142 @@
+// amac.hpp
+// Asynchronous memory access chaining: interleaving without coroutines.
+//
+// An operation that chases pointers (a tree descent, a walk of a hash
+// chain) is expressed as a "step machine": a state, and functions that
+// advance it from one memory access to the next. Each of these returns
+// the address that the operation touches next, or nullptr once the
+// operation is complete:
+//
+//   start(state, input) -> void const*   begin an operation on `input`
+//   step(state)         -> void const*   perform the access at the address
+//                                        last returned, and advance
+//   finish(state)                        deliver the result
+//
+// The machine never prefetches itself; whether the address is prefetched
+// (and whether other operations run in the meantime) is left to the
+// engine that drives it, such that the same machine may be executed
+// one operation at a time (run_sequential()), as a fixed ring of states
+// stepped round-robin (run_amac()), or as coroutines that suspend on
+// each address, on whatever scheduler the application interleaves with.
+//
+// See Kocberber et al., "Asynchronous Memory Access Chaining" (VLDB 2015).
+
+#ifndef CORO_AMAC_HPP
+#define CORO_AMAC_HPP
+
+#include <vector>
+#include <cstddef>
+#include <iterator>
+#include <concepts>
+
+#include <xmmintrin.h>
+
+namespace coro
+{
+    // A machine that performs an operation on an input of type `Input`
+    // as a sequence of steps, one memory access per step.
+    template <typename Machine, typename Input>
+    concept step_machine = std::default_initializable<typename Machine::state_type>
+        && requires(Machine& machine, typename Machine::state_type& state, Input&& input)
+        {
+            { machine.start(state, static_cast<Input&&>(input)) } -> std::convertible_to<void const*>;
+            { machine.step(state) } -> std::convertible_to<void const*>;
+            { machine.finish(state) };
+        };
+
+    // Perform the operation for each input in [first, last) with `machine`,
+    // one at a time; each access is left to the cache (and the hardware
+    // prefetcher), which is the cheapest execution for a cached structure.
+    template <typename Machine, typename InputIter, typename Sentinel>
+        requires step_machine<Machine, std::iter_reference_t<InputIter>>
+    auto run_sequential(Machine& machine, InputIter first, Sentinel last) -> void
+    {
+        typename Machine::state_type state{};
+        for (; first != last; ++first)
+        {
+            auto const* next = static_cast<void const*>(machine.start(state, *first));
+            while (next != nullptr)
+            {
+                next = machine.step(state);
+            }
+
+            machine.finish(state);
+        }
+    }
+
+    // Perform the operation for each input in [first, last) with `machine`,
+    // with up to `n_streams` operations in flight in a ring of states:
+    // each step prefetches the address that the operation touches next,
+    // and the ring moves on to the next state rather than waiting for it.
+    // A state whose operation completes is refilled with the next input
+    // at once, such that the ring remains full until the inputs run out.
+    // Operations complete (and are finished) out of order.
+    template <typename Machine, typename InputIter, typename Sentinel>
+        requires step_machine<Machine, std::iter_reference_t<InputIter>>
+    auto run_amac(
+        Machine&          machine,
+        InputIter         first,
+        Sentinel          last,
+        std::size_t const n_streams) -> void
+    {
+        struct slot
+        {
+            typename Machine::state_type state;
+
+            // the address of the next access, or nullptr if idle
+            void const* next = nullptr;
+        };
+
+        std::vector<slot> ring(n_streams > 0 ? n_streams : 1);
+        std::size_t n_active = 0;
+
+        // start the operation for the next input in `s`, finishing at
+        // once any operations that complete without touching memory
+        auto const admit = [&](slot& s) {
+            while (first != last)
+            {
+                s.next = machine.start(s.state, *first);
+                ++first;
+
+                if (s.next != nullptr)
+                {
+                    _mm_prefetch(static_cast<char const*>(s.next), _MM_HINT_NTA);
+                    ++n_active;
+                    return;
+                }
+
+                machine.finish(s.state);
+            }
+        };
+
+        for (auto& s : ring)
+        {
+            admit(s);
+        }
+
+        while (n_active > 0)
+        {
+            for (auto& s : ring)
+            {
+                if (nullptr == s.next)
+                {
+                    continue;
+                }
+
+                s.next = machine.step(s.state);
+                if (s.next != nullptr)
+                {
+                    _mm_prefetch(static_cast<char const*>(s.next), _MM_HINT_NTA);
+                    continue;
+                }
+
+                machine.finish(s.state);
+                --n_active;
+
+                admit(s);
+            }
+        }
+    }
+}
+
+#endif // CORO_AMAC_HPP
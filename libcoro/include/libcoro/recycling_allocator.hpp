@@ -0,0 +1,369 @@
+// recycling_allocator.hpp
+// A thread-caching allocator for coroutine frames.
+//
+// Frames are recycled through per-thread free lists, one per size class,
+// such that a coroutine that is spawned over and over (e.g. once for each
+// lookup in a batch) reuses the frame of an earlier one rather than going
+// to malloc. A frame may be freed by a thread other than the one that
+// allocated it; it is then handed back to the allocating thread through
+// a lock-free inbox, and recycled by that thread once its own free list
+// for the size class runs dry.
+
+#ifndef CORO_RECYCLING_ALLOCATOR_HPP
+#define CORO_RECYCLING_ALLOCATOR_HPP
+
+#include <new>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+
+namespace coro
+{
+    // Statistics for the frames allocated by (and cached on) one thread.
+    struct recycling_allocator_stats
+    {
+        // the number of frames allocated by the thread
+        std::size_t n_allocs;
+
+        // the number of those served from the thread's cache
+        std::size_t n_recycled;
+
+        // the number of frames freed by other threads and handed back
+        std::size_t n_remote_frees;
+
+        // the number of cached frames released to the system by trimming
+        std::size_t n_trimmed;
+
+        // the number of bytes currently held in the thread's cache
+        std::size_t cached_bytes;
+    };
+
+    class recycling_allocator
+    {
+        // The granularity of the size classes; frames are rounded up
+        // (with their header) to a whole number of cache lines.
+        constexpr static std::size_t const CLASS_SIZE = 64;
+
+        // The number of size classes; larger frames (beyond 2KB) are
+        // not cached, but allocated from and freed to the system directly.
+        constexpr static std::size_t const N_CLASSES = 32;
+
+        // The number of bytes a thread may cache; once exceeded, the cache
+        // is trimmed to half of this, releasing frames to the system.
+        constexpr static std::size_t const MAX_CACHED_BYTES = 1ul << 20;
+
+        struct inbox;
+
+        // Precedes each frame; identifies the thread to which it returns.
+        struct alignas(alignof(std::max_align_t)) header
+        {
+            // the inbox of the allocating thread, or nullptr if uncached
+            inbox* owner;
+
+            // the size class of the frame
+            std::size_t size_class;
+        };
+
+        // Overlays a frame while it is cached.
+        struct free_frame
+        {
+            free_frame* next;
+        };
+
+        // The frames freed by other threads, awaiting collection by the
+        // owning thread; frames are pushed by any thread, but only ever
+        // taken all at once by the owner, so the stack is free of ABA.
+        struct inbox
+        {
+            std::atomic<free_frame*> head{nullptr};
+
+            // the next inbox in the list of orphaned inboxes
+            inbox* next_orphan{nullptr};
+        };
+
+        // The stage in the life of the cache of a thread.
+        enum class cache_state : unsigned char
+        {
+            // not yet constructed; it is constructed upon first use
+            unborn,
+            live,
+            // destroyed; it must not be touched again by its thread
+            destroyed
+        };
+
+        // The cache of a single thread.
+        struct thread_cache
+        {
+            // the cached frames of each size class
+            std::array<free_frame*, N_CLASSES> frames;
+
+            // the inbox of this thread
+            inbox* mail;
+
+            recycling_allocator_stats stats;
+
+            thread_cache()
+                : frames{}, mail{adopt_inbox()}, stats{} 
+            {
+                state() = cache_state::live;
+            }
+
+            ~thread_cache()
+            {
+                // frames freed on this thread from here on (e.g. by
+                // thread_locals destroyed after this one, or by statics 
+                // at exit) are handed back as if by another thread, and
+                // frames allocated from here on are not cached at all
+                state() = cache_state::destroyed;
+
+                collect(*this);
+                trim_to(*this, 0);
+
+                // frames that are still alive elsewhere will be handed back
+                // to the inbox after this thread has exited; the inbox is
+                // adopted (with any such frames) by the next thread to start
+                orphan_inbox(mail);
+            }
+
+            // non-copyable
+            thread_cache(thread_cache const&)            = delete;
+            thread_cache& operator=(thread_cache const&) = delete;
+
+            // non-movable
+            thread_cache(thread_cache&&)            = delete;
+            thread_cache& operator=(thread_cache&&) = delete;
+        };
+
+    public:
+        // Allocate a frame of `n` bytes.
+        static void* allocate(std::size_t const n)
+        {
+            if (cache_state::destroyed == state())
+            {
+                // e.g. a coroutine started by a thread_local destroyed
+                // after the cache; the frame is freed to the system
+                return allocate_uncached(n);
+            }
+
+            auto& cache = local();
+            ++cache.stats.n_allocs;
+
+            auto const size_class = class_of(n);
+            if (size_class < N_CLASSES)
+            {
+                if (nullptr == cache.frames[size_class])
+                {
+                    collect(cache);
+                }
+
+                if (auto* frame = cache.frames[size_class]; frame != nullptr)
+                {
+                    cache.frames[size_class] = frame->next;
+                    cache.stats.cached_bytes -= class_bytes(size_class);
+                    ++cache.stats.n_recycled;
+                    return frame;
+                }
+            }
+
+            if (size_class >= N_CLASSES)
+            {
+                return allocate_uncached(n);
+            }
+
+            auto* block = std::malloc(class_bytes(size_class));
+            if (nullptr == block)
+            {
+                throw std::bad_alloc{};
+            }
+
+            auto* h = ::new (block) header{cache.mail, size_class};
+            return h + 1;
+        }
+
+        // Free a frame of `n` bytes, allocated on any thread.
+        static void deallocate(void* ptr, std::size_t const n) noexcept
+        {
+            auto* h = static_cast<header*>(ptr) - 1;
+            if (nullptr == h->owner)
+            {
+                // too large to be cached
+                std::free(h);
+                return;
+            }
+
+            assert(class_of(n) == h->size_class);
+            static_cast<void>(n);
+
+            // the cache is never constructed here: its construction may 
+            // throw, and it may be freeing a frame that outlives its cache
+            auto* frame = ::new (ptr) free_frame{nullptr};
+            if (state() != cache_state::live || h->owner != local().mail)
+            {
+                // hand the frame back to the thread that allocated it
+                auto& head = h->owner->head;
+                frame->next = head.load(std::memory_order_relaxed);
+                while (!head.compare_exchange_weak(
+                    frame->next, frame, std::memory_order_release, std::memory_order_relaxed));
+
+                return;
+            }
+
+            cache_frame(local(), frame, h->size_class);
+        }
+
+        // Release every frame cached by the calling thread to the system.
+        static void trim()
+        {
+            if (state() != cache_state::live)
+            {
+                // nothing is cached
+                return;
+            }
+
+            auto& cache = local();
+            collect(cache);
+            trim_to(cache, 0);
+        }
+
+        // Query the statistics for the calling thread.
+        static auto stats() -> recycling_allocator_stats
+        {
+            return (cache_state::destroyed == state()) 
+                ? recycling_allocator_stats{} 
+                : local().stats;
+        }
+
+    private:
+        static auto local() -> thread_cache&
+        {
+            thread_local thread_cache cache{};
+            return cache;
+        }
+
+        // The stage in the life of the cache of the calling thread. 
+        // Trivially destructible, and so may be read at any point in 
+        // the life of the thread, even once its cache is gone.
+        static auto state() -> cache_state&
+        {
+            thread_local cache_state current = cache_state::unborn;
+            return current;
+        }
+
+        // Allocate a frame of `n` bytes from the system, bypassing the cache.
+        static void* allocate_uncached(std::size_t const n)
+        {
+            auto* block = std::malloc(sizeof(header) + n);
+            if (nullptr == block)
+            {
+                throw std::bad_alloc{};
+            }
+
+            auto* h = ::new (block) header{nullptr, class_of(n)};
+            return h + 1;
+        }
+
+        // The size class for a frame of `n` bytes (plus its header).
+        static auto class_of(std::size_t const n) -> std::size_t
+        {
+            return (n + sizeof(header) + CLASS_SIZE - 1) / CLASS_SIZE - 1;
+        }
+
+        // The size of a block (with its header) in `size_class`.
+        static auto class_bytes(std::size_t const size_class) -> std::size_t
+        {
+            return (size_class + 1) * CLASS_SIZE;
+        }
+
+        static auto header_of(free_frame* frame) -> header*
+        {
+            return reinterpret_cast<header*>(frame) - 1;
+        }
+
+        static void cache_frame(thread_cache& cache, free_frame* frame, std::size_t const size_class)
+        {
+            frame->next = cache.frames[size_class];
+            cache.frames[size_class] = frame;
+            cache.stats.cached_bytes += class_bytes(size_class);
+
+            if (cache.stats.cached_bytes > MAX_CACHED_BYTES)
+            {
+                trim_to(cache, MAX_CACHED_BYTES / 2);
+            }
+        }
+
+        // Move the frames handed back by other threads into the cache.
+        static void collect(thread_cache& cache)
+        {
+            auto* frame = cache.mail->head.exchange(nullptr, std::memory_order_acquire);
+            while (frame != nullptr)
+            {
+                auto* next = frame->next;
+                ++cache.stats.n_remote_frees;
+                cache_frame(cache, frame, header_of(frame)->size_class);
+                frame = next;
+            }
+        }
+
+        // Release cached frames, largest first, until at most `target` bytes remain.
+        static void trim_to(thread_cache& cache, std::size_t const target)
+        {
+            for (auto size_class = N_CLASSES; size_class-- > 0 && cache.stats.cached_bytes > target;)
+            {
+                auto*& frames = cache.frames[size_class];
+                while (frames != nullptr && cache.stats.cached_bytes > target)
+                {
+                    auto* frame = frames;
+                    frames = frame->next;
+
+                    std::free(header_of(frame));
+                    cache.stats.cached_bytes -= class_bytes(size_class);
+                    ++cache.stats.n_trimmed;
+                }
+            }
+        }
+
+        // The inboxes of exited threads, and the lock that guards them;
+        // only taken when a thread first allocates a frame, or exits.
+        static auto orphans_lock() -> std::mutex&
+        {
+            static std::mutex lock{};
+            return lock;
+        }
+
+        static auto orphans() -> inbox*&
+        {
+            static inbox* head = nullptr;
+            return head;
+        }
+
+        static auto adopt_inbox() -> inbox*
+        {
+            std::lock_guard guard{orphans_lock()};
+
+            auto*& head = orphans();
+            if (nullptr == head)
+            {
+                return new inbox{};
+            }
+
+            auto* adopted = head;
+            head = adopted->next_orphan;
+            adopted->next_orphan = nullptr;
+            return adopted;
+        }
+
+        static void orphan_inbox(inbox* mail)
+        {
+            std::lock_guard guard{orphans_lock()};
+
+            auto*& head = orphans();
+            mail->next_orphan = head;
+            head = mail;
+        }
+    };
+}
+
+#endif // CORO_RECYCLING_ALLOCATOR_HPP
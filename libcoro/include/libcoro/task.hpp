@@ -4,7 +4,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 // task.hpp
-// A eagerly-computed asynchronous computation.
+// A lazily-computed asynchronous computation.
 //
 // Adapted / simplified from the implementation in CppCoro:
 // https://github.com/lewissbaker/cppcoro
@@ -44,7 +44,7 @@ namespace coro
             }
 
             template <typename Promise>
-            void await_suspend(stdcoro::coroutine_handle<Promise> coro_handle)
+            void await_suspend(stdcoro::coroutine_handle<Promise> coro_handle) noexcept
             {
                 // Acquire a reference to the promise for the awaiting coroutine.
                 task_promise_base& promise = coro_handle.promise();
@@ -69,7 +69,11 @@ namespace coro
 
         auto initial_suspend() noexcept
         {
-            return stdcoro::suspend_never{};
+            // The computation does not begin until the task is awaited
+            // (or resumed explicitly); were it to begin eagerly, a task
+            // that suspended before it was awaited would be resumed a
+            // second time by the awaiter (see awaitable_base below).
+            return stdcoro::suspend_always{};
         }
 
         auto final_suspend() noexcept